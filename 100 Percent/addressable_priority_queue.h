@@ -0,0 +1,313 @@
+/***********************************************************************
+ * Header:
+ *    ADDRESSABLE PRIORITY QUEUE
+ * Summary:
+ *    A priority queue that hands back a handle for every item pushed
+ *    so the item can later be re-prioritized or removed in O(log n)
+ *
+ *    This will contain the class definition of:
+ *        addressable_priority_queue : A Priority Queue with handles
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <functional>   // for std::less
+#include "priority_queue.h"
+#include "vector.h"
+
+class TestAddressablePQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * ADDRESSABLE P QUEUE
+ * A heap in a custom::vector, just like priority_queue,
+ * with two more vectors beside it: the slot of the
+ * item at each heap position, and the heap position
+ * of each slot. The sifting is priority_queue's own
+ * heap_sift; the moveTo and place it calls keep the
+ * two in step. Compare says which of two items is the
+ * lesser; the biggest is on top.
+ *
+ * A slot is given out again once its item is gone, so
+ * a handle is the slot and the generation it was given
+ * out in. Freeing a slot bumps its generation, and a
+ * handle kept past its item's pop or erase is refused
+ * rather than finding whatever took the slot next.
+ *************************************************/
+template<class T, class Compare = std::less<T>, size_t Arity = 2>
+class addressable_priority_queue
+{
+   static_assert(Arity >= 2, "a heap node needs at least two children");
+
+   friend class ::TestAddressablePQueue; // give the unit test class access to the privates
+   friend struct heap_sift<Arity, layout_flat>;
+public:
+   struct handle
+   {
+      size_t slot;
+      size_t generation;
+      bool operator == (const handle & rhs) const
+      {
+         return slot == rhs.slot && generation == rhs.generation;
+      }
+      bool operator != (const handle & rhs) const
+      {
+         return !(*this == rhs);
+      }
+   };
+
+   //
+   // construct
+   //
+   explicit addressable_priority_queue(const Compare & c = Compare()) : compare(c)
+   {
+   }
+
+   //
+   // Access
+   //
+   const T & top() const;
+   handle    topHandle() const;
+   const T & get(handle h) const;
+   bool      contains(handle h) const
+   {
+      return h.slot < positions.size() && positions[h.slot] != npos &&
+             generations[h.slot] == h.generation;
+   }
+
+   //
+   // Insert
+   //
+   handle push(const T & t);
+   handle push(T && t);
+   void   update(handle h, const T & t);
+   void   update(handle h, T && t);
+
+   //
+   // Remove
+   //
+   void  pop();
+   void  erase(handle h);
+
+   //
+   // Status
+   //
+   size_t size()  const
+   {
+      return container.size();
+   }
+   bool empty() const
+   {
+      return container.size() == 0;
+   }
+
+private:
+
+   static const size_t npos = (size_t)-1;   // position of a slot not in the heap
+
+   size_t newSlot();
+   void   removeAt(size_t index);           // take the item at index out of the heap
+   void   resettle(size_t index, T && value, size_t slot);
+
+   // the value sifting through the heap, and the slot that goes with it
+   struct Hole
+   {
+      T &    value;
+      size_t slot;
+   };
+
+   // move a hole through the heap, then drop value into it. Container indices
+   typedef heap_sift<Arity, layout_flat> sift;
+   void siftDown(size_t indexHole, T && value, size_t slot) { sift::down(*this, indexHole, Hole{ value, slot }); }
+   void siftUp  (size_t indexHole, T && value, size_t slot) { sift::up  (*this, indexHole, Hole{ value, slot }); }
+
+   // what heap_sift needs to compare and move the nodes
+   bool lessNodes(size_t i, size_t j) const              { return compare(container[i], container[j]); }
+   bool lessValueNode(const Hole & hole, size_t i) const { return compare(hole.value, container[i]); }
+   bool lessNodeValue(size_t i, const Hole & hole) const { return compare(container[i], hole.value); }
+
+   // fill a heap position and record where its slot now lives
+   void moveTo(size_t indexTo, size_t indexFrom)
+   {
+      container[indexTo] = std::move(container[indexFrom]);
+      slots[indexTo] = slots[indexFrom];
+      positions[slots[indexTo]] = indexTo;
+   }
+   void place(size_t index, Hole && hole)
+   {
+      container[index] = std::move(hole.value);
+      slots[index] = hole.slot;
+      positions[hole.slot] = index;
+   }
+
+   custom::vector<T>      container;   // the heap itself
+   custom::vector<size_t> slots;       // slot of the item at each heap position
+   custom::vector<size_t> positions;   // heap position of each slot, or npos
+   custom::vector<size_t> generations; // how many times each slot has been freed
+   custom::vector<size_t> slotsFree;   // slots ready to be given out again
+   Compare                compare;     // which of two items is the lesser
+};
+
+template <class T, class Compare, size_t Arity>
+const size_t addressable_priority_queue <T, Compare, Arity> :: npos;
+
+/************************************************
+ * ADDRESSABLE P QUEUE :: TOP
+ * Get the maximum item from the heap: the top item.
+ ***********************************************/
+template <class T, class Compare, size_t Arity>
+const T & addressable_priority_queue <T, Compare, Arity> :: top() const
+{
+   if (container.empty())
+      throw "std:out_of_range";
+   return container.front();
+}
+
+template <class T, class Compare, size_t Arity>
+typename addressable_priority_queue <T, Compare, Arity> :: handle
+addressable_priority_queue <T, Compare, Arity> :: topHandle() const
+{
+   if (container.empty())
+      throw "std:out_of_range";
+   return handle{ slots.front(), generations[slots.front()] };
+}
+
+/************************************************
+ * ADDRESSABLE P QUEUE :: GET
+ * Look up an item by its handle
+ ***********************************************/
+template <class T, class Compare, size_t Arity>
+const T & addressable_priority_queue <T, Compare, Arity> :: get(handle h) const
+{
+   if (!contains(h))
+      throw "std:out_of_range";
+   return container[positions[h.slot]];
+}
+
+/*****************************************
+ * ADDRESSABLE P QUEUE :: PUSH
+ * Add a new element to the heap and return the
+ * handle that finds it again
+ ****************************************/
+template <class T, class Compare, size_t Arity>
+typename addressable_priority_queue <T, Compare, Arity> :: handle
+addressable_priority_queue <T, Compare, Arity> :: push(const T & t)
+{
+   return push(T(t));
+}
+template <class T, class Compare, size_t Arity>
+typename addressable_priority_queue <T, Compare, Arity> :: handle
+addressable_priority_queue <T, Compare, Arity> :: push(T && t)
+{
+   size_t slot = newSlot();
+   container.push_back(std::move(t));
+   slots.push_back(slot);
+
+   T value(std::move(container.back()));
+   siftUp(container.size() - 1, std::move(value), slot);
+   return handle{ slot, generations[slot] };
+}
+
+/*****************************************
+ * ADDRESSABLE P QUEUE :: UPDATE
+ * Give an item a new value. A bigger value floats
+ * up the heap, a smaller one sinks.
+ ****************************************/
+template <class T, class Compare, size_t Arity>
+void addressable_priority_queue <T, Compare, Arity> :: update(handle h, const T & t)
+{
+   update(h, T(t));
+}
+template <class T, class Compare, size_t Arity>
+void addressable_priority_queue <T, Compare, Arity> :: update(handle h, T && t)
+{
+   if (!contains(h))
+      throw "std:out_of_range";
+   resettle(positions[h.slot], std::move(t), h.slot);
+}
+
+/**********************************************
+ * ADDRESSABLE P QUEUE :: POP
+ * Delete the top item from the heap. Its handle
+ * is no longer valid.
+ **********************************************/
+template <class T, class Compare, size_t Arity>
+void addressable_priority_queue <T, Compare, Arity> :: pop()
+{
+   if (container.empty())
+      return;
+   removeAt(0);
+}
+
+/**********************************************
+ * ADDRESSABLE P QUEUE :: ERASE
+ * Delete an item from anywhere in the heap
+ **********************************************/
+template <class T, class Compare, size_t Arity>
+void addressable_priority_queue <T, Compare, Arity> :: erase(handle h)
+{
+   if (!contains(h))
+      throw "std:out_of_range";
+   removeAt(positions[h.slot]);
+}
+
+/**********************************************
+ * ADDRESSABLE P QUEUE :: NEW SLOT
+ * Recycle a freed slot, or make a new one
+ **********************************************/
+template <class T, class Compare, size_t Arity>
+size_t addressable_priority_queue <T, Compare, Arity> :: newSlot()
+{
+   if (!slotsFree.empty())
+   {
+      size_t slot = slotsFree.back();
+      slotsFree.pop_back();
+      return slot;
+   }
+   positions.push_back(npos);
+   generations.push_back(0);
+   return positions.size() - 1;
+}
+
+/**********************************************
+ * ADDRESSABLE P QUEUE :: REMOVE AT
+ * The last item fills the hole left at index, and
+ * may need to go either up or down from there
+ **********************************************/
+template <class T, class Compare, size_t Arity>
+void addressable_priority_queue <T, Compare, Arity> :: removeAt(size_t index)
+{
+   size_t slotGone = slots[index];
+   positions[slotGone] = npos;
+   generations[slotGone]++;
+   slotsFree.push_back(slotGone);
+
+   T value(std::move(container.back()));
+   size_t slot = slots.back();
+   container.pop_back();
+   slots.pop_back();
+
+   if (index < container.size())
+      resettle(index, std::move(value), slot);
+}
+
+/**********************************************
+ * ADDRESSABLE P QUEUE :: RESETTLE
+ * Drop value into the hole at index, sifting it
+ * whichever way the heap order needs
+ **********************************************/
+template <class T, class Compare, size_t Arity>
+void addressable_priority_queue <T, Compare, Arity> :: resettle(size_t index, T && value, size_t slot)
+{
+   if (index != 0 && compare(container[sift::parent(index)], value))
+      siftUp(index, std::move(value), slot);
+   else
+      siftDown(index, std::move(value), slot);
+}
+
+}; // namespace custom
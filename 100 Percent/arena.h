@@ -0,0 +1,196 @@
+/***********************************************************************
+ * Header:
+ *    ARENA
+ * Summary:
+ *    A monotonic arena and an allocator that draws from it. Memory is
+ *    handed out by bumping a pointer and is never given back one piece
+ *    at a time: the whole arena is released in one go, which suits
+ *    containers that live and die with a single request.
+ *
+ *    This will contain the class definition of:
+ *        arena                  : A monotonic pool of memory blocks
+ *        arena_allocator        : An allocator that takes from an arena
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uintptr_t
+#include <new>          // for std::bad_alloc, ::operator new
+
+class TestArena;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * ARENA
+ * Memory comes from the current block, aligned and
+ * bumped. When a request does not fit, a new block
+ * is taken from operator new, each one twice the size
+ * of the last so a busy arena soon stops asking.
+ * deallocate does nothing: what a vector frees as it
+ * grows stays in the arena until release().
+ *
+ * The first block can be supplied by the caller, a
+ * buffer on the stack say, and then a request that
+ * fits in it never touches the heap at all. release()
+ * frees every block taken from the heap and starts
+ * over from the first one.
+ *
+ * An arena is not thread safe; give each request or
+ * each thread its own.
+ *************************************************/
+class arena
+{
+   friend class ::TestArena; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   explicit arena(size_t sizeFirst = 4096) :
+      pInitial(nullptr), sizeInitial(0), pBlocks(nullptr),
+      pNext(nullptr), pEnd(nullptr), sizeNext(sizeFirst ? sizeFirst : 1),
+      numBlocks(0) {}
+   arena(void * buffer, size_t size) :
+      pInitial((char *)buffer), sizeInitial(size), pBlocks(nullptr),
+      pNext((char *)buffer), pEnd((char *)buffer + size), sizeNext(size ? size * 2 : 4096),
+      numBlocks(0) {}
+   arena(const arena &) = delete;
+   arena & operator = (const arena &) = delete;
+   ~arena()
+   {
+      release();
+   }
+
+   //
+   // Allocate
+   //
+   void * allocate(size_t size, size_t alignment);
+   void   deallocate(void *, size_t) {}     // nothing until release()
+
+   //
+   // Free everything at once
+   //
+   void release();
+
+   //
+   // Status
+   //
+   size_t blocks() const { return numBlocks; }   // taken from the heap
+
+private:
+
+   // a block from the heap: this header, then the memory
+   struct Block
+   {
+      Block * pNext;
+   };
+
+   char * pInitial;        // the caller's buffer, if any
+   size_t sizeInitial;
+   Block * pBlocks;        // the heap blocks, newest first
+   char * pNext;           // the next free byte in the current block
+   char * pEnd;            // one past the current block
+   size_t sizeNext;        // how big the next heap block will be
+   size_t numBlocks;
+};
+
+/************************************************
+ * ARENA :: ALLOCATE
+ * Round up to the alignment and take the bytes
+ * from the current block, starting a new one if
+ * they do not fit
+ ***********************************************/
+inline void * arena :: allocate(size_t size, size_t alignment)
+{
+   assert(alignment && (alignment & (alignment - 1)) == 0);
+   uintptr_t p = ((uintptr_t)pNext + alignment - 1) & ~(uintptr_t)(alignment - 1);
+   if (pNext != nullptr && p <= (uintptr_t)pEnd && size <= (size_t)((uintptr_t)pEnd - p))
+   {
+      pNext = (char *)p + size;
+      return (void *)p;
+   }
+
+   // a fresh block, big enough for this whatever the alignment
+   size_t sizeNeed = sizeof(Block) + size + alignment;
+   if (sizeNeed < size)
+      throw std::bad_alloc();
+   while (sizeNext < sizeNeed)
+      sizeNext *= 2;
+   Block * pBlock = (Block *)::operator new(sizeNext);
+   pBlock->pNext = pBlocks;
+   pBlocks = pBlock;
+   numBlocks++;
+
+   pNext = (char *)(pBlock + 1);
+   pEnd  = (char *)pBlock + sizeNext;
+   sizeNext *= 2;
+
+   p = ((uintptr_t)pNext + alignment - 1) & ~(uintptr_t)(alignment - 1);
+   pNext = (char *)p + size;
+   return (void *)p;
+}
+
+/************************************************
+ * ARENA :: RELEASE
+ * Free the heap blocks and start again from the
+ * caller's buffer, if there is one
+ ***********************************************/
+inline void arena :: release()
+{
+   while (pBlocks)
+   {
+      Block * pBlock = pBlocks;
+      pBlocks = pBlock->pNext;
+      ::operator delete((void *)pBlock);
+   }
+   numBlocks = 0;
+   pNext = pInitial;
+   pEnd  = pInitial ? pInitial + sizeInitial : nullptr;
+}
+
+/*************************************************
+ * ARENA ALLOCATOR
+ * The allocator interface std::allocator_traits
+ * needs, over an arena. Copies share the arena, and
+ * two allocators are equal when they share one, so
+ * what one allocates the other can free.
+ *************************************************/
+template <class T>
+class arena_allocator
+{
+   template <class U>
+   friend class arena_allocator;
+public:
+   typedef T value_type;
+
+   arena_allocator(arena & a) : pArena(&a) {}
+   template <class U>
+   arena_allocator(const arena_allocator<U> & rhs) : pArena(rhs.pArena) {}
+
+   T * allocate(size_t n)
+   {
+      if (n > (size_t)-1 / sizeof(T))
+         throw std::bad_alloc();
+      return (T *)pArena->allocate(n * sizeof(T), alignof(T));
+   }
+   void deallocate(T * p, size_t n)
+   {
+      pArena->deallocate((void *)p, n * sizeof(T));
+   }
+
+   template <class U>
+   bool operator == (const arena_allocator<U> & rhs) const { return pArena == rhs.pArena; }
+   template <class U>
+   bool operator != (const arena_allocator<U> & rhs) const { return pArena != rhs.pArena; }
+
+private:
+   arena * pArena;
+};
+
+}; // namespace custom
@@ -0,0 +1,1132 @@
+/***********************************************************************
+ * Source:
+ *    Bench
+ * Summary:
+ *    Driver to time the priority queues and their knobs. It has a main
+ *    of its own, so build it apart from the unit tests, optimized:
+ *       g++ -std=c++14 -O2 -DNDEBUG -pthread benchPriorityQueue.cpp -o bench
+ *    Then name the groups to run, or none for all of them, and the
+ *    sizes if the defaults are not what you want:
+ *       bench arity 1000000 10000000
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#include <algorithm>  // for std::nth_element, std::shuffle
+#include <atomic>     // for std::atomic
+#include <chrono>     // for steady_clock
+#include <condition_variable>
+#include <cstdio>     // for printf
+#include <cstdlib>    // for strtoull
+#include <cstring>    // for strcmp
+#include <functional> // for std::less, std::function
+#include <future>     // for std::future, std::packaged_task
+#include <memory>     // for std::shared_ptr
+#include <mutex>      // for std::mutex
+#include <new>        // for std::bad_alloc
+#include <random>     // for mt19937_64
+#include <string>
+#include <thread>     // for std::thread
+
+#ifndef _WIN32
+#include <sys/resource.h> // for getrusage
+#endif
+
+#include "arena.h"
+#include "blocking_priority_queue.h"
+#include "flat_combining_priority_queue.h"
+#include "huge_page_allocator.h"
+#include "keyed_priority_queue.h"
+#include "multi_queue.h"
+#include "priority_executor.h"
+#include "priority_queue.h"
+#include "skiplist_priority_queue.h"
+#include "small_vector.h"
+#include "spy.h"
+#include "vector.h"
+
+int Spy::counters[] = {};
+
+/**********************************************************************
+ * OPERATOR NEW
+ * Every allocation in the program comes through here
+ * and is counted, so a group can say how many times
+ * a container went to the heap. Spy only counts its
+ * own buffers; this sees the containers' too.
+ * GCC takes the free below for a mismatch once it
+ * is inlined into a new expression, so hush it
+ ***********************************************************************/
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+std::atomic<size_t> numNew(0);
+
+void * operator new(size_t size)
+{
+   numNew.fetch_add(1, std::memory_order_relaxed);
+   if (void * p = malloc(size ? size : 1))
+      return p;
+   throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept
+{
+   free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+   free(p);
+}
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+/**********************************************************************
+ * SECONDS FOR
+ * How long it takes to run f once
+ ***********************************************************************/
+template <class F>
+double secondsFor(F f)
+{
+   std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+   f();
+   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+   return std::chrono::duration<double>(end - begin).count();
+}
+
+/**********************************************************************
+ * ROW
+ * One line of results: what was run, on how many
+ * items, and up to three measures with their units
+ ***********************************************************************/
+struct Measure
+{
+   const char * unit;
+   double value;
+};
+
+void row(const std::string & name, size_t n, Measure a, Measure b = { nullptr, 0 },
+         Measure c = { nullptr, 0 })
+{
+   printf("   %-36s %11zu", name.c_str(), n);
+   for (const Measure & m : { a, b, c })
+      if (m.unit)
+         printf(" %12.1f %s", m.value, m.unit);
+   printf("\n");
+   fflush(stdout);
+}
+
+/**********************************************************************
+ * RANDOM ITEMS
+ * n items from a fixed seed, so every run of a
+ * group sorts the same numbers
+ ***********************************************************************/
+template <class T>
+custom::vector<T> randomItems(size_t n)
+{
+   std::mt19937_64 random(20241016);
+   custom::vector<T> items;
+   items.reserve(n);
+   for (size_t i = 0; i < n; i++)
+      items.push_back(T((int)(random() >> 33)));
+   return items;
+}
+
+/**********************************************************************
+ * LOCKED QUEUE
+ * What the concurrent queues are measured against:
+ * a priority_queue behind one mutex
+ ***********************************************************************/
+template <class T>
+class LockedQueue
+{
+public:
+   void push(const T & t)
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      heap.push(t);
+   }
+   bool try_pop(T & t)
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      return heap.try_pop(t);
+   }
+private:
+   std::mutex lock;
+   custom::priority_queue<T> heap;
+};
+
+/**********************************************************************
+ * PUSH POP
+ * Push every item, then pop them all, timing each
+ * half. The time of an operation is in nanoseconds.
+ * A small heap goes round again until there are a
+ * million of each, so the clock has something to see
+ ***********************************************************************/
+template <class PQueue, class T>
+void pushPop(const std::string & name, const custom::vector<T> & items)
+{
+   size_t numRounds = items.size() < 1000000 ? 1000000 / items.size() : 1;
+   double secondsPush = 0.0;
+   double secondsPop = 0.0;
+   for (size_t round = 0; round < numRounds; round++)
+   {
+      PQueue pq;
+      secondsPush += secondsFor([&]()
+      {
+         for (size_t i = 0; i < items.size(); i++)
+            pq.push(items[i]);
+      });
+      secondsPop += secondsFor([&]()
+      {
+         while (!pq.empty())
+            pq.pop();
+      });
+   }
+   row(name, items.size(),
+       { "ns/push", secondsPush * 1e9 / (items.size() * numRounds) },
+       { "ns/pop",  secondsPop  * 1e9 / (items.size() * numRounds) });
+}
+
+/**********************************************************************
+ * ARITY
+ * A wider heap is shallower, and its siblings
+ * share cache lines, but every level compares more
+ * children. Which wins depends on the item
+ ***********************************************************************/
+template <class T>
+void arityFor(const char * nameType, size_t n)
+{
+   custom::vector<T> items = randomItems<T>(n);
+   std::string name(nameType);
+   pushPop<custom::priority_queue<T, custom::vector<T>, std::less<T>, 2 > >(name + " arity 2",  items);
+   pushPop<custom::priority_queue<T, custom::vector<T>, std::less<T>, 4 > >(name + " arity 4",  items);
+   pushPop<custom::priority_queue<T, custom::vector<T>, std::less<T>, 8 > >(name + " arity 8",  items);
+   pushPop<custom::priority_queue<T, custom::vector<T>, std::less<T>, 16> >(name + " arity 16", items);
+}
+
+void benchArity(const custom::vector<size_t> & sizes)
+{
+   for (size_t i = 0; i < sizes.size(); i++)
+   {
+      arityFor<int>("int", sizes[i]);
+      arityFor<double>("double", sizes[i]);
+      // a Spy owns its value on the heap: costly to move, so a tenth as many
+      arityFor<Spy>("Spy", sizes[i] / 10);
+   }
+}
+
+/**********************************************************************
+ * LAYOUT
+ * Flat against blocked heaps, from a heap that fits
+ * in the first cache to one far out of the last.
+ * Blocks are sized to a 64 byte line of int, and to
+ * a 4K page of them
+ ***********************************************************************/
+void benchLayout(const custom::vector<size_t> & sizes)
+{
+   typedef custom::vector<int> Container;
+   typedef std::less<int> Less;
+   for (size_t i = 0; i < sizes.size(); i++)
+   {
+      custom::vector<int> items = randomItems<int>(sizes[i]);
+      pushPop<custom::priority_queue<int, Container, Less, 2, custom::pop_classic, custom::layout_flat> >
+         ("arity 2 flat", items);
+      pushPop<custom::priority_queue<int, Container, Less, 2, custom::pop_classic, custom::layout_blocked<4> > >
+         ("arity 2 blocked 15 (line)", items);
+      pushPop<custom::priority_queue<int, Container, Less, 2, custom::pop_classic, custom::layout_blocked<10> > >
+         ("arity 2 blocked 1023 (page)", items);
+      pushPop<custom::priority_queue<int, Container, Less, 4, custom::pop_classic, custom::layout_flat> >
+         ("arity 4 flat", items);
+      pushPop<custom::priority_queue<int, Container, Less, 4, custom::pop_classic, custom::layout_blocked<2> > >
+         ("arity 4 blocked 5 (line)", items);
+      pushPop<custom::priority_queue<int, Container, Less, 4, custom::pop_classic, custom::layout_blocked<5> > >
+         ("arity 4 blocked 341 (page)", items);
+   }
+}
+
+/**********************************************************************
+ * HEAPIFY
+ * Loading a whole backlog: building the heap in one
+ * go against pushing each item. Then a batch into a
+ * heap that is already full, where push of a range
+ * picks one or the other by the size of the batch;
+ * each size of batch is timed both ways. A random
+ * item seldom climbs far, but a rising one climbs
+ * all the way, and that is what the choice guards
+ * against
+ ***********************************************************************/
+void benchHeapify(const custom::vector<size_t> & sizes)
+{
+   typedef custom::priority_queue<int> PQueue;
+   for (size_t i = 0; i < sizes.size(); i++)
+   {
+      size_t n = sizes[i];
+      custom::vector<int> items = randomItems<int>(n);
+      const int * first = &items[0];
+
+      double secondsHeapify = secondsFor([&]()
+      {
+         PQueue pq(first, first + n);
+      });
+      double secondsPush = secondsFor([&]()
+      {
+         PQueue pq;
+         pq.reserve(n);
+         for (size_t j = 0; j < n; j++)
+            pq.push(items[j]);
+      });
+      row("load by heapify", n, { "ms", secondsHeapify * 1e3 }, { "ns/item", secondsHeapify * 1e9 / n });
+      row("load by push",    n, { "ms", secondsPush    * 1e3 }, { "ns/item", secondsPush    * 1e9 / n });
+
+      custom::vector<int> rising;
+      rising.reserve(n);
+      for (size_t j = 0; j < n; j++)
+         rising.push_back((int)(0x7fffffff - n + j));
+
+      PQueue full(first, first + n);
+      for (size_t divisor : { 256, 64, 16, 4, 1 })
+         for (const custom::vector<int> * pBatch : { &items, &rising })
+         {
+            const custom::vector<int> & batch = *pBatch;
+            size_t numBatch = n / divisor;
+            PQueue pqRange(full);
+            PQueue pqEach(full);
+            pqRange.reserve(n + numBatch);
+            pqEach.reserve(n + numBatch);
+            double secondsRange = secondsFor([&]()
+            {
+               pqRange.push(&batch[0], &batch[0] + numBatch);
+            });
+            double secondsEach = secondsFor([&]()
+            {
+               for (size_t j = 0; j < numBatch; j++)
+                  pqEach.push(batch[j]);
+            });
+            row(std::string(pBatch == &items ? "random" : "rising") + " batch of n/" +
+                std::to_string(divisor), n,
+                { "ns/range", secondsRange * 1e9 / numBatch },
+                { "ns/each",  secondsEach  * 1e9 / numBatch });
+         }
+   }
+}
+
+/**********************************************************************
+ * MULTI QUEUE
+ * The two knobs, queues per thread and choices per
+ * pop, against what they cost and what they buy.
+ * Throughput: every thread pops an item and pushes
+ * it back, on a queue that starts with n items.
+ * Rank error: one thread pops all of n distinct
+ * items, and the rank of each pop is how many bigger
+ * ones were still in the queue. A Fenwick tree over
+ * the items counts them
+ ***********************************************************************/
+void benchMultiQueue(const custom::vector<size_t> & sizes)
+{
+   size_t numThreads = std::thread::hardware_concurrency();
+   if (numThreads == 0)
+      numThreads = 1;
+   printf("   %zu threads\n", numThreads);
+
+   for (size_t i = 0; i < sizes.size(); i++)
+   {
+      size_t n = sizes[i];
+      custom::vector<int> items;
+      items.reserve(n);
+      for (size_t j = 0; j < n; j++)
+         items.push_back((int)j);
+      std::shuffle(&items[0], &items[0] + n, std::mt19937_64(20241016));
+
+      for (size_t queuesPerThread : { 1, 2, 4, 8 })
+         for (size_t numChoices : { 1, 2, 4 })
+         {
+            // throughput
+            custom::multi_queue<int> mq(numThreads, queuesPerThread, numChoices);
+            for (size_t j = 0; j < n; j++)
+               mq.push(items[j]);
+            size_t numRounds = 1000000 / numThreads;
+            double seconds = secondsFor([&]()
+            {
+               custom::vector<std::thread> threads;
+               for (size_t t = 0; t < numThreads; t++)
+                  threads.push_back(std::thread([&]()
+                  {
+                     int item;
+                     for (size_t round = 0; round < numRounds; round++)
+                        if (mq.try_pop(item))
+                           mq.push(item);
+                  }));
+               for (size_t t = 0; t < numThreads; t++)
+                  threads[t].join();
+            });
+
+            // rank error
+            custom::multi_queue<int> mqRank(numThreads, queuesPerThread, numChoices);
+            custom::vector<size_t> counts(n + 1);
+            for (size_t j = 0; j < n; j++)
+            {
+               mqRank.push(items[j]);
+               for (size_t k = items[j] + 1; k <= n; k += k & (0 - k))
+                  counts[k]++;
+            }
+            custom::vector<size_t> ranks;
+            ranks.reserve(n);
+            size_t numLeft = n;
+            double rankTotal = 0.0;
+            int item;
+            while (mqRank.try_pop(item))
+            {
+               // the ones no bigger than this one, then all the rest are bigger
+               size_t numNotBigger = 0;
+               for (size_t k = item + 1; k > 0; k -= k & (0 - k))
+                  numNotBigger += counts[k];
+               ranks.push_back(numLeft - numNotBigger);
+               rankTotal += numLeft - numNotBigger;
+               for (size_t k = item + 1; k <= n; k += k & (0 - k))
+                  counts[k]--;
+               numLeft--;
+            }
+            size_t * p99 = &ranks[0] + ranks.size() * 99 / 100;
+            std::nth_element(&ranks[0], p99, &ranks[0] + ranks.size());
+
+            row("c " + std::to_string(queuesPerThread) + " choices " + std::to_string(numChoices), n,
+                { "Mops/s", 2.0 * numRounds * numThreads / seconds / 1e6 },
+                { "mean rank", rankTotal / n },
+                { "p99 rank", (double)*p99 });
+         }
+   }
+}
+
+/**********************************************************************
+ * HUGE PAGES
+ * The same heap in ordinary pages and in huge ones.
+ * Each is reserved full size, filled with n items,
+ * then popped a million times: the pops near the top
+ * of a big heap walk its whole height, and below a
+ * few million items every level is another page
+ ***********************************************************************/
+template <class PQueue>
+void popLatency(const std::string & name, const custom::vector<int> & items, PQueue & pq)
+{
+   size_t numPops = items.size() < 1000000 ? items.size() : 1000000;
+   pq.reserve(items.size());
+   double secondsPush = secondsFor([&]()
+   {
+      for (size_t i = 0; i < items.size(); i++)
+         pq.push(items[i]);
+   });
+   double secondsPop = secondsFor([&]()
+   {
+      for (size_t i = 0; i < numPops; i++)
+         pq.pop();
+   });
+   row(name, items.size(),
+       { "ns/push", secondsPush * 1e9 / items.size() },
+       { "ns/pop",  secondsPop  * 1e9 / numPops });
+}
+
+void benchHugePages(const custom::vector<size_t> & sizes)
+{
+   typedef custom::vector<int, custom::huge_page_allocator<int> > Huge;
+   for (size_t i = 0; i < sizes.size(); i++)
+   {
+      custom::vector<int> items = randomItems<int>(sizes[i]);
+      {
+         custom::priority_queue<int> pq;
+         popLatency("ordinary pages", items, pq);
+      }
+      {
+         custom::priority_queue<int, Huge> pq;
+         popLatency("huge pages, transparent", items, pq);
+      }
+      {
+         custom::huge_page_allocator<int> alloc(custom::huge_pages::sizeHuge, true /*isExplicit*/);
+         custom::priority_queue<int, Huge> pq(alloc);
+         popLatency("huge pages, reserved pool", items, pq);
+      }
+   }
+}
+
+/**********************************************************************
+ * KEYED
+ * A job record of Bytes bytes whose first 8 are its
+ * priority. priority_queue moves whole records at
+ * every level; keyed_priority_queue moves a key and
+ * a slot number, and each record just in and out.
+ * Both hand each record back with try_pop
+ ***********************************************************************/
+template <size_t Bytes>
+struct Record
+{
+   Record(unsigned long long key = 0) : key(key) { rest[0] = (char)key; }
+   bool operator < (const Record & rhs) const { return key < rhs.key; }
+   unsigned long long key;
+   char rest[Bytes - sizeof(unsigned long long)];
+};
+
+template <size_t Bytes>
+void keyedFor(size_t n)
+{
+   custom::vector<int> keys = randomItems<int>(n);
+   std::string name = std::to_string(Bytes) + " byte ";
+   unsigned long long checksum = 0;
+
+   custom::priority_queue<Record<Bytes> > pq;
+   pq.reserve(n);
+   double secondsPush = secondsFor([&]()
+   {
+      for (size_t i = 0; i < n; i++)
+         pq.push(Record<Bytes>(keys[i]));
+   });
+   double secondsPop = secondsFor([&]()
+   {
+      Record<Bytes> record;
+      while (pq.try_pop(record))
+         checksum += record.rest[0];
+   });
+   row(name + "records, whole", n,
+       { "ns/push", secondsPush * 1e9 / n }, { "ns/pop", secondsPop * 1e9 / n });
+
+   custom::keyed_priority_queue<unsigned long long, Record<Bytes> > kpq;
+   kpq.reserve(n);
+   secondsPush = secondsFor([&]()
+   {
+      for (size_t i = 0; i < n; i++)
+         kpq.push(keys[i], Record<Bytes>(keys[i]));
+   });
+   secondsPop = secondsFor([&]()
+   {
+      unsigned long long key;
+      Record<Bytes> record;
+      while (kpq.try_pop(key, record))
+         checksum -= record.rest[0];
+   });
+   row(name + "records, keyed", n,
+       { "ns/push", secondsPush * 1e9 / n }, { "ns/pop", secondsPop * 1e9 / n });
+
+   // both popped the same records, or neither timing means anything
+   if (checksum != 0)
+      printf("   the queues disagree\n");
+}
+
+void benchKeyed(const custom::vector<size_t> & sizes)
+{
+   for (size_t i = 0; i < sizes.size(); i++)
+   {
+      keyedFor<16>(sizes[i]);
+      keyedFor<64>(sizes[i]);
+      keyedFor<256>(sizes[i]);
+   }
+}
+
+/**********************************************************************
+ * SKIPLIST
+ * Tail latency with more threads than cores. Each
+ * thread pushes and pops in turn, timing every call,
+ * on a queue that starts with ten thousand items. A
+ * thread switched out while it holds the mutex stalls
+ * everyone behind it; the skiplist has no such holder
+ ***********************************************************************/
+template <class Queue>
+void latencies(const std::string & name, size_t numThreads, size_t numOps)
+{
+   Queue q;
+   for (int i = 0; i < 10000; i++)
+      q.push(i);
+
+   custom::vector<custom::vector<double> > timesThread(numThreads);
+   size_t numOpsThread = numOps / numThreads;
+   custom::vector<std::thread> threads;
+   for (size_t t = 0; t < numThreads; t++)
+      threads.push_back(std::thread([&q, &timesThread, t, numOpsThread]()
+      {
+         custom::vector<double> & times = timesThread[t];
+         times.reserve(numOpsThread);
+         std::mt19937_64 random(t);
+         int item;
+         for (size_t op = 0; op < numOpsThread; op++)
+            times.push_back(secondsFor([&]()
+            {
+               if (op % 2 == 0)
+                  q.push((int)(random() >> 33));
+               else
+                  q.try_pop(item);
+            }));
+      }));
+   for (size_t t = 0; t < numThreads; t++)
+      threads[t].join();
+
+   custom::vector<double> times;
+   for (size_t t = 0; t < numThreads; t++)
+      for (size_t op = 0; op < timesThread[t].size(); op++)
+         times.push_back(timesThread[t][op]);
+   double * first = &times[0];
+   double * last = first + times.size();
+   double * p50  = first + times.size() / 2;
+   double * p99  = first + times.size() * 99 / 100;
+   double * p999 = first + times.size() * 999 / 1000;
+   std::nth_element(first, p50, last);
+   std::nth_element(p50, p99, last);
+   std::nth_element(p99, p999, last);
+   row(name + ", " + std::to_string(numThreads) + " threads", times.size(),
+       { "ns p50", *p50 * 1e9 }, { "ns p99", *p99 * 1e9 }, { "ns p999", *p999 * 1e9 });
+}
+
+void benchSkiplist(const custom::vector<size_t> & sizes)
+{
+   size_t numCores = std::thread::hardware_concurrency();
+   if (numCores == 0)
+      numCores = 1;
+   for (size_t i = 0; i < sizes.size(); i++)
+      for (size_t perCore : { 1, 4, 16 })
+      {
+         latencies<LockedQueue<int> >("mutex", numCores * perCore, sizes[i]);
+         latencies<custom::skiplist_priority_queue<int> >("skiplist", numCores * perCore, sizes[i]);
+      }
+}
+
+/**********************************************************************
+ * COMBINING
+ * Throughput from 2 to 64 threads. Each thread
+ * pushes two small items for every one it pops, so
+ * the queue is mostly taking pushes, which is what
+ * combining batches best
+ ***********************************************************************/
+template <class Queue>
+void throughput(const std::string & name, size_t numThreads, size_t numOps)
+{
+   Queue q;
+   size_t numOpsThread = numOps / numThreads;
+   custom::vector<std::thread> threads;
+   double seconds = secondsFor([&]()
+   {
+      for (size_t t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&q, t, numOpsThread]()
+         {
+            std::mt19937_64 random(t);
+            int item;
+            for (size_t op = 0; op < numOpsThread; op++)
+               if (op % 3 == 2)
+                  q.try_pop(item);
+               else
+                  q.push((int)(random() >> 33));
+         }));
+      for (size_t t = 0; t < numThreads; t++)
+         threads[t].join();
+   });
+   row(name + ", " + std::to_string(numThreads) + " threads", numOpsThread * numThreads,
+       { "Mops/s", numOpsThread * numThreads / seconds / 1e6 });
+}
+
+void benchCombining(const custom::vector<size_t> & sizes)
+{
+   for (size_t i = 0; i < sizes.size(); i++)
+      for (size_t numThreads : { 2, 4, 8, 16, 32, 64 })
+      {
+         throughput<LockedQueue<int> >("mutex", numThreads, sizes[i]);
+         throughput<custom::flat_combining_priority_queue<int> >("combining", numThreads, sizes[i]);
+      }
+}
+
+/**********************************************************************
+ * PIPELINE
+ * Producers push into a bounded queue and consumers
+ * take batches out. The blocking queue against the
+ * wrapper it replaces, which wakes every sleeper on
+ * every push and pop. Context switches come from the
+ * operating system, for the whole process
+ ***********************************************************************/
+template <class T>
+class NotifyAllQueue
+{
+public:
+   explicit NotifyAllQueue(size_t capacity) : numCapacity(capacity) {}
+   void push(const T & t)
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      while (heap.size() >= numCapacity)
+         changed.wait(guard);
+      heap.push(t);
+      changed.notify_all();
+   }
+   size_t pop_batch(custom::vector<T> & items, size_t n, std::chrono::nanoseconds timeout)
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      if (heap.empty())
+         changed.wait_for(guard, timeout);
+      size_t numTaken = 0;
+      while (numTaken < n && heap.try_pop_into(items))
+         numTaken++;
+      changed.notify_all();
+      return numTaken;
+   }
+private:
+   std::mutex lock;
+   std::condition_variable changed;
+   custom::priority_queue<T> heap;
+   size_t numCapacity;
+};
+
+long contextSwitches()
+{
+#ifdef _WIN32
+   return 0;
+#else
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+   return usage.ru_nvcsw + usage.ru_nivcsw;
+#endif
+}
+
+template <class Queue>
+void pipeline(const std::string & name, size_t numItems, size_t numProducers, size_t numConsumers)
+{
+   Queue q(256);
+   std::atomic<long> numLeft((long)(numItems / numProducers * numProducers));
+   long numItemsAll = numLeft.load();
+   custom::vector<std::thread> threads;
+   long switchesBefore = contextSwitches();
+   double seconds = secondsFor([&]()
+   {
+      for (size_t p = 0; p < numProducers; p++)
+         threads.push_back(std::thread([&q, p, numItems, numProducers]()
+         {
+            std::mt19937_64 random(p);
+            for (size_t i = 0; i < numItems / numProducers; i++)
+               q.push((int)(random() >> 33));
+         }));
+      for (size_t c = 0; c < numConsumers; c++)
+         threads.push_back(std::thread([&q, &numLeft]()
+         {
+            custom::vector<int> items;
+            while (numLeft.load() > 0)
+            {
+               items.clear();
+               numLeft -= (long)q.pop_batch(items, 16, std::chrono::milliseconds(1));
+            }
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+   });
+   long switches = contextSwitches() - switchesBefore;
+   row(name + ", " + std::to_string(numProducers) + " to " + std::to_string(numConsumers), numItemsAll,
+       { "Mitems/s", numItemsAll / seconds / 1e6 },
+       { "switch/ki", switches * 1000.0 / numItemsAll });
+}
+
+void benchPipeline(const custom::vector<size_t> & sizes)
+{
+   for (size_t i = 0; i < sizes.size(); i++)
+      for (size_t numThreads : { 1, 4, 16 })
+      {
+         pipeline<NotifyAllQueue<int> >("notify all", sizes[i], numThreads, numThreads);
+         pipeline<custom::blocking_priority_queue<int> >("blocking", sizes[i], numThreads, numThreads);
+      }
+}
+
+/**********************************************************************
+ * EXECUTOR
+ * The work-stealing executor against a pool that
+ * shares one locked heap, wrapping tasks the same
+ * way, in packaged_tasks with futures.
+ * Fork-join: a binary tree of tiny tasks, each of
+ * which submits its two children.
+ * Priority: the workers are kept busy with long,
+ * unimportant tasks while urgent ones trickle in;
+ * what counts is how long an urgent one waits
+ ***********************************************************************/
+class SharedExecutor
+{
+public:
+   explicit SharedExecutor(size_t numWorkers) :
+      sequenceNext(0), numUnfinished(0), isStopping(false)
+   {
+      for (size_t i = 0; i < numWorkers; i++)
+         threads.push_back(std::thread([this]() { work(); }));
+   }
+   ~SharedExecutor()
+   {
+      shutdown();
+   }
+   template <class Function>
+   auto submit(int priority, Function && f) -> std::future<decltype(f())>
+   {
+      typedef decltype(f()) R;
+      std::shared_ptr<std::packaged_task<R()>> task =
+         std::make_shared<std::packaged_task<R()>>(std::forward<Function>(f));
+      std::future<R> future = task->get_future();
+      std::lock_guard<std::mutex> guard(lock);
+      heap.push(Task { priority, sequenceNext++, [task]() { (*task)(); } });
+      numUnfinished++;
+      changed.notify_one();
+      return future;
+   }
+   void shutdown()
+   {
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         isStopping = true;
+         changed.notify_all();
+      }
+      for (size_t i = 0; i < threads.size(); i++)
+         if (threads[i].joinable())
+            threads[i].join();
+   }
+private:
+   struct Task
+   {
+      int priority;
+      unsigned long long sequence;
+      std::function<void()> run;
+      bool operator < (const Task & rhs) const
+      {
+         return priority < rhs.priority ||
+                (priority == rhs.priority && sequence > rhs.sequence);
+      }
+   };
+   void work()
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      while (true)
+      {
+         Task task { 0, 0, nullptr };
+         if (heap.try_pop(task))
+         {
+            guard.unlock();
+            task.run();
+            guard.lock();
+            if (--numUnfinished == 0 && isStopping)
+               changed.notify_all();
+         }
+         else if (isStopping && numUnfinished == 0)
+            return;
+         else
+            changed.wait(guard);
+      }
+   }
+   std::mutex lock;
+   std::condition_variable changed;
+   custom::priority_queue<Task> heap;
+   custom::vector<std::thread> threads;
+   unsigned long long sequenceNext;
+   size_t numUnfinished;
+   bool isStopping;
+};
+
+template <class Executor>
+void forkTree(Executor & pool, std::atomic<size_t> & numRun, int depth)
+{
+   numRun++;
+   if (depth > 0)
+      for (int i = 0; i < 2; i++)
+         pool.submit(depth, [&pool, &numRun, depth]() { forkTree(pool, numRun, depth - 1); });
+}
+
+template <class Executor>
+void forkJoin(const std::string & name, size_t numWorkers, size_t n)
+{
+   int depth = 0;
+   while (((size_t)2 << (depth + 1)) - 1 <= n)
+      depth++;
+   size_t numTasks = ((size_t)2 << depth) - 1;
+   std::atomic<size_t> numRun(0);
+   double seconds = secondsFor([&]()
+   {
+      Executor pool(numWorkers);
+      pool.submit(depth + 1, [&pool, &numRun, depth]() { forkTree(pool, numRun, depth); });
+      while (numRun.load() < numTasks)
+         std::this_thread::yield();
+   });
+   row(name + " fork-join", numTasks, { "Mtasks/s", numTasks / seconds / 1e6 });
+}
+
+template <class Executor>
+void priorityWait(const std::string & name, size_t numWorkers, size_t numUrgent)
+{
+   typedef std::chrono::steady_clock Clock;
+   custom::vector<double> waits;
+   waits.reserve(numUrgent);
+   std::mutex lockWaits;
+   {
+      Executor pool(numWorkers);
+      std::atomic<bool> isDone(false);
+      // a fixed amount of work, tens of microseconds, not a fixed time:
+      // a chore switched out should not count as done
+      auto chore = [&isDone]()
+      {
+         volatile unsigned long long sum = 0;
+         for (unsigned long long i = 0; i < 50000 && !isDone; i++)
+            sum += i;
+      };
+      for (size_t i = 0; i < numWorkers * 4; i++)
+         pool.submit(0, chore);
+      for (size_t i = 0; i < numUrgent; i++)
+      {
+         // keep the workers swamped with chores
+         for (size_t j = 0; j < numWorkers; j++)
+            pool.submit(0, chore);
+         Clock::time_point submitted = Clock::now();
+         pool.submit(100, [submitted, &waits, &lockWaits]()
+         {
+            double wait = std::chrono::duration<double>(Clock::now() - submitted).count();
+            std::lock_guard<std::mutex> guard(lockWaits);
+            waits.push_back(wait);
+         }).wait();
+      }
+      isDone = true;
+   }
+   double total = 0.0;
+   for (size_t i = 0; i < waits.size(); i++)
+      total += waits[i];
+   double * p99 = &waits[0] + waits.size() * 99 / 100;
+   std::nth_element(&waits[0], p99, &waits[0] + waits.size());
+   row(name + " urgent wait", waits.size(),
+       { "us mean", total / waits.size() * 1e6 }, { "us p99", *p99 * 1e6 });
+}
+
+void benchExecutor(const custom::vector<size_t> & sizes)
+{
+   size_t numWorkers = std::thread::hardware_concurrency();
+   if (numWorkers < 2)
+      numWorkers = 2;
+   printf("   %zu workers\n", numWorkers);
+   for (size_t i = 0; i < sizes.size(); i++)
+   {
+      forkJoin<SharedExecutor>("shared", numWorkers, sizes[i]);
+      forkJoin<custom::priority_executor>("stealing", numWorkers, sizes[i]);
+      priorityWait<SharedExecutor>("shared", numWorkers, sizes[i] / 1000);
+      priorityWait<custom::priority_executor>("stealing", numWorkers, sizes[i] / 1000);
+   }
+}
+
+/**********************************************************************
+ * GROWTH
+ * A vector of n 8 byte words grown one push_back at a
+ * time. Word is the same bytes as uint64_t, but its
+ * copy constructor makes it not trivially copyable,
+ * so vector moves it an element at a time, as it did
+ * everything before the fast path
+ ***********************************************************************/
+struct Word
+{
+   Word(unsigned long long value = 0) : value(value) {}
+   Word(const Word & rhs) : value(rhs.value) {}
+   Word & operator = (const Word & rhs) { value = rhs.value; return *this; }
+   unsigned long long value;
+};
+
+template <class T>
+void growth(const std::string & name, size_t n)
+{
+   double secondsGrow = 0.0;
+   double seconds = secondsFor([&]()
+   {
+      custom::vector<T> v;
+      for (size_t i = 0; i < n; i++)
+      {
+         if (v.size() == v.capacity())
+            secondsGrow += secondsFor([&]() { v.reserve(v.capacity() ? v.capacity() * 2 : 1); });
+         v.push_back(T(i));
+      }
+   });
+   row(name, n, { "ms", seconds * 1e3 }, { "ms growing", secondsGrow * 1e3 });
+}
+
+void benchGrowth(const custom::vector<size_t> & sizes)
+{
+   for (size_t i = 0; i < sizes.size(); i++)
+   {
+      growth<Word>("element by element", sizes[i]);
+      growth<unsigned long long>("trivially copyable", sizes[i]);
+   }
+}
+
+/**********************************************************************
+ * TINY
+ * n queues that each hold a handful of items, all
+ * alive at once, as one per connection would be.
+ * With vector every queue allocates on each doubling
+ * on its way up; small_vector keeps them inline
+ ***********************************************************************/
+template <class PQueue>
+void tiny(const std::string & name, size_t n, size_t numItems)
+{
+   custom::vector<PQueue> queues;
+   queues.reserve(n);
+   for (size_t i = 0; i < n; i++)
+      queues.push_back(PQueue());
+
+   size_t numNewBegin = numNew.load();
+   double secondsPush = secondsFor([&]()
+   {
+      for (size_t i = 0; i < n; i++)
+         for (size_t j = 0; j < numItems; j++)
+            queues[i].push((int)((i + j * 7) % numItems));
+   });
+   size_t numAllocs = numNew.load() - numNewBegin;
+
+   long long total = 0;
+   double secondsPop = secondsFor([&]()
+   {
+      for (size_t i = 0; i < n; i++)
+         while (!queues[i].empty())
+         {
+            total += queues[i].top();
+            queues[i].pop();
+         }
+   });
+   if (total < 0)
+      printf("impossible\n");
+
+   row(name, n, { "ns/queue", (secondsPush + secondsPop) * 1e9 / n },
+       { "allocs/queue", (double)numAllocs / n });
+}
+
+void benchTiny(const custom::vector<size_t> & sizes)
+{
+   for (size_t i = 0; i < sizes.size(); i++)
+      for (size_t numItems : { 8, 16 })
+      {
+         printf("   %zu items each\n", numItems);
+         tiny<custom::priority_queue<int> >("vector", sizes[i], numItems);
+         tiny<custom::priority_queue<int, custom::small_vector<int, 16> > >
+            ("small_vector<16>", sizes[i], numItems);
+      }
+}
+
+/**********************************************************************
+ * ARENA
+ * n requests, each of which builds a queue, fills
+ * and drains it, and throws it away. The arena gives
+ * the memory back in one go when the request ends,
+ * and one on the stack never touches the heap
+ ***********************************************************************/
+const size_t numItemsRequest = 256;
+
+template <class PQueue>
+long long serve(PQueue & pq, size_t request)
+{
+   for (size_t j = 0; j < numItemsRequest; j++)
+      pq.push((int)((request + j * 263) % numItemsRequest));
+   long long total = 0;
+   while (!pq.empty())
+   {
+      total += pq.top();
+      pq.pop();
+   }
+   return total;
+}
+
+template <class F>
+void requests(const std::string & name, size_t n, F request)
+{
+   long long total = 0;
+   size_t numNewBegin = numNew.load();
+   double seconds = secondsFor([&]()
+   {
+      for (size_t i = 0; i < n; i++)
+         total += request(i);
+   });
+   size_t numAllocs = numNew.load() - numNewBegin;
+   if (total < 0)
+      printf("impossible\n");
+   row(name, n, { "ns/request", seconds * 1e9 / n },
+       { "allocs/request", (double)numAllocs / n });
+}
+
+void benchArena(const custom::vector<size_t> & sizes)
+{
+   typedef custom::vector<int, custom::arena_allocator<int> > ArenaVector;
+   typedef custom::priority_queue<int, ArenaVector> ArenaQueue;
+
+   printf("   %zu items each\n", numItemsRequest);
+   for (size_t i = 0; i < sizes.size(); i++)
+   {
+      requests("std::allocator", sizes[i], [](size_t request)
+      {
+         custom::priority_queue<int> pq;
+         return serve(pq, request);
+      });
+      requests("arena", sizes[i], [](size_t request)
+      {
+         custom::arena a;
+         ArenaQueue pq((custom::arena_allocator<int>(a)));
+         return serve(pq, request);
+      });
+      requests("arena on the stack", sizes[i], [](size_t request)
+      {
+         char buffer[8192];
+         custom::arena a(buffer, sizeof(buffer));
+         ArenaQueue pq((custom::arena_allocator<int>(a)));
+         return serve(pq, request);
+      });
+   }
+}
+
+/**********************************************************************
+ * GROUPS
+ * Every benchmark, by the name it is asked for, and
+ * the sizes it runs when none are given
+ ***********************************************************************/
+struct Group
+{
+   const char * name;
+   void (*run)(const custom::vector<size_t> & sizes);
+   size_t sizesDefault[3];
+};
+
+const Group groups[] =
+{
+   { "arity",   benchArity,   { 1000000, 10000000, 0 } },
+   { "heapify", benchHeapify, { 1000000, 10000000, 0 } },
+   { "layout",  benchLayout,  { 1000, 1000000, 30000000 } },
+   { "multiqueue", benchMultiQueue, { 100000, 1000000, 0 } },
+   { "hugepages",  benchHugePages,  { 10000000, 100000000, 0 } },
+   { "keyed",      benchKeyed,      { 100000, 1000000, 0 } },
+   { "skiplist",   benchSkiplist,   { 1000000, 0, 0 } },
+   { "combining",  benchCombining,  { 1000000, 0, 0 } },
+   { "pipeline",   benchPipeline,   { 1000000, 0, 0 } },
+   { "executor",   benchExecutor,   { 1000000, 0, 0 } },
+   { "growth",     benchGrowth,     { 1000000, 134217728, 0 } },
+   { "tiny",       benchTiny,       { 1000000, 0, 0 } },
+   { "arena",      benchArena,      { 1000000, 0, 0 } },
+};
+
+/**********************************************************************
+ * MAIN
+ * Run the named groups, or all of them
+ ***********************************************************************/
+int main(int argc, const char * argv[])
+{
+   custom::vector<size_t> sizes;
+   custom::vector<const char *> names;
+   for (int i = 1; i < argc; i++)
+      if (argv[i][0] >= '0' && argv[i][0] <= '9')
+         sizes.push_back((size_t)strtoull(argv[i], nullptr, 10));
+      else
+         names.push_back(argv[i]);
+
+   for (const Group & group : groups)
+   {
+      bool isNamed = names.empty();
+      for (size_t i = 0; i < names.size(); i++)
+         if (strcmp(names[i], group.name) == 0)
+            isNamed = true;
+      if (!isNamed)
+         continue;
+
+      custom::vector<size_t> sizesGroup(sizes);
+      if (sizesGroup.empty())
+         for (size_t i = 0; i < 3 && group.sizesDefault[i]; i++)
+            sizesGroup.push_back(group.sizesDefault[i]);
+
+      printf("%s\n", group.name);
+      group.run(sizesGroup);
+   }
+   return 0;
+}
@@ -0,0 +1,36 @@
+/***********************************************************************
+ * Header:
+ *    BITS
+ * Summary:
+ *    Little bit-twiddling helpers shared by the integer-keyed queues.
+ *    Uses the compiler builtins when there are some, a loop otherwise.
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+namespace custom
+{
+
+/*************************************************
+ * BIT WIDTH
+ * Number of bits needed to hold x: 0 for 0, 1 for 1,
+ * 2 for 2 and 3, and so on
+ *************************************************/
+inline int bitWidth(unsigned long long x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return x == 0 ? 0 : 64 - __builtin_clzll(x);
+#else
+   int width = 0;
+   while (x)
+   {
+      x >>= 1;
+      width++;
+   }
+   return width;
+#endif
+}
+
+}; // namespace custom
@@ -0,0 +1,249 @@
+/***********************************************************************
+ * Header:
+ *    BLOCKING PRIORITY QUEUE
+ * Summary:
+ *    A bounded priority queue for producer/consumer pipelines: a
+ *    producer waits while it is full, a consumer while it is empty
+ *
+ *    This will contain the class definition of:
+ *        blocking_priority_queue : A bounded, blocking Priority Queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <chrono>                // for std::chrono
+#include <condition_variable>    // for std::condition_variable
+#include <mutex>                 // for std::mutex
+#include "priority_queue.h"
+#include "vector.h"
+
+class TestBlockingPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * BLOCKING P QUEUE
+ * A priority_queue, a lock, and a condition for each
+ * side. The capacity is the backpressure: push waits
+ * for room, so a slow stage slows the one before it.
+ *
+ * Wakeups are coalesced. A sleeper is only woken when
+ * there are more sleepers than things for them, so
+ * after a push only while the number of items is no
+ * more than the number of waiting consumers. A burst
+ * of pushes then wakes each waiting consumer once, not
+ * once per item, and a consumer that wakes always
+ * finds its item unless a newcomer took it first.
+ * Pops wake producers the same way.
+ *************************************************/
+template<class T>
+class blocking_priority_queue
+{
+   friend class ::TestBlockingPQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   explicit blocking_priority_queue(size_t capacity);
+   blocking_priority_queue(const blocking_priority_queue &) = delete;
+   blocking_priority_queue & operator = (const blocking_priority_queue &) = delete;
+
+   //
+   // Insert. push waits for room, try_push does not
+   //
+   void  push(const T& t);
+   void  push(T&& t);
+   bool  try_push(const T& t);
+   bool  try_push(T&& t);
+
+   //
+   // Remove. pop_wait waits up to timeout for an item;
+   // pop_batch for the first of up to n, which are
+   // added to the back of items biggest first
+   //
+   bool   pop_wait(T & t, std::chrono::nanoseconds timeout);
+   size_t pop_batch(custom::vector<T> & items, size_t n,
+                    std::chrono::nanoseconds timeout = std::chrono::nanoseconds(0));
+
+   //
+   // Status. Only a snapshot while other threads are busy
+   //
+   size_t size() const
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      return heap.size();
+   }
+   bool empty() const
+   {
+      return size() == 0;
+   }
+   size_t capacity() const
+   {
+      return numCapacity;
+   }
+
+private:
+
+   bool waitNotEmpty(std::unique_lock<std::mutex> & guard, std::chrono::nanoseconds timeout);
+   void waitNotFull (std::unique_lock<std::mutex> & guard);
+   void notifyPushed();                  // an item is in: wake a consumer if one needs it
+   void notifyPopped();                  // a slot is free: wake a producer if one needs it
+
+   custom::priority_queue<T> heap;
+   size_t                    numCapacity;
+   mutable std::mutex        lock;
+   std::condition_variable   notEmpty;
+   std::condition_variable   notFull;
+   size_t                    numWaitingPop;    // consumers asleep on notEmpty
+   size_t                    numWaitingPush;   // producers asleep on notFull
+};
+
+/************************************************
+ * BLOCKING P QUEUE :: CONSTRUCTOR
+ ***********************************************/
+template <class T>
+blocking_priority_queue <T> :: blocking_priority_queue(size_t capacity) :
+   numCapacity(capacity ? capacity : 1), numWaitingPop(0), numWaitingPush(0)
+{
+}
+
+/*****************************************
+ * BLOCKING P QUEUE :: PUSH
+ * Wait for room, then add the item
+ ****************************************/
+template <class T>
+void blocking_priority_queue <T> :: push(const T & t)
+{
+   push(T(t));
+}
+template <class T>
+void blocking_priority_queue <T> :: push(T && t)
+{
+   std::unique_lock<std::mutex> guard(lock);
+   waitNotFull(guard);
+   heap.push(std::move(t));
+   notifyPushed();
+}
+
+/*****************************************
+ * BLOCKING P QUEUE :: TRY PUSH
+ * Add the item if there is room
+ ****************************************/
+template <class T>
+bool blocking_priority_queue <T> :: try_push(const T & t)
+{
+   return try_push(T(t));
+}
+template <class T>
+bool blocking_priority_queue <T> :: try_push(T && t)
+{
+   std::lock_guard<std::mutex> guard(lock);
+   if (heap.size() >= numCapacity)
+      return false;
+   heap.push(std::move(t));
+   notifyPushed();
+   return true;
+}
+
+/**********************************************
+ * BLOCKING P QUEUE :: POP WAIT
+ * Take the biggest item, waiting up to timeout for
+ * one to come. False if none did
+ **********************************************/
+template <class T>
+bool blocking_priority_queue <T> :: pop_wait(T & t, std::chrono::nanoseconds timeout)
+{
+   std::unique_lock<std::mutex> guard(lock);
+   if (!waitNotEmpty(guard, timeout))
+      return false;
+   heap.try_pop(t);
+   notifyPopped();
+   return true;
+}
+
+/**********************************************
+ * BLOCKING P QUEUE :: POP BATCH
+ * Take up to n of the biggest items in one go,
+ * waiting up to timeout for the first. Returns how
+ * many were taken
+ **********************************************/
+template <class T>
+size_t blocking_priority_queue <T> :: pop_batch(custom::vector<T> & items, size_t n,
+                                                 std::chrono::nanoseconds timeout)
+{
+   std::unique_lock<std::mutex> guard(lock);
+   if (n == 0 || !waitNotEmpty(guard, timeout))
+      return 0;
+   size_t numTaken = 0;
+   while (numTaken < n && heap.try_pop_into(items))
+   {
+      numTaken++;
+      notifyPopped();
+   }
+   return numTaken;
+}
+
+/**********************************************
+ * BLOCKING P QUEUE :: WAIT NOT EMPTY
+ * True once there is an item; false if the timeout
+ * ran out first
+ **********************************************/
+template <class T>
+bool blocking_priority_queue <T> :: waitNotEmpty(std::unique_lock<std::mutex> & guard,
+                                                  std::chrono::nanoseconds timeout)
+{
+   if (!heap.empty())
+      return true;
+   std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+   numWaitingPop++;
+   while (heap.empty())
+      if (notEmpty.wait_until(guard, deadline) == std::cv_status::timeout)
+         break;
+   numWaitingPop--;
+   return !heap.empty();
+}
+
+/**********************************************
+ * BLOCKING P QUEUE :: WAIT NOT FULL
+ **********************************************/
+template <class T>
+void blocking_priority_queue <T> :: waitNotFull(std::unique_lock<std::mutex> & guard)
+{
+   if (heap.size() < numCapacity)
+      return;
+   numWaitingPush++;
+   while (heap.size() >= numCapacity)
+      notFull.wait(guard);
+   numWaitingPush--;
+}
+
+/**********************************************
+ * BLOCKING P QUEUE :: NOTIFY PUSHED
+ * The items that were already here have consumers
+ * coming for them. Wake one more only if some are
+ * still asleep with nothing to come for
+ **********************************************/
+template <class T>
+void blocking_priority_queue <T> :: notifyPushed()
+{
+   if (heap.size() <= numWaitingPop)
+      notEmpty.notify_one();
+}
+
+/**********************************************
+ * BLOCKING P QUEUE :: NOTIFY POPPED
+ * Likewise for free slots and producers
+ **********************************************/
+template <class T>
+void blocking_priority_queue <T> :: notifyPopped()
+{
+   if (numCapacity - heap.size() <= numWaitingPush)
+      notFull.notify_one();
+}
+
+}; // namespace custom
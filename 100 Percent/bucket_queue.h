@@ -0,0 +1,216 @@
+/***********************************************************************
+ * Header:
+ *    BUCKET QUEUE
+ * Summary:
+ *    A priority queue for small integer priorities, such as QoS
+ *    classes 0..255, where top, push and pop are all O(1)
+ *
+ *    This will contain the class definition of:
+ *        bucket_queue           : A Priority Queue of bounded integers
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <utility>      // for std::swap
+#include "vector.h"
+#include "bits.h"
+
+class TestBucketQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * BUCKET QUEUE
+ * Same interface as the int priority_queue. Every
+ * priority 0..NumLevels-1 has its own bucket, and a
+ * two-level bitmap records which buckets have
+ * anything in them: bit i of word w is bucket w*64+i,
+ * and bit w of the summary says word w is not zero.
+ * Finding the top is two count-leading-zeros.
+ *
+ * The item is its own priority, so a bucket of them
+ * would only be the same value over and over: each
+ * bucket is just a count. The counts live on the heap
+ * and are not taken until the first push, so an empty
+ * queue is a few words, and the top item is kept
+ * aside for top() to hand back.
+ *************************************************/
+template<class T = int, size_t NumLevels = 256>
+class bucket_queue
+{
+   static_assert(NumLevels > 0 && NumLevels <= 64 * 64, "the bitmap holds up to 4096 levels");
+
+   friend class ::TestBucketQueue; // give the unit test class access to the privates
+   template <class TT, size_t NN>
+   friend void swap(bucket_queue<TT, NN>& lhs, bucket_queue<TT, NN>& rhs);
+public:
+
+   //
+   // construct
+   //
+   bucket_queue() : itemTop(T(0)), summary(0), numElements(0)
+   {
+      for (size_t w = 0; w < numWords; w++)
+         words[w] = 0;
+   }
+   template <class Iterator>
+   bucket_queue(Iterator first, Iterator last) : bucket_queue()
+   {
+      for (auto it = first; it != last; it++)
+         push(*it);
+   }
+   explicit bucket_queue(custom::vector<T> && rhs) : bucket_queue()
+   {
+      for (size_t i = 0; i < rhs.size(); i++)
+         push(rhs[i]);
+      rhs.clear();
+   }
+   explicit bucket_queue(custom::vector<T> & rhs) : bucket_queue()
+   {
+      for (size_t i = 0; i < rhs.size(); i++)
+         push(rhs[i]);
+   }
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   void  push(const T& t);
+   void  push(T&& t)
+   {
+      push(static_cast<const T &>(t));
+   }
+
+   //
+   // Remove
+   //
+   void  pop();
+
+   //
+   // Status
+   //
+   size_t size()  const
+   {
+      return numElements;
+   }
+   bool empty() const
+   {
+      return numElements == 0;
+   }
+
+private:
+
+   static const size_t numWords = (NumLevels + 63) / 64;
+
+   size_t levelOf(const T & t) const;
+   size_t levelTop() const
+   {
+      size_t w = bitWidth(summary) - 1;
+      return w * 64 + bitWidth(words[w]) - 1;
+   }
+   void markFull(size_t level)
+   {
+      words[level / 64] |= 1ull << (level % 64);
+      summary |= 1ull << (level / 64);
+   }
+   void markEmpty(size_t level)
+   {
+      words[level / 64] &= ~(1ull << (level % 64));
+      if (words[level / 64] == 0)
+         summary &= ~(1ull << (level / 64));
+   }
+
+   custom::vector<size_t> counts;            // items of each level, empty until the first push
+   T                      itemTop;           // an item of the highest level that has any
+   unsigned long long     words[numWords];   // one bit per bucket: is it full?
+   unsigned long long     summary;           // one bit per word: is it non-zero?
+   size_t                 numElements;
+};
+
+/************************************************
+ * BUCKET QUEUE :: TOP
+ * Get an item of the highest level
+ ***********************************************/
+template <class T, size_t NumLevels>
+const T & bucket_queue <T, NumLevels> :: top() const
+{
+   if (empty())
+      throw "std:out_of_range";
+   return itemTop;
+}
+
+/*****************************************
+ * BUCKET QUEUE :: PUSH
+ * Count the item in its bucket
+ ****************************************/
+template <class T, size_t NumLevels>
+void bucket_queue <T, NumLevels> :: push(const T & t)
+{
+   size_t level = levelOf(t);
+   if (counts.empty())
+      counts.resize(NumLevels, 0);
+   if (counts[level]++ == 0)
+      markFull(level);
+   if (numElements == 0 || itemTop < t)
+      itemTop = t;
+   numElements++;
+}
+
+/**********************************************
+ * BUCKET QUEUE :: POP
+ * Delete the top item. When its bucket runs dry the
+ * next level down with anything in it is the top
+ **********************************************/
+template <class T, size_t NumLevels>
+void bucket_queue <T, NumLevels> :: pop()
+{
+   if (empty())
+      return;
+
+   size_t level = levelTop();
+   if (--counts[level] == 0)
+   {
+      markEmpty(level);
+      if (summary)
+         itemTop = T(levelTop());
+   }
+   numElements--;
+}
+
+/**********************************************
+ * BUCKET QUEUE :: LEVEL OF
+ * The item is its own priority
+ **********************************************/
+template <class T, size_t NumLevels>
+size_t bucket_queue <T, NumLevels> :: levelOf(const T & t) const
+{
+   if (t < T(0) || !(t < T(NumLevels)))
+      throw "std:out_of_range";
+   return (size_t)t;
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two bucket queues
+ ************************************************/
+template <class T, size_t NumLevels>
+inline void swap(custom::bucket_queue <T, NumLevels>& lhs,
+                 custom::bucket_queue <T, NumLevels>& rhs)
+{
+   lhs.counts.swap(rhs.counts);
+   std::swap(lhs.itemTop, rhs.itemTop);
+   for (size_t w = 0; w < lhs.numWords; w++)
+      std::swap(lhs.words[w], rhs.words[w]);
+   std::swap(lhs.summary, rhs.summary);
+   std::swap(lhs.numElements, rhs.numElements);
+}
+
+}; // namespace custom
@@ -0,0 +1,289 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT PRIORITY QUEUE
+ * Summary:
+ *    A priority queue many threads can push to and pop from at once.
+ *    Every node of the heap has its own lock, so operations on
+ *    different parts of the tree do not wait on each other
+ *
+ *    This will contain the class definition of:
+ *        concurrent_priority_queue : A thread-safe Priority Queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>       // for std::atomic
+#include <cassert>
+#include <memory>       // for std::unique_ptr
+#include <mutex>        // for std::mutex
+#include <utility>      // for std::swap
+
+class TestConcurrentPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * CONCURRENT P QUEUE
+ * The heap of Hunt, Michael, Parthasarathy and Scott
+ * (1996). Same 1-based array as priority_queue, but
+ * each slot has a lock and a tag: EMPTY, AVAILABLE, or
+ * the id of the push still carrying its item up.
+ *    push : takes the next free slot under the one
+ *           global lock, then climbs bottom-up holding
+ *           just a parent and child at a time. Another
+ *           operation may move its item meanwhile; the
+ *           tag is how it finds it again
+ *    pop  : takes the last slot under the global lock,
+ *           swaps it into the root, and sifts down
+ *           top-down, again a parent and child at a time
+ * Locks are always taken global first and then parent
+ * before child, so there is no deadlock. Unlike the
+ * paper, pop locks the root before it lets go of the
+ * global lock: otherwise the last item is in no slot
+ * for a moment, another pop can return something
+ * smaller, and the queue is not linearizable.
+ * Slots are handed out in bit-reversed order along
+ * each level, so pushes in a row start in different
+ * subtrees and do not meet on the way up.
+ *
+ * Mutexes cannot be moved, so the array cannot grow:
+ * the capacity is fixed when the queue is made.
+ *************************************************/
+template<class T>
+class concurrent_priority_queue
+{
+   friend class ::TestConcurrentPQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   explicit concurrent_priority_queue(size_t capacity);
+   concurrent_priority_queue(const concurrent_priority_queue &) = delete;
+   concurrent_priority_queue & operator = (const concurrent_priority_queue &) = delete;
+
+   //
+   // Insert
+   //
+   void  push(const T& t);
+
+   //
+   // Remove. Between threads, top() and pop() could see
+   // different items, so it is one call
+   //
+   bool  try_pop(T & t);
+
+   //
+   // Status. Only a snapshot while other threads are busy
+   //
+   size_t size()  const
+   {
+      std::lock_guard<std::mutex> guard(lockHeap);
+      return numElements;
+   }
+   bool empty() const
+   {
+      return size() == 0;
+   }
+   size_t capacity() const
+   {
+      return numCapacity;
+   }
+
+private:
+
+   enum : unsigned long long { EMPTY = 0, AVAILABLE = 1 };
+
+   struct Node
+   {
+      std::mutex         lock;
+      unsigned long long tag;
+      T                  data;
+      Node() : tag(EMPTY) {}
+   };
+
+   static size_t indexOf(size_t number);   // slot of the number'th item
+
+   static void swapNodes(Node & lhs, Node & rhs)
+   {
+      std::swap(lhs.data, rhs.data);
+      std::swap(lhs.tag, rhs.tag);
+   }
+
+   std::unique_ptr<Node[]> nodes;          // nodes[1] is the root
+   size_t numCapacity;
+   size_t numElements;                     // guarded by lockHeap
+   mutable std::mutex lockHeap;
+   std::atomic<unsigned long long> tagNext;
+};
+
+/************************************************
+ * CONCURRENT P QUEUE :: CONSTRUCTOR
+ * Room for whole levels only, since the slots of a
+ * level are used out of order
+ ***********************************************/
+template <class T>
+concurrent_priority_queue <T> :: concurrent_priority_queue(size_t capacity) :
+   numElements(0), tagNext(AVAILABLE + 1)
+{
+   numCapacity = 1;
+   while (numCapacity < capacity)
+      numCapacity = numCapacity * 2 + 1;
+   nodes.reset(new Node[numCapacity + 1]);
+}
+
+/*****************************************
+ * CONCURRENT P QUEUE :: PUSH
+ * Claim a slot, then carry the item up while it is
+ * bigger than its parent
+ ****************************************/
+template <class T>
+void concurrent_priority_queue <T> :: push(const T & t)
+{
+   unsigned long long tag = tagNext++;
+
+   // claim the slot
+   std::unique_lock<std::mutex> guardHeap(lockHeap);
+   if (numElements == numCapacity)
+      throw "std:length_error";
+   size_t index = indexOf(++numElements);
+   std::unique_lock<std::mutex> guardNode(nodes[index].lock);
+   guardHeap.unlock();
+   nodes[index].data = t;
+   nodes[index].tag = tag;
+   guardNode.unlock();
+
+   // climb. A zero index means done
+   while (index > 1)
+   {
+      size_t indexParent = index / 2;
+      Node & parent = nodes[indexParent];
+      Node & node   = nodes[index];
+      std::lock_guard<std::mutex> guardParent(parent.lock);
+      std::lock_guard<std::mutex> guardChild(node.lock);
+
+      if (parent.tag == AVAILABLE && node.tag == tag)
+      {
+         if (parent.data < node.data)
+         {
+            swapNodes(parent, node);
+            index = indexParent;
+         }
+         else
+         {
+            node.tag = AVAILABLE;
+            index = 0;
+         }
+      }
+      else if (parent.tag == EMPTY)
+         index = 0;                  // a pop took our item, and it is in place
+      else if (node.tag != tag)
+         index = indexParent;        // a pop moved our item up: follow it
+      // otherwise the parent is another push in flight: try again
+   }
+
+   if (index == 1)
+   {
+      std::lock_guard<std::mutex> guardRoot(nodes[1].lock);
+      if (nodes[1].tag == tag)
+         nodes[1].tag = AVAILABLE;
+   }
+}
+
+/**********************************************
+ * CONCURRENT P QUEUE :: TRY POP
+ * Take the last item, put it in the root in place of
+ * the biggest one, and sift it down
+ **********************************************/
+template <class T>
+bool concurrent_priority_queue <T> :: try_pop(T & t)
+{
+   // take the last item, with the root already held
+   std::unique_lock<std::mutex> guardHeap(lockHeap);
+   if (numElements == 0)
+      return false;
+   size_t indexBottom = indexOf(numElements--);
+   std::unique_lock<std::mutex> guardHole(nodes[1].lock);
+   if (indexBottom == 1)
+   {
+      // the last item was the root: it is the answer
+      guardHeap.unlock();
+      t = std::move(nodes[1].data);
+      nodes[1].tag = EMPTY;
+      return true;
+   }
+   std::unique_lock<std::mutex> guardBottom(nodes[indexBottom].lock);
+   guardHeap.unlock();
+   T value(std::move(nodes[indexBottom].data));
+   nodes[indexBottom].tag = EMPTY;
+   guardBottom.unlock();
+
+   t = std::move(nodes[1].data);
+   nodes[1].data = std::move(value);
+   nodes[1].tag = AVAILABLE;
+
+   // sift down, holding the parent while choosing a child
+   size_t index = 1;
+   while (index * 2 + 1 <= numCapacity)
+   {
+      size_t indexLeft = index * 2;
+      std::unique_lock<std::mutex> guardLeft(nodes[indexLeft].lock);
+      std::unique_lock<std::mutex> guardRight(nodes[indexLeft + 1].lock);
+
+      size_t indexChild;
+      std::unique_lock<std::mutex> guardChild;
+      if (nodes[indexLeft].tag == EMPTY)
+         break;
+      else if (nodes[indexLeft + 1].tag == EMPTY ||
+               nodes[indexLeft + 1].data < nodes[indexLeft].data)
+      {
+         guardRight.unlock();
+         indexChild = indexLeft;
+         guardChild = std::move(guardLeft);
+      }
+      else
+      {
+         guardLeft.unlock();
+         indexChild = indexLeft + 1;
+         guardChild = std::move(guardRight);
+      }
+
+      if (!(nodes[index].data < nodes[indexChild].data))
+         break;
+      swapNodes(nodes[index], nodes[indexChild]);
+      guardHole = std::move(guardChild);
+      index = indexChild;
+   }
+   return true;
+}
+
+/**********************************************
+ * CONCURRENT P QUEUE :: INDEX OF
+ * The level is the number's highest bit; within the
+ * level, the rest of the bits are read backwards
+ **********************************************/
+template <class T>
+size_t concurrent_priority_queue <T> :: indexOf(size_t number)
+{
+   size_t level = 1;
+   int numBits = 0;
+   while ((level << 1) <= number)
+   {
+      level <<= 1;
+      numBits++;
+   }
+
+   size_t offset = number - level;
+   size_t reversed = 0;
+   for (int i = 0; i < numBits; i++)
+   {
+      reversed = (reversed << 1) | (offset & 1);
+      offset >>= 1;
+   }
+   return level | reversed;
+}
+
+}; // namespace custom
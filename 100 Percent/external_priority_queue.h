@@ -0,0 +1,483 @@
+/***********************************************************************
+ * Header:
+ *    EXTERNAL PRIORITY QUEUE
+ * Summary:
+ *    A priority queue for more items than fit in memory. The newest
+ *    items stay in an in-memory heap; when that outgrows its budget it
+ *    is written to disk as one sorted run, and the runs are merged back
+ *    a block at a time as pop drains them.
+ *
+ *    This will contain the class definition of:
+ *        external_priority_queue : A disk-backed Priority Queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <algorithm>    // for std::push_heap, std::pop_heap, std::sort_heap, std::reverse
+#include <cassert>
+#include <cstdio>       // for FILE, fopen, fread, fwrite
+#include <string>
+#include <type_traits>  // for std::is_trivially_copyable
+#include "vector.h"
+#include "priority_queue.h"
+
+class TestExternalPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * EXTERNAL P QUEUE
+ * Half of the memory budget is the hot heap, where
+ * every push goes. It is reserved once, full size,
+ * and spilled when full, so it never grows past its
+ * half. The other half is one block of read buffer
+ * per run on disk, so it also caps the number of
+ * runs: when a spill would go over, all the runs are
+ * merged into one first. Add one more block for the
+ * merge to write through.
+ *
+ * Merging everything keeps the runs few and the reads
+ * sequential, at a price: each merge rewrites every
+ * item on disk, so pushing N items with nothing popped
+ * writes about N * N / (budget * numRunsMax) items,
+ * not N. Pops between spills keep the runs short;
+ * otherwise, the bigger the budget the less it costs.
+ *
+ * A spill writes the run before it lets go of the hot
+ * items, and a merge keeps the old runs until the new
+ * one is written, so an I/O error throws and leaves
+ * every item where it was.
+ *
+ * Items go to disk byte for byte, so T has to be
+ * trivially copyable.
+ *************************************************/
+template<class T>
+class external_priority_queue
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "external_priority_queue writes items to disk as raw bytes");
+
+   friend class ::TestExternalPQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   external_priority_queue(size_t maxBytes, const std::string & directory,
+                           size_t blockBytes = 1 << 16);
+   external_priority_queue(const external_priority_queue &) = delete;
+   external_priority_queue & operator = (const external_priority_queue &) = delete;
+   ~external_priority_queue();
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   void  push(const T& t);
+
+   //
+   // Remove
+   //
+   void  pop();
+
+   //
+   // Status
+   //
+   size_t size()  const
+   {
+      return numElements;
+   }
+   bool empty() const
+   {
+      return numElements == 0;
+   }
+
+private:
+
+   // a sorted run on disk, biggest first, and the block of it read so far
+   struct Run
+   {
+      FILE *            file;
+      std::string       path;
+      custom::vector<T> block;
+      size_t            indexBlock;     // next item of the block to merge
+      size_t            sizeBlock;      // items read into the block
+   };
+
+   // the next item of a run, as seen by the merge
+   struct Head
+   {
+      T      value;
+      size_t iRun;
+      bool operator < (const Head & rhs) const { return value < rhs.value; }
+   };
+
+   // how far a run has been read, so a failed merge can go back there
+   struct Place
+   {
+      long   offset;
+      size_t indexBlock;
+      size_t sizeBlock;
+   };
+
+   bool isHotFirst() const;
+   void spill();                        // write the hot heap out as a run
+   void mergeRuns();                    // merge every run into one
+   FILE * createRun(std::string & path);
+   void writeBlock(FILE * file, const T * items, size_t num);
+   void finishRun(FILE * file);         // flush the run and go back to its front
+   void startRun(FILE * file, const std::string & path);
+   void advance(size_t iRun);           // the head of this run was taken
+   void restore(Run & run, const Place & place);
+   void closeRun(Run & run);
+
+   // the newest items. A heap in a vector of its own, as std::push_heap
+   // keeps it, so a spill can sort it in place and keep it until written
+   custom::vector<T>            hot;
+   custom::vector<Run>          runs;     // runs on disk; closed ones have no file
+   custom::priority_queue<Head> heads;    // one item from each open run
+   custom::vector<T>            output;   // write buffer for the merge
+   std::string directory;
+   size_t numHot;                         // hot heap items before a spill
+   size_t numBlock;                       // items in a read or write block
+   size_t numRunsMax;
+   size_t numRunsOpen;
+   size_t numElements;
+   size_t numFiles;                       // to give each run its own name
+   bool   isMerging;                      // keep drained runs until the merge is written
+};
+
+/************************************************
+ * EXTERNAL P QUEUE :: CONSTRUCTOR
+ * Split the budget between the hot heap and the
+ * run blocks
+ ***********************************************/
+template <class T>
+external_priority_queue <T> :: external_priority_queue(size_t maxBytes,
+                                                       const std::string & directory,
+                                                       size_t blockBytes) :
+   directory(directory), numRunsOpen(0), numElements(0), numFiles(0), isMerging(false)
+{
+   numBlock   = blockBytes / sizeof(T) > 0 ? blockBytes / sizeof(T) : 1;
+   numHot     = maxBytes / 2 / sizeof(T) > 0 ? maxBytes / 2 / sizeof(T) : 1;
+   numRunsMax = maxBytes / 2 / (numBlock * sizeof(T));
+   if (numRunsMax < 2)
+      numRunsMax = 2;
+   hot.reserve(numHot);
+   output.reserve(numBlock);
+}
+
+/************************************************
+ * EXTERNAL P QUEUE :: DESTRUCTOR
+ * The runs are scratch files, so delete them
+ ***********************************************/
+template <class T>
+external_priority_queue <T> :: ~external_priority_queue()
+{
+   for (size_t i = 0; i < runs.size(); i++)
+      closeRun(runs[i]);
+}
+
+/************************************************
+ * EXTERNAL P QUEUE :: TOP
+ * The bigger of the hot heap's top and the best
+ * head of the runs
+ ***********************************************/
+template <class T>
+const T & external_priority_queue <T> :: top() const
+{
+   if (empty())
+      throw "std:out_of_range";
+   return isHotFirst() ? hot.front() : heads.top().value;
+}
+
+/*****************************************
+ * EXTERNAL P QUEUE :: PUSH
+ * New items always go into the hot heap
+ ****************************************/
+template <class T>
+void external_priority_queue <T> :: push(const T & t)
+{
+   if (hot.size() == numHot)
+      spill();
+   hot.push_back(t);
+   std::push_heap(&hot[0], &hot[0] + hot.size());
+   numElements++;
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: POP
+ * Take the top from wherever it came from. A run
+ * is only read when its block runs dry
+ **********************************************/
+template <class T>
+void external_priority_queue <T> :: pop()
+{
+   if (empty())
+      return;
+
+   if (isHotFirst())
+   {
+      std::pop_heap(&hot[0], &hot[0] + hot.size());
+      hot.pop_back();
+      numElements--;
+   }
+   else
+   {
+      size_t iRun = heads.top().iRun;
+      heads.pop();
+      numElements--;
+      advance(iRun);
+   }
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: IS HOT FIRST
+ * Does the top come from the hot heap?
+ **********************************************/
+template <class T>
+bool external_priority_queue <T> :: isHotFirst() const
+{
+   if (heads.empty())
+      return true;
+   return !hot.empty() && !(hot.front() < heads.top().value);
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: SPILL
+ * Sort the hot heap in place, biggest first, and
+ * write it to a new run a block at a time. Sorted
+ * that way it is still a heap, so if the write fails
+ * the hot items are all still there
+ **********************************************/
+template <class T>
+void external_priority_queue <T> :: spill()
+{
+   if (numRunsOpen + 1 > numRunsMax)
+      mergeRuns();
+
+   T * first = &hot[0];
+   T * last  = first + hot.size();
+   std::sort_heap(first, last);
+   std::reverse(first, last);
+
+   std::string path;
+   FILE * file = createRun(path);
+   try
+   {
+      for (size_t i = 0; i < hot.size(); i += numBlock)
+         writeBlock(file, first + i, hot.size() - i < numBlock ? hot.size() - i : numBlock);
+      finishRun(file);
+   }
+   catch (...)
+   {
+      fclose(file);
+      std::remove(path.c_str());
+      throw;
+   }
+
+   // on disk now, so the hot heap can let go
+   hot.clear();
+   startRun(file, path);
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: MERGE RUNS
+ * Too many runs to keep a block of each in memory:
+ * merge them all into one. The heads are exactly the
+ * merge we need, so just pop them into a new file.
+ * Drained runs stay open until the new run is all
+ * written; if that fails, every run goes back to
+ * where it was
+ **********************************************/
+template <class T>
+void external_priority_queue <T> :: mergeRuns()
+{
+   custom::vector<Place> places;
+   places.reserve(runs.size());
+   for (size_t i = 0; i < runs.size(); i++)
+   {
+      Place place = { 0, runs[i].indexBlock, runs[i].sizeBlock };
+      if (runs[i].file && (place.offset = ftell(runs[i].file)) < 0)
+         throw "std:runtime_error";
+      places.push_back(place);
+   }
+   custom::priority_queue<Head> headsBefore(heads);
+
+   std::string path;
+   FILE * file = createRun(path);
+   isMerging = true;
+   try
+   {
+      output.clear();
+      while (!heads.empty())
+      {
+         output.push_back(heads.top().value);
+         size_t iRun = heads.top().iRun;
+         heads.pop();
+         advance(iRun);
+         if (output.size() == numBlock || heads.empty())
+         {
+            writeBlock(file, &output[0], output.size());
+            output.clear();
+         }
+      }
+      finishRun(file);
+   }
+   catch (...)
+   {
+      isMerging = false;
+      fclose(file);
+      std::remove(path.c_str());
+      custom::swap(heads, headsBefore);
+      for (size_t i = 0; i < runs.size(); i++)
+         if (runs[i].file)
+            restore(runs[i], places[i]);
+      throw;
+   }
+   isMerging = false;
+
+   // the merged run is safely written, so only now do the old ones go
+   for (size_t i = 0; i < runs.size(); i++)
+      closeRun(runs[i]);
+   runs.clear();
+   startRun(file, path);
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: CREATE RUN
+ * Make a new scratch file in the directory. "x"
+ * refuses a name that is already taken, so keep
+ * counting until one is free
+ **********************************************/
+template <class T>
+FILE * external_priority_queue <T> :: createRun(std::string & path)
+{
+   for (int attempt = 0; attempt < 1000; attempt++)
+   {
+      path = directory + "/pq_run_" + std::to_string((size_t)this) +
+             "_" + std::to_string(numFiles++);
+      FILE * file = fopen(path.c_str(), "w+bx");
+      if (file)
+         return file;
+   }
+   throw "std:runtime_error";
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: WRITE BLOCK
+ **********************************************/
+template <class T>
+void external_priority_queue <T> :: writeBlock(FILE * file, const T * items, size_t num)
+{
+   if (fwrite(items, sizeof(T), num, file) != num)
+      throw "std:runtime_error";
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: FINISH RUN
+ * A buffered write can fail as late as the flush
+ **********************************************/
+template <class T>
+void external_priority_queue <T> :: finishRun(FILE * file)
+{
+   if (fflush(file) != 0 || ferror(file) || fseek(file, 0, SEEK_SET) != 0)
+      throw "std:runtime_error";
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: START RUN
+ * The run is written and rewound; put its first
+ * item in the merge
+ **********************************************/
+template <class T>
+void external_priority_queue <T> :: startRun(FILE * file, const std::string & path)
+{
+   Run run;
+   run.file = file;
+   run.path = path;
+   run.block.resize(numBlock);
+   run.indexBlock = 0;
+   run.sizeBlock = 0;
+   runs.push_back(std::move(run));
+   numRunsOpen++;
+   advance(runs.size() - 1);
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: ADVANCE
+ * Put the next item of the run in the merge,
+ * reading another block if this one is used up.
+ * A run with nothing left is closed, unless a merge
+ * is still writing what came from it. A read that
+ * comes up short because of an error throws
+ **********************************************/
+template <class T>
+void external_priority_queue <T> :: advance(size_t iRun)
+{
+   Run & run = runs[iRun];
+   if (run.indexBlock == run.sizeBlock)
+   {
+      size_t sizeRead = fread(&run.block[0], sizeof(T), numBlock, run.file);
+      if (sizeRead < numBlock && ferror(run.file))
+         throw "std:runtime_error";
+      run.sizeBlock = sizeRead;
+      run.indexBlock = 0;
+      if (run.sizeBlock == 0)
+      {
+         if (!isMerging)
+            closeRun(run);
+         return;
+      }
+   }
+
+   Head head;
+   head.value = run.block[run.indexBlock++];
+   head.iRun = iRun;
+   heads.push(head);
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: RESTORE
+ * Put a run back the way it was before a merge
+ * read from it: the same block, the same position
+ **********************************************/
+template <class T>
+void external_priority_queue <T> :: restore(Run & run, const Place & place)
+{
+   clearerr(run.file);
+   long offsetBlock = place.offset - (long)(place.sizeBlock * sizeof(T));
+   if (fseek(run.file, offsetBlock, SEEK_SET) == 0 && place.sizeBlock != 0)
+      fread(&run.block[0], sizeof(T), place.sizeBlock, run.file);
+   fseek(run.file, place.offset, SEEK_SET);
+   run.indexBlock = place.indexBlock;
+   run.sizeBlock = place.sizeBlock;
+}
+
+/**********************************************
+ * EXTERNAL P QUEUE :: CLOSE RUN
+ * Delete the file and give back the block
+ **********************************************/
+template <class T>
+void external_priority_queue <T> :: closeRun(Run & run)
+{
+   if (!run.file)
+      return;
+   fclose(run.file);
+   std::remove(run.path.c_str());
+   run.file = nullptr;
+   run.block.clear();
+   run.block.shrink_to_fit();
+   numRunsOpen--;
+   if (numRunsOpen == 0)
+      runs.clear();
+}
+
+}; // namespace custom
@@ -0,0 +1,244 @@
+/***********************************************************************
+ * Header:
+ *    FLAT COMBINING PRIORITY QUEUE
+ * Summary:
+ *    A priority queue for many threads where one thread at a time does
+ *    everybody's work: the others post what they want and wait
+ *
+ *    This will contain the class definition of:
+ *        flat_combining_priority_queue : A thread-safe Priority Queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>       // for std::atomic
+#include <cassert>
+#include <functional>   // for std::hash
+#include <iterator>     // for std::make_move_iterator
+#include <memory>       // for std::unique_ptr
+#include <mutex>        // for std::mutex
+#include <thread>       // for std::this_thread
+#include "priority_queue.h"
+#include "vector.h"
+
+class TestFlatCombiningPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * FLAT COMBINING P QUEUE
+ * Flat combining, after Hendler, Incze, Shavit and
+ * Tzafrir (2010), in front of an ordinary
+ * priority_queue. A thread posts its push or pop in
+ * a publication slot and then either waits for the
+ * answer or, if the combiner lock is free, takes it
+ * and serves every slot posted so far:
+ *    push : all the pushes of the pass go in together,
+ *           heapified at once when there are enough
+ *    pop  : then the pops, one after another, while the
+ *           heap is still hot in the combiner's cache
+ * The heap itself is only ever touched by one thread,
+ * so it is the same sequential code; what is saved is
+ * the lock handoff per operation.
+ *
+ * A thread uses the slot its id hashes to, or the
+ * next free one, so with no more threads than slots
+ * each tends to keep its own.
+ *************************************************/
+template<class T>
+class flat_combining_priority_queue
+{
+   friend class ::TestFlatCombiningPQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   explicit flat_combining_priority_queue(size_t numSlots = 64);
+   flat_combining_priority_queue(const flat_combining_priority_queue &) = delete;
+   flat_combining_priority_queue & operator = (const flat_combining_priority_queue &) = delete;
+
+   //
+   // Insert
+   //
+   void  push(const T& t);
+   void  push(T&& t);
+
+   //
+   // Remove. Between threads, a top() would be stale by
+   // the time pop() came, so it is one call
+   //
+   bool  try_pop(T & t);
+
+   //
+   // Status. Only a snapshot while other threads are busy
+   //
+   size_t size()  const
+   {
+      return numElements.load();
+   }
+   bool empty() const
+   {
+      return size() == 0;
+   }
+
+private:
+
+   enum { FREE, POSTED_PUSH, POSTED_POP, DONE };
+
+   // padded, so threads posting to neighboring slots do not share a cache line
+   struct Slot
+   {
+      std::atomic<bool> isClaimed;
+      std::atomic<int>  state;
+      T                 value;
+      bool              isPopped;
+      char              padding[64];
+      Slot() : isClaimed(false), state(FREE), isPopped(false) {}
+   };
+
+   Slot & claim();                       // a free slot for this thread
+   void   post(Slot & slot, int state);  // hand over the request and wait until it is done
+   void   combine();                     // serve every posted slot
+
+   custom::priority_queue<T> heap;       // guarded by lockCombiner
+   custom::vector<T>         batch;      // the pushes of one pass, also guarded
+   custom::vector<size_t>    batchSlots; // and the slots they came from
+   std::unique_ptr<Slot[]>   slots;
+   size_t                    numSlots;
+   std::mutex                lockCombiner;
+   std::atomic<size_t>       numElements;
+   size_t                    numPasses;  // guarded by lockCombiner
+};
+
+/************************************************
+ * FLAT COMBINING P QUEUE :: CONSTRUCTOR
+ ***********************************************/
+template <class T>
+flat_combining_priority_queue <T> :: flat_combining_priority_queue(size_t numSlots) :
+   numSlots(numSlots ? numSlots : 1), numElements(0), numPasses(0)
+{
+   slots.reset(new Slot[this->numSlots]);
+}
+
+/*****************************************
+ * FLAT COMBINING P QUEUE :: PUSH
+ ****************************************/
+template <class T>
+void flat_combining_priority_queue <T> :: push(const T & t)
+{
+   push(T(t));
+}
+template <class T>
+void flat_combining_priority_queue <T> :: push(T && t)
+{
+   Slot & slot = claim();
+   slot.value = std::move(t);
+   numElements++;
+   post(slot, POSTED_PUSH);
+   slot.isClaimed.store(false);
+}
+
+/**********************************************
+ * FLAT COMBINING P QUEUE :: TRY POP
+ **********************************************/
+template <class T>
+bool flat_combining_priority_queue <T> :: try_pop(T & t)
+{
+   Slot & slot = claim();
+   post(slot, POSTED_POP);
+   bool isPopped = slot.isPopped;
+   if (isPopped)
+      t = std::move(slot.value);
+   slot.isClaimed.store(false);
+   return isPopped;
+}
+
+/**********************************************
+ * FLAT COMBINING P QUEUE :: CLAIM
+ * Start at the slot this thread hashes to, and take
+ * the first one free. With more threads than slots
+ * they can all be taken: then give the threads that
+ * hold them the core before looking round again
+ **********************************************/
+template <class T>
+typename flat_combining_priority_queue <T> :: Slot &
+flat_combining_priority_queue <T> :: claim()
+{
+   static thread_local size_t hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+   for (size_t numTried = 0, i = hash % numSlots; ; numTried++, i = (i + 1) % numSlots)
+   {
+      if (numTried != 0 && numTried % numSlots == 0)
+         std::this_thread::yield();
+      bool isClaimed = false;
+      if (!slots[i].isClaimed.load() && slots[i].isClaimed.compare_exchange_strong(isClaimed, true))
+         return slots[i];
+   }
+}
+
+/**********************************************
+ * FLAT COMBINING P QUEUE :: POST
+ * Whoever combines next will see the request. If
+ * nobody is combining, that is us
+ **********************************************/
+template <class T>
+void flat_combining_priority_queue <T> :: post(Slot & slot, int state)
+{
+   slot.state.store(state, std::memory_order_release);
+   while (slot.state.load(std::memory_order_acquire) != DONE)
+   {
+      if (lockCombiner.try_lock())
+      {
+         combine();
+         lockCombiner.unlock();
+      }
+      else
+         std::this_thread::yield();
+   }
+   slot.state.store(FREE, std::memory_order_relaxed);
+}
+
+/**********************************************
+ * FLAT COMBINING P QUEUE :: COMBINE
+ * One pass over the slots: gather the pushes into
+ * one batch for the heap, then answer the pops.
+ * Only ever called with lockCombiner held
+ **********************************************/
+template <class T>
+void flat_combining_priority_queue <T> :: combine()
+{
+   numPasses++;
+
+   // the pushes, all at once. A push posted after we looked
+   // waits for the next pass
+   batch.clear();
+   batchSlots.clear();
+   for (size_t i = 0; i < numSlots; i++)
+      if (slots[i].state.load(std::memory_order_acquire) == POSTED_PUSH)
+      {
+         batch.push_back(std::move(slots[i].value));
+         batchSlots.push_back(i);
+      }
+   if (batch.size())
+      heap.push(std::make_move_iterator(&batch[0]),
+                std::make_move_iterator(&batch[0] + batch.size()));
+   for (size_t i = 0; i < batchSlots.size(); i++)
+      slots[batchSlots[i]].state.store(DONE, std::memory_order_release);
+
+   // then the pops
+   for (size_t i = 0; i < numSlots; i++)
+   {
+      Slot & slot = slots[i];
+      if (slot.state.load(std::memory_order_acquire) != POSTED_POP)
+         continue;
+      slot.isPopped = heap.try_pop(slot.value);
+      if (slot.isPopped)
+         numElements--;
+      slot.state.store(DONE, std::memory_order_release);
+   }
+}
+
+}; // namespace custom
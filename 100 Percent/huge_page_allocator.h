@@ -0,0 +1,225 @@
+/***********************************************************************
+ * Header:
+ *    HUGE PAGE ALLOCATOR
+ * Summary:
+ *    An allocator for very large buffers. Big requests are mapped
+ *    straight from the operating system on huge page boundaries and
+ *    marked for huge pages, so a heap of hundreds of millions of items
+ *    needs a few thousand TLB entries rather than millions. Small
+ *    requests go to operator new as usual.
+ *
+ *    This will contain the class definition of:
+ *        huge_pages             : Mapping, unmapping and trimming of pages
+ *        huge_page_allocator    : An allocator that uses them for big buffers
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uintptr_t
+#include <new>          // for std::bad_alloc, ::operator new
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>   // for mmap, munmap, madvise
+#include <unistd.h>     // for sysconf
+#endif
+
+class TestHugePageAllocator;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * HUGE PAGES
+ * The part that talks to the operating system.
+ *
+ * map() rounds the length up to whole huge pages.
+ * With isExplicit it first asks for pages from the
+ * reserved huge page pool (MAP_HUGETLB, or
+ * MEM_LARGE_PAGES on Windows); that pool is often
+ * empty, so on failure, or without isExplicit, it
+ * maps ordinary pages instead. On Linux those are
+ * placed on a huge page boundary and handed to
+ * madvise(MADV_HUGEPAGE), so transparent huge pages
+ * can back them. Either way the memory is usable,
+ * huge pages or not.
+ *
+ * trim() gives the whole pages of a range back to
+ * the system but keeps the range mapped: touching it
+ * again brings back zeroed pages.
+ *************************************************/
+struct huge_pages
+{
+   static const size_t sizeHuge = (size_t)2 * 1024 * 1024;
+
+   static size_t roundUp(size_t size)
+   {
+      return (size + sizeHuge - 1) / sizeHuge * sizeHuge;
+   }
+
+   static void * map(size_t size, bool isExplicit);
+   static void   unmap(void * p, size_t size);
+   static void   trim(void * p, size_t size);
+};
+
+/************************************************
+ * HUGE PAGES :: MAP
+ * size is already a whole number of huge pages
+ ***********************************************/
+inline void * huge_pages :: map(size_t size, bool isExplicit)
+{
+#ifdef _WIN32
+   void * p = NULL;
+   if (isExplicit)
+      p = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+   if (p == NULL)
+      p = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+   if (p == NULL)
+      throw std::bad_alloc();
+   return p;
+#else
+#ifdef MAP_HUGETLB
+   if (isExplicit)
+   {
+      void * p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (p != MAP_FAILED)
+         return p;
+   }
+#endif
+   // map a huge page extra, then cut off the slack on either side
+   // so what is left starts on a huge page boundary
+   char * pMapped = (char *)mmap(nullptr, size + sizeHuge, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if ((void *)pMapped == MAP_FAILED)
+      throw std::bad_alloc();
+   char * p = (char *)(((uintptr_t)pMapped + sizeHuge - 1) & ~(uintptr_t)(sizeHuge - 1));
+   if (p != pMapped)
+      munmap(pMapped, p - pMapped);
+   if (p + size != pMapped + size + sizeHuge)
+      munmap(p + size, (pMapped + size + sizeHuge) - (p + size));
+#ifdef MADV_HUGEPAGE
+   madvise(p, size, MADV_HUGEPAGE);    // only advice: no huge pages is fine
+#endif
+   return p;
+#endif
+}
+
+/************************************************
+ * HUGE PAGES :: UNMAP
+ ***********************************************/
+inline void huge_pages :: unmap(void * p, size_t size)
+{
+#ifdef _WIN32
+   (void)size;
+   VirtualFree(p, 0, MEM_RELEASE);
+#else
+   munmap(p, size);
+#endif
+}
+
+/************************************************
+ * HUGE PAGES :: TRIM
+ * Only the whole small pages inside the range go
+ ***********************************************/
+inline void huge_pages :: trim(void * p, size_t size)
+{
+#ifdef _WIN32
+   SYSTEM_INFO info;
+   GetSystemInfo(&info);
+   size_t sizePage = (size_t)info.dwPageSize;
+#else
+   size_t sizePage = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+   uintptr_t begin = ((uintptr_t)p + sizePage - 1) & ~(uintptr_t)(sizePage - 1);
+   uintptr_t end   = ((uintptr_t)p + size) & ~(uintptr_t)(sizePage - 1);
+   if (begin >= end)
+      return;
+#ifdef _WIN32
+   VirtualAlloc((void *)begin, end - begin, MEM_RESET, PAGE_READWRITE);
+#else
+   madvise((void *)begin, end - begin, MADV_DONTNEED);
+#endif
+}
+
+/*************************************************
+ * HUGE PAGE ALLOCATOR
+ * Requests of at least sizeMin bytes are mapped by
+ * huge_pages, anything smaller comes from operator
+ * new, so a vector only starts mapping once it has
+ * grown big enough for huge pages to matter. The size
+ * passed to deallocate tells which it was, so two of
+ * these are only equal when they share sizeMin.
+ *
+ * trim() is how a vector hands back the tail of its
+ * buffer without copying what it keeps:
+ * vector::shrink_to_fit calls it when the allocator
+ * has one. It only applies to a mapped buffer whose
+ * kept part is still worth mapping; otherwise it
+ * returns false and the vector reallocates, so a
+ * small buffer really shrinks and a mapping cut down
+ * below sizeMin is let go.
+ *************************************************/
+template <class T>
+class huge_page_allocator
+{
+   template <class U>
+   friend class huge_page_allocator;
+   friend class ::TestHugePageAllocator; // give the unit test class access to the privates
+public:
+   typedef T value_type;
+
+   explicit huge_page_allocator(size_t sizeMin = huge_pages::sizeHuge, bool isExplicit = false) :
+      sizeMin(sizeMin ? sizeMin : 1), isExplicit(isExplicit) {}
+   template <class U>
+   huge_page_allocator(const huge_page_allocator<U> & rhs) :
+      sizeMin(rhs.sizeMin), isExplicit(rhs.isExplicit) {}
+
+   T * allocate(size_t n)
+   {
+      if (n > (size_t)-1 / sizeof(T) - huge_pages::sizeHuge)
+         throw std::bad_alloc();
+      if (n * sizeof(T) < sizeMin)
+         return (T *)::operator new(n * sizeof(T));
+      return (T *)huge_pages::map(huge_pages::roundUp(n * sizeof(T)), isExplicit);
+   }
+   void deallocate(T * p, size_t n)
+   {
+      if (n * sizeof(T) < sizeMin)
+         ::operator delete((void *)p);
+      else
+         huge_pages::unmap((void *)p, huge_pages::roundUp(n * sizeof(T)));
+   }
+
+   // the buffer p of n items only needs its first numUsed now.
+   // Returns false, doing nothing, unless p is mapped and stays so
+   bool trim(T * p, size_t n, size_t numUsed)
+   {
+      if (n * sizeof(T) < sizeMin || numUsed * sizeof(T) < sizeMin || numUsed >= n)
+         return false;
+      huge_pages::trim((void *)(p + numUsed), (n - numUsed) * sizeof(T));
+      return true;
+   }
+
+   template <class U>
+   bool operator == (const huge_page_allocator<U> & rhs) const { return sizeMin == rhs.sizeMin; }
+   template <class U>
+   bool operator != (const huge_page_allocator<U> & rhs) const { return sizeMin != rhs.sizeMin; }
+
+private:
+   size_t sizeMin;       // smallest request worth mapping, in bytes
+   bool   isExplicit;    // try the reserved huge page pool first
+};
+
+}; // namespace custom
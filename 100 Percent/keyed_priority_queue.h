@@ -0,0 +1,339 @@
+/***********************************************************************
+ * Header:
+ *    KEYED PRIORITY QUEUE
+ * Summary:
+ *    A priority queue for big items with small keys. Only the keys are
+ *    kept in the heap; the items sit still in a side array until they
+ *    are popped, so sifting moves a few bytes per level rather than
+ *    the whole item.
+ *
+ *    This will contain the class definition of:
+ *        keyed_priority_queue   : A Priority Queue of payloads by key
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>      // for std::max_align_t
+#include <cstdint>      // for uintptr_t
+#include <functional>   // for std::less
+#include <new>          // for placement new, ::operator new
+#include <utility>      // for std::move
+#include "priority_queue.h"
+#include "vector.h"
+
+class TestKeyedPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * KEYED P QUEUE
+ * The heap is an ordinary priority_queue, so all its
+ * sifting, arity and layout are reused, but what it
+ * holds is an Entry: the key and the index of the
+ * payload's slot. Compare only ever sees keys, and a
+ * level of sifting moves one Entry.
+ *
+ * The slots are raw storage, as in vector. A payload
+ * is moved into its slot on push, moved out once on
+ * try_pop, and destroyed as soon as it is popped
+ * either way. The slot goes on a free list for the
+ * next push. When the queue empties, the slots are
+ * all let go, so the side array never holds more
+ * than the queue did at its biggest.
+ *
+ * Neither Key nor Payload needs a default constructor:
+ * an Entry is only ever made from a key and a slot.
+ *************************************************/
+template <class Key, class Payload, class Compare = std::less<Key>, size_t Arity = 2>
+class keyed_priority_queue
+{
+   friend class ::TestKeyedPQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   explicit keyed_priority_queue(const Compare & c = Compare()) :
+      heap(CompareEntry(c)), slots(nullptr), numSlots(0), numSlotsCapacity(0) {}
+   keyed_priority_queue(const keyed_priority_queue & rhs);
+   keyed_priority_queue(keyed_priority_queue && rhs) :
+      heap(std::move(rhs.heap)), slotsFree(std::move(rhs.slotsFree)),
+      slots(rhs.slots), numSlots(rhs.numSlots), numSlotsCapacity(rhs.numSlotsCapacity)
+   {
+      rhs.slots = nullptr;
+      rhs.numSlots = 0;
+      rhs.numSlotsCapacity = 0;
+   }
+  ~keyed_priority_queue()
+   {
+      forEachLive([this](size_t slot) { slots[slot].~Payload(); });
+      deallocateSlots(slots);
+   }
+
+   //
+   // Assign
+   //
+   keyed_priority_queue & operator = (keyed_priority_queue rhs)
+   {
+      swap(rhs);
+      return *this;
+   }
+   void swap(keyed_priority_queue & rhs)
+   {
+      custom::swap(heap, rhs.heap);
+      slotsFree.swap(rhs.slotsFree);
+      std::swap(slots,            rhs.slots);
+      std::swap(numSlots,         rhs.numSlots);
+      std::swap(numSlotsCapacity, rhs.numSlotsCapacity);
+   }
+
+   //
+   // Access. The biggest key, and its payload
+   //
+   const Key & top_key() const
+   {
+      return heap.top().key;
+   }
+   const Payload & top() const
+   {
+      return slots[heap.top().slot];
+   }
+
+   //
+   // Insert
+   //
+   void push(const Key & key, const Payload & payload)
+   {
+      push(key, Payload(payload));
+   }
+   void push(const Key & key, Payload && payload);
+   void reserve(size_t n)
+   {
+      heap.reserve(n);
+      if (n > numSlotsCapacity)
+         grow(n);
+   }
+
+   //
+   // Remove. try_pop moves the payload out; false when empty
+   //
+   void pop();
+   bool try_pop(Key & key, Payload & payload);
+
+   //
+   // Status
+   //
+   size_t size()  const { return heap.size();  }
+   bool   empty() const { return heap.empty(); }
+
+private:
+
+   struct Entry
+   {
+      Key    key;
+      size_t slot;     // where the payload is, in payloads
+   };
+
+   // order entries by their keys alone
+   struct CompareEntry
+   {
+      Compare compare;
+      explicit CompareEntry(const Compare & c = Compare()) : compare(c) {}
+      bool operator () (const Entry & lhs, const Entry & rhs) const
+      {
+         return compare(lhs.key, rhs.key);
+      }
+   };
+
+   void release(size_t slot);     // the payload in slot has been destroyed
+   void grow(size_t newCapacity); // more slots, moving the live payloads over
+   static Payload * allocateSlots(size_t n);   // raw storage aligned for Payload
+   static void      deallocateSlots(Payload * p);
+   template <class F>
+   void forEachLive(F f) const;   // f(slot) for each slot holding a payload
+
+   priority_queue<Entry, custom::vector<Entry>, CompareEntry, Arity> heap;
+   custom::vector<size_t>  slotsFree;    // slots of payloads that have been popped
+   Payload * slots;                      // raw storage: only the slots in the heap hold a payload
+   size_t    numSlots;                   // slots handed out so far, free ones included
+   size_t    numSlotsCapacity;
+};
+
+/*****************************************
+ * KEYED P QUEUE :: COPY CONSTRUCTOR
+ * Copy the payloads that are there, slot for slot
+ ****************************************/
+template <class Key, class Payload, class Compare, size_t Arity>
+keyed_priority_queue <Key, Payload, Compare, Arity> :: keyed_priority_queue(const keyed_priority_queue & rhs) :
+   heap(rhs.heap), slotsFree(rhs.slotsFree), slots(nullptr), numSlots(0), numSlotsCapacity(0)
+{
+   if (rhs.numSlots == 0)
+      return;
+   slots = allocateSlots(rhs.numSlots);
+   numSlotsCapacity = rhs.numSlots;
+   rhs.forEachLive([this, &rhs](size_t slot) { new (slots + slot) Payload(rhs.slots[slot]); });
+   numSlots = rhs.numSlots;
+}
+
+/*****************************************
+ * KEYED P QUEUE :: PUSH
+ * The payload goes in a free slot, if there is one
+ ****************************************/
+template <class Key, class Payload, class Compare, size_t Arity>
+void keyed_priority_queue <Key, Payload, Compare, Arity> :: push(const Key & key, Payload && payload)
+{
+   size_t slot;
+   if (slotsFree.empty())
+   {
+      if (numSlots == numSlotsCapacity)
+         grow(numSlotsCapacity ? numSlotsCapacity * 2 : 1);
+      slot = numSlots++;
+   }
+   else
+   {
+      slot = slotsFree.back();
+      slotsFree.pop_back();
+   }
+   new (slots + slot) Payload(std::move(payload));
+   heap.push(Entry{ key, slot });
+}
+
+/**********************************************
+ * KEYED P QUEUE :: POP
+ * Destroy the top payload without looking at it
+ **********************************************/
+template <class Key, class Payload, class Compare, size_t Arity>
+void keyed_priority_queue <Key, Payload, Compare, Arity> :: pop()
+{
+   if (heap.empty())
+      return;
+   size_t slot = heap.top().slot;
+   heap.pop();
+   slots[slot].~Payload();
+   release(slot);
+}
+
+/**********************************************
+ * KEYED P QUEUE :: TRY POP
+ * Hand over the top key and its payload. The heap
+ * only lends out its top, so the key is copied;
+ * keys are meant to be small
+ **********************************************/
+template <class Key, class Payload, class Compare, size_t Arity>
+bool keyed_priority_queue <Key, Payload, Compare, Arity> :: try_pop(Key & key, Payload & payload)
+{
+   if (heap.empty())
+      return false;
+   size_t slot = heap.top().slot;
+   key = heap.top().key;
+   payload = std::move(slots[slot]);
+   heap.pop();
+   slots[slot].~Payload();
+   release(slot);
+   return true;
+}
+
+/**********************************************
+ * KEYED P QUEUE :: RELEASE
+ * Keep the slot for the next push, or let every
+ * slot go once the queue is empty. Either way the
+ * payloads popped are already destroyed
+ **********************************************/
+template <class Key, class Payload, class Compare, size_t Arity>
+void keyed_priority_queue <Key, Payload, Compare, Arity> :: release(size_t slot)
+{
+   if (heap.empty())
+   {
+      numSlots = 0;
+      slotsFree.clear();
+   }
+   else
+      slotsFree.push_back(slot);
+}
+
+/**********************************************
+ * KEYED P QUEUE :: GROW
+ * New storage for the slots. The live payloads move
+ * over to the same slots; the free ones stay raw
+ **********************************************/
+template <class Key, class Payload, class Compare, size_t Arity>
+void keyed_priority_queue <Key, Payload, Compare, Arity> :: grow(size_t newCapacity)
+{
+   Payload * slotsNew = allocateSlots(newCapacity);
+   forEachLive([this, slotsNew](size_t slot)
+   {
+      new (slotsNew + slot) Payload(std::move(slots[slot]));
+      slots[slot].~Payload();
+   });
+   deallocateSlots(slots);
+   slots = slotsNew;
+   numSlotsCapacity = newCapacity;
+}
+
+/**********************************************
+ * KEYED P QUEUE :: ALLOCATE SLOTS
+ * Room for n payloads. operator new only promises
+ * max_align_t, so an over-aligned Payload gets some
+ * extra bytes to round up into, and the pointer
+ * operator new gave back is kept just below the slots
+ **********************************************/
+template <class Key, class Payload, class Compare, size_t Arity>
+Payload * keyed_priority_queue <Key, Payload, Compare, Arity> :: allocateSlots(size_t n)
+{
+   const size_t alignment = alignof(Payload);
+   if (n > ((size_t)-1 - alignment) / sizeof(Payload))
+      throw std::bad_alloc();
+   if (alignment <= alignof(std::max_align_t))
+      return static_cast<Payload *>(::operator new(n * sizeof(Payload)));
+
+   // the rounding moves at least max_align_t, room enough for the pointer
+   char * pRaw = static_cast<char *>(::operator new(n * sizeof(Payload) + alignment));
+   char * p = (char *)(((uintptr_t)pRaw + alignment) & ~(uintptr_t)(alignment - 1));
+   ((char **)p)[-1] = pRaw;
+   return (Payload *)p;
+}
+
+/**********************************************
+ * KEYED P QUEUE :: DEALLOCATE SLOTS
+ * Give back what allocateSlots took
+ **********************************************/
+template <class Key, class Payload, class Compare, size_t Arity>
+void keyed_priority_queue <Key, Payload, Compare, Arity> :: deallocateSlots(Payload * p)
+{
+   if (p == nullptr)
+      return;
+   if (alignof(Payload) <= alignof(std::max_align_t))
+      ::operator delete((void *)p);
+   else
+      ::operator delete((void *)((char **)p)[-1]);
+}
+
+/**********************************************
+ * KEYED P QUEUE :: FOR EACH LIVE
+ * Every slot handed out and not on the free list.
+ * Only for the rare whole-array jobs: it builds a
+ * map of the free slots first
+ **********************************************/
+template <class Key, class Payload, class Compare, size_t Arity>
+template <class F>
+void keyed_priority_queue <Key, Payload, Compare, Arity> :: forEachLive(F f) const
+{
+   if (slotsFree.empty())
+   {
+      for (size_t slot = 0; slot < numSlots; slot++)
+         f(slot);
+      return;
+   }
+   custom::vector<char> isFree(numSlots, 0);
+   for (size_t i = 0; i < slotsFree.size(); i++)
+      isFree[slotsFree[i]] = 1;
+   for (size_t slot = 0; slot < numSlots; slot++)
+      if (!isFree[slot])
+         f(slot);
+}
+
+}; // namespace custom
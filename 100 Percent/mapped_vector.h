@@ -0,0 +1,377 @@
+/***********************************************************************
+ * Header:
+ *    MAPPED VECTOR
+ * Summary:
+ *    A vector whose storage is a memory-mapped file, so what is in it
+ *    outlives the process. Opening the file again maps it back in
+ *    place: nothing is read or copied.
+ *
+ *    This will contain the class definition of:
+ *        mapped_vector          : A file-backed Vector of plain items
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>      // for uint64_t
+#include <string>
+#include <type_traits>  // for std::is_trivially_copyable
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>      // for open
+#include <sys/mman.h>   // for mmap, munmap, msync
+#include <sys/stat.h>   // for fstat
+#include <unistd.h>     // for ftruncate, close
+#endif
+
+class TestPersistentPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * MAPPED VECTOR
+ * The file starts with a header: a magic number,
+ * the item size, the size and the capacity, and a
+ * journal the owner can use to record an update
+ * that is part way done. A spare item slot for the
+ * journal follows, then the items.
+ *
+ * There is no checksum. The size and capacity change
+ * on every push, one word at a time, and a crash can
+ * land between any two words, so a checksum over them
+ * could not be kept right. Opening the file checks
+ * each field instead: the magic number and item size
+ * against this T, the size against the capacity, and
+ * the capacity against the length of the file.
+ *
+ * The items are the bytes in the file, so T has to
+ * be trivially copyable and the file is only good on
+ * the kind of machine that wrote it.
+ *************************************************/
+template<class T>
+class mapped_vector
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "mapped_vector keeps items in a file as raw bytes");
+
+   friend class ::TestPersistentPQueue; // give the unit test class access to the privates
+public:
+
+   // an update in progress: op is zero when there is none
+   struct Journal
+   {
+      uint64_t op;
+      uint64_t size;
+      uint64_t index;
+   };
+
+   //
+   // Construct
+   //
+   explicit mapped_vector(const std::string & path);
+   mapped_vector(const mapped_vector &) = delete;
+   mapped_vector & operator = (const mapped_vector &) = delete;
+   ~mapped_vector();
+
+   //
+   // Access
+   //
+         T& operator [] (size_t index)       { return items()[index];   }
+   const T& operator [] (size_t index) const { return items()[index];   }
+         T& front()                          { return items()[0];       }
+   const T& front() const                    { return items()[0];       }
+         T& back()                           { return items()[size() - 1]; }
+   const T& back()  const                    { return items()[size() - 1]; }
+   Journal & journal()                       { return header()->journal; }
+   T & journalItem()                         { return *(T *)(base + offsetJournalItem); }
+
+   //
+   // Insert
+   //
+   void push_back(const T & t);
+   void reserve(size_t newCapacity);
+   void resize(size_t newElements);
+
+   //
+   // Remove
+   //
+   void pop_back()
+   {
+      if (!empty())
+         header()->size--;
+   }
+   void clear()
+   {
+      header()->size = 0;
+   }
+
+   //
+   // Status
+   //
+   size_t size()     const { return (size_t)header()->size;     }
+   size_t capacity() const { return (size_t)header()->capacity; }
+   bool   empty()    const { return size() == 0;                }
+
+   // push what is mapped out to the disk, so it survives the machine too
+   void sync();
+
+private:
+
+   struct Header
+   {
+      uint64_t magic;
+      uint64_t sizeItem;
+      uint64_t size;
+      uint64_t capacity;
+      Journal  journal;
+   };
+
+   static const uint64_t magicNumber       = 0x5051484541504632ull; // "PQHEAPF2"
+   static const size_t   offsetJournalItem = 64;
+   static const size_t   offsetItems       = offsetJournalItem + (sizeof(T) + 63) / 64 * 64;
+
+   static size_t lengthFor(size_t capacity) { return offsetItems + capacity * sizeof(T); }
+
+   Header * header()             { return (Header *)base;            }
+   const Header * header() const { return (const Header *)base;      }
+   T * items()                   { return (T *)(base + offsetItems); }
+   const T * items() const       { return (const T *)(base + offsetItems); }
+
+   void map(size_t length);     // map the first length bytes in place of the old mapping
+   void unmap();
+
+   char * base;                 // where the file is mapped
+   size_t lengthMapped;
+#ifdef _WIN32
+   HANDLE file;
+   HANDLE mapping;
+#else
+   int    file;
+#endif
+};
+
+/************************************************
+ * MAPPED VECTOR :: CONSTRUCTOR
+ * Map the file. A new or empty file gets a fresh
+ * header; anything else has to be one of ours, for
+ * this T, and no shorter than its header says
+ ***********************************************/
+template <class T>
+mapped_vector <T> :: mapped_vector(const std::string & path) : base(nullptr), lengthMapped(0)
+{
+   static_assert(sizeof(Header) <= offsetJournalItem, "the header has to fit before the journal item");
+
+   size_t lengthFile = 0;
+#ifdef _WIN32
+   mapping = NULL;
+   file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                      OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+   if (file == INVALID_HANDLE_VALUE)
+      throw "std:runtime_error";
+   LARGE_INTEGER length;
+   if (!GetFileSizeEx(file, &length))
+   {
+      CloseHandle(file);
+      throw "std:runtime_error";
+   }
+   lengthFile = (size_t)length.QuadPart;
+#else
+   file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+   if (file < 0)
+      throw "std:runtime_error";
+   struct stat status;
+   if (fstat(file, &status) != 0)
+   {
+      close(file);
+      throw "std:runtime_error";
+   }
+   lengthFile = (size_t)status.st_size;
+#endif
+
+   try
+   {
+      if (lengthFile == 0)
+      {
+         map(lengthFor(0));
+         Header * h = header();
+         h->sizeItem = sizeof(T);
+         h->size = 0;
+         h->capacity = 0;
+         h->journal.op = 0;
+         h->journal.size = 0;
+         h->journal.index = 0;
+         h->magic = magicNumber;
+      }
+      else
+      {
+         if (lengthFile < lengthFor(0))
+            throw "std:runtime_error";
+         map(lengthFile);
+         const Header * h = header();
+         if (h->magic != magicNumber ||
+             h->sizeItem != sizeof(T) || h->size > h->capacity ||
+             lengthFor((size_t)h->capacity) > lengthFile)
+            throw "std:runtime_error";
+      }
+   }
+   catch (...)
+   {
+      unmap();
+#ifdef _WIN32
+      CloseHandle(file);
+#else
+      close(file);
+#endif
+      throw;
+   }
+}
+
+/************************************************
+ * MAPPED VECTOR :: DESTRUCTOR
+ * Unmapping keeps what was written: it is the file
+ ***********************************************/
+template <class T>
+mapped_vector <T> :: ~mapped_vector()
+{
+   unmap();
+#ifdef _WIN32
+   CloseHandle(file);
+#else
+   close(file);
+#endif
+}
+
+/*****************************************
+ * MAPPED VECTOR :: PUSH BACK
+ * The item goes in before the size says it is there
+ ****************************************/
+template <class T>
+void mapped_vector <T> :: push_back(const T & t)
+{
+   if (size() == capacity())
+   {
+      T copy(t);    // t may be in the mapping about to move
+      reserve(capacity() ? capacity() * 2 : 1);
+      items()[size()] = copy;
+   }
+   else
+      items()[size()] = t;
+   header()->size++;
+}
+
+/*****************************************
+ * MAPPED VECTOR :: RESERVE
+ * Grow the file and map it again. Only then does
+ * the header own up to the new capacity. If either
+ * step fails, the old mapping is still there
+ ****************************************/
+template <class T>
+void mapped_vector <T> :: reserve(size_t newCapacity)
+{
+   if (newCapacity <= capacity())
+      return;
+   map(lengthFor(newCapacity));
+   header()->capacity = newCapacity;
+}
+
+/*****************************************
+ * MAPPED VECTOR :: RESIZE
+ * The items are plain bytes, so there is nothing
+ * to construct: only the size changes
+ ****************************************/
+template <class T>
+void mapped_vector <T> :: resize(size_t newElements)
+{
+   if (newElements > capacity())
+      reserve(newElements);
+   header()->size = newElements;
+}
+
+/*****************************************
+ * MAPPED VECTOR :: SYNC
+ * A process that dies leaves its writes with the
+ * operating system. This is for the machine dying
+ ****************************************/
+template <class T>
+void mapped_vector <T> :: sync()
+{
+#ifdef _WIN32
+   FlushViewOfFile(base, 0);
+   FlushFileBuffers(file);
+#else
+   msync(base, lengthMapped, MS_SYNC);
+#endif
+}
+
+/*****************************************
+ * MAPPED VECTOR :: MAP
+ * Make the file at least length bytes and map
+ * all of it. The old mapping, if any, is only let
+ * go once the new one is in place, so a failure
+ * leaves the vector as it was
+ ****************************************/
+template <class T>
+void mapped_vector <T> :: map(size_t length)
+{
+#ifdef _WIN32
+   // a mapping bigger than the file grows the file
+   HANDLE mappingNew = CreateFileMappingA(file, NULL, PAGE_READWRITE,
+                                          (DWORD)((unsigned long long)length >> 32),
+                                          (DWORD)(length & 0xffffffff), NULL);
+   if (mappingNew == NULL)
+      throw "std:runtime_error";
+   char * baseNew = (char *)MapViewOfFile(mappingNew, FILE_MAP_ALL_ACCESS, 0, 0, length);
+   if (baseNew == nullptr)
+   {
+      CloseHandle(mappingNew);
+      throw "std:runtime_error";
+   }
+   unmap();
+   mapping = mappingNew;
+#else
+   struct stat status;
+   if (fstat(file, &status) != 0)
+      throw "std:runtime_error";
+   if ((size_t)status.st_size < length && ftruncate(file, (off_t)length) != 0)
+      throw "std:runtime_error";
+   void * p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+   if (p == MAP_FAILED)
+      throw "std:runtime_error";
+   char * baseNew = (char *)p;
+   unmap();
+#endif
+   base = baseNew;
+   lengthMapped = length;
+}
+
+/*****************************************
+ * MAPPED VECTOR :: UNMAP
+ ****************************************/
+template <class T>
+void mapped_vector <T> :: unmap()
+{
+   if (base == nullptr)
+      return;
+#ifdef _WIN32
+   UnmapViewOfFile(base);
+   CloseHandle(mapping);
+   mapping = NULL;
+#else
+   munmap(base, lengthMapped);
+#endif
+   base = nullptr;
+   lengthMapped = 0;
+}
+
+}; // namespace custom
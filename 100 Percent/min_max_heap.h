@@ -0,0 +1,375 @@
+/***********************************************************************
+ * Header:
+ *    MIN MAX HEAP
+ * Summary:
+ *    A double-ended priority queue: both the biggest and the smallest
+ *    item can be read or removed in O(log n), from one copy of the data
+ *
+ *    This will contain the class definition of:
+ *        min_max_heap           : A double-ended Priority Queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <utility>      // for std::swap
+#include "vector.h"
+#include "bits.h"
+
+class TestMinMaxHeap;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * MIN MAX HEAP
+ * Atkinson's min-max heap. The tree has the same
+ * shape as a binary heap but the levels alternate:
+ * a node on an even level (the root is level 0) is
+ * no bigger than anything below it, a node on an odd
+ * level is no smaller. So the smallest item is the
+ * root and the biggest is one of its two children.
+ *************************************************/
+template<class T>
+class min_max_heap
+{
+   friend class ::TestMinMaxHeap; // give the unit test class access to the privates
+   template <class TT>
+   friend void swap(min_max_heap<TT>& lhs, min_max_heap<TT>& rhs);
+public:
+
+   //
+   // construct
+   //
+   min_max_heap()
+   {
+   }
+   min_max_heap(const min_max_heap &  rhs) : container(rhs.container)
+   {
+   }
+   min_max_heap(min_max_heap && rhs) : container(std::move(rhs.container))
+   {
+   }
+   template <class Iterator>
+   min_max_heap(Iterator first, Iterator last)
+   {
+      container.reserve(last - first);
+      for (auto it = first; it != last; it++)
+         container.push_back(*it);
+      heapify();
+   }
+   explicit min_max_heap(custom::vector<T> && rhs) : container(std::move(rhs))
+   {
+      heapify();
+   }
+   explicit min_max_heap(custom::vector<T> & rhs) : container(rhs)
+   {
+      heapify();
+   }
+
+   //
+   // Access
+   //
+   const T & top_max() const;
+   const T & top_min() const;
+
+   //
+   // Insert
+   //
+   void  push(const T& t);
+   void  push(T&& t);
+
+   //
+   // Remove
+   //
+   void  pop_max();
+   void  pop_min();
+
+   //
+   // Status
+   //
+   size_t size()  const
+   {
+      return container.size();
+   }
+   bool empty() const
+   {
+      return container.size() == 0;
+   }
+
+private:
+
+   void heapify();                        // turn the whole container into a min-max heap
+   size_t indexMax() const;               // where the biggest item lives
+
+   // move a hole through the heap, then drop value into it. Container indices
+   void bubbleUp(size_t indexHole, T && value);
+   void trickleDown(size_t indexHole, T && value);
+   template <bool isMin>
+   void trickleDown(size_t indexHole, T && value);
+   template <bool isMin>
+   void bubbleUpLevel(size_t indexHole, T && value);
+   template <bool isMin>
+   size_t indexExtremeDescendant(size_t index) const;
+
+   // on a min level a comes first if it is smaller, on a max level if it is bigger
+   template <bool isMin>
+   static bool before(const T & a, const T & b) { return isMin ? a < b : b < a; }
+
+   // navigate the heap. These are container indices
+   static bool   isMinLevel(size_t index)     { return bitWidth(index + 1) % 2 == 1; }
+   static size_t indexParent(size_t index)     { return (index - 1) / 2;  }
+   static size_t indexFirstChild(size_t index) { return index * 2 + 1;    }
+
+   custom::vector<T> container;
+};
+
+/************************************************
+ * MIN MAX HEAP :: TOP MIN
+ * The smallest item is always the root
+ ***********************************************/
+template <class T>
+const T & min_max_heap <T> :: top_min() const
+{
+   if (container.empty())
+      throw "std:out_of_range";
+   return container.front();
+}
+
+/************************************************
+ * MIN MAX HEAP :: TOP MAX
+ * The biggest item is one of the root's children,
+ * or the root itself if it has none
+ ***********************************************/
+template <class T>
+const T & min_max_heap <T> :: top_max() const
+{
+   if (container.empty())
+      throw "std:out_of_range";
+   return container[indexMax()];
+}
+
+/*****************************************
+ * MIN MAX HEAP :: PUSH
+ * Add a new element at the bottom and bubble it up
+ ****************************************/
+template <class T>
+void min_max_heap <T> :: push(const T & t)
+{
+   push(T(t));
+}
+template <class T>
+void min_max_heap <T> :: push(T && t)
+{
+   container.push_back(std::move(t));
+   T value(std::move(container.back()));
+   bubbleUp(container.size() - 1, std::move(value));
+}
+
+/**********************************************
+ * MIN MAX HEAP :: POP MIN
+ * Delete the root; the last item fills the hole
+ **********************************************/
+template <class T>
+void min_max_heap <T> :: pop_min()
+{
+   if (container.empty())
+      return;
+
+   T value(std::move(container.back()));
+   container.pop_back();
+   if (!container.empty())
+      trickleDown(0, std::move(value));
+}
+
+/**********************************************
+ * MIN MAX HEAP :: POP MAX
+ * Delete the biggest child of the root; the last
+ * item fills the hole
+ **********************************************/
+template <class T>
+void min_max_heap <T> :: pop_max()
+{
+   if (container.empty())
+      return;
+
+   size_t indexHole = indexMax();
+   T value(std::move(container.back()));
+   container.pop_back();
+   if (indexHole < container.size())
+      trickleDown(indexHole, std::move(value));
+}
+
+/************************************************
+ * MIN MAX HEAP :: INDEX MAX
+ * The root's bigger child, if it has any
+ ************************************************/
+template <class T>
+size_t min_max_heap <T> :: indexMax() const
+{
+   if (container.size() == 1)
+      return 0;
+   if (container.size() == 2 || container[2] < container[1])
+      return 1;
+   return 2;
+}
+
+/************************************************
+ * MIN MAX HEAP :: HEAPIFY
+ * Floyd's construction works here too: trickle
+ * every parent down, last one first, each by the
+ * rule of its own level
+ ************************************************/
+template <class T>
+void min_max_heap <T> :: heapify()
+{
+   if (container.size() < 2)
+      return;
+   for (size_t index = indexParent(container.size() - 1) + 1; index > 0; index--)
+   {
+      T value(std::move(container[index - 1]));
+      trickleDown(index - 1, std::move(value));
+   }
+}
+
+/************************************************
+ * MIN MAX HEAP :: BUBBLE UP
+ * The hole is at the bottom. Compare value with the
+ * parent once to learn whether it belongs with the
+ * min levels or the max levels, then climb those
+ * levels only: two at a time, grandparent to
+ * grandparent.
+ ************************************************/
+template <class T>
+void min_max_heap <T> :: bubbleUp(size_t indexHole, T && value)
+{
+   if (indexHole == 0)
+   {
+      container[indexHole] = std::move(value);
+      return;
+   }
+
+   size_t indexUp = indexParent(indexHole);
+   if (isMinLevel(indexHole))
+   {
+      if (container[indexUp] < value)
+      {
+         container[indexHole] = std::move(container[indexUp]);
+         bubbleUpLevel<false>(indexUp, std::move(value));
+      }
+      else
+         bubbleUpLevel<true>(indexHole, std::move(value));
+   }
+   else
+   {
+      if (value < container[indexUp])
+      {
+         container[indexHole] = std::move(container[indexUp]);
+         bubbleUpLevel<true>(indexUp, std::move(value));
+      }
+      else
+         bubbleUpLevel<false>(indexHole, std::move(value));
+   }
+}
+
+/************************************************
+ * MIN MAX HEAP :: BUBBLE UP LEVEL
+ * Move the hole up by grandparents while value
+ * comes before them
+ ************************************************/
+template <class T>
+template <bool isMin>
+void min_max_heap <T> :: bubbleUpLevel(size_t indexHole, T && value)
+{
+   while (indexHole > 2)
+   {
+      size_t indexGrand = indexParent(indexParent(indexHole));
+      if (!before<isMin>(value, container[indexGrand]))
+         break;
+      container[indexHole] = std::move(container[indexGrand]);
+      indexHole = indexGrand;
+   }
+   container[indexHole] = std::move(value);
+}
+
+/************************************************
+ * MIN MAX HEAP :: TRICKLE DOWN
+ * Fill the hole with value, by the rule of the
+ * level the hole is on
+ ************************************************/
+template <class T>
+void min_max_heap <T> :: trickleDown(size_t indexHole, T && value)
+{
+   if (isMinLevel(indexHole))
+      trickleDown<true>(indexHole, std::move(value));
+   else
+      trickleDown<false>(indexHole, std::move(value));
+}
+
+/************************************************
+ * MIN MAX HEAP :: TRICKLE DOWN
+ * Pull the first of the children and grandchildren
+ * into the hole while it comes before value. Stepping
+ * to a grandchild passes a node of the other kind of
+ * level, and value may be out of order with it: if so
+ * they trade places and the other one carries on down.
+ ************************************************/
+template <class T>
+template <bool isMin>
+void min_max_heap <T> :: trickleDown(size_t indexHole, T && value)
+{
+   while (indexFirstChild(indexHole) < container.size())
+   {
+      size_t indexFirst = indexExtremeDescendant<isMin>(indexHole);
+      if (!before<isMin>(container[indexFirst], value))
+         break;
+
+      bool isGrandchild = indexFirst >= indexFirstChild(indexFirstChild(indexHole));
+      container[indexHole] = std::move(container[indexFirst]);
+      indexHole = indexFirst;
+
+      // a child that comes first has no children of its own to pass
+      if (!isGrandchild)
+         break;
+
+      T & between = container[indexParent(indexHole)];
+      if (before<isMin>(between, value))
+         std::swap(between, value);
+   }
+   container[indexHole] = std::move(value);
+}
+
+/************************************************
+ * MIN MAX HEAP :: INDEX EXTREME DESCENDANT
+ * The first, by the rule of the level, of the
+ * children and grandchildren of a node which is
+ * known to have at least one child
+ ************************************************/
+template <class T>
+template <bool isMin>
+size_t min_max_heap <T> :: indexExtremeDescendant(size_t index) const
+{
+   size_t indexFirst = indexFirstChild(index);
+   size_t candidates[5] = { indexFirst + 1,
+                            indexFirstChild(indexFirst),     indexFirstChild(indexFirst) + 1,
+                            indexFirstChild(indexFirst + 1), indexFirstChild(indexFirst + 1) + 1 };
+   for (size_t candidate : candidates)
+      if (candidate < container.size() && before<isMin>(container[candidate], container[indexFirst]))
+         indexFirst = candidate;
+   return indexFirst;
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two min-max heaps
+ ************************************************/
+template <class T>
+inline void swap(custom::min_max_heap <T>& lhs,
+                 custom::min_max_heap <T>& rhs)
+{
+   lhs.container.swap(rhs.container);
+}
+
+}; // namespace custom
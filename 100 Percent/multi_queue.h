@@ -0,0 +1,255 @@
+/***********************************************************************
+ * Header:
+ *    MULTI QUEUE
+ * Summary:
+ *    A relaxed concurrent priority queue: pop gives one of the biggest
+ *    items, not always the biggest, and in exchange no operation ever
+ *    waits on a lock
+ *
+ *    This will contain the class definition of:
+ *        multi_queue            : A relaxed Priority Queue for many threads
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>       // for std::atomic
+#include <cassert>
+#include <functional>   // for std::hash
+#include <memory>       // for std::unique_ptr
+#include <mutex>        // for std::mutex
+#include <thread>       // for std::this_thread
+#include "priority_queue.h"
+
+class TestMultiQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * MULTI QUEUE
+ * The MultiQueue of Rihani, Sanders and Dementiev:
+ * c*P ordinary priority_queues, P being the number of
+ * threads, each behind its own lock.
+ *    push : into a random queue whose lock is free
+ *    pop  : look at the tops of numChoices random
+ *           queues whose locks are free, and pop the
+ *           biggest
+ * A busy lock is never waited on: some other queue is
+ * tried instead.
+ *
+ * The two knobs trade order for speed. More queues per
+ * thread means fewer collisions but items further from
+ * the true top; more choices means pops closer to the
+ * true top but more locks per pop. The expected rank
+ * of a pop, 0 being the biggest item, grows with the
+ * number of queues over the number of choices. With
+ * as many choices as queues every pop is exact.
+ *************************************************/
+template<class T>
+class multi_queue
+{
+   friend class ::TestMultiQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   multi_queue(size_t numThreads, size_t queuesPerThread = 2, size_t numChoices = 2);
+   multi_queue(const multi_queue &) = delete;
+   multi_queue & operator = (const multi_queue &) = delete;
+
+   //
+   // Insert
+   //
+   void  push(const T& t);
+   void  push(T&& t);
+
+   //
+   // Remove. Between threads, a top() would be stale by
+   // the time pop() came, so it is one call
+   //
+   bool  try_pop(T & t);
+
+   //
+   // Status. Only a snapshot while other threads are busy
+   //
+   size_t size()  const
+   {
+      return numElements.load();
+   }
+   bool empty() const
+   {
+      return size() == 0;
+   }
+
+private:
+
+   // padded, so threads on neighboring queues do not share a cache line
+   struct Queue
+   {
+      std::mutex                lock;
+      custom::priority_queue<T> heap;
+      char                      padding[64];
+   };
+
+   size_t random();                       // a random number for this thread
+   size_t lockRandom();                   // lock some queue and say which
+   bool   popAny(T & t);                  // sweep every free queue in turn to find an item
+
+   std::unique_ptr<Queue[]> queues;
+   size_t numQueues;
+   size_t numChoices;
+   std::atomic<size_t> numElements;
+};
+
+/************************************************
+ * MULTI QUEUE :: CONSTRUCTOR
+ ***********************************************/
+template <class T>
+multi_queue <T> :: multi_queue(size_t numThreads, size_t queuesPerThread, size_t numChoices) :
+   numElements(0)
+{
+   numQueues = (numThreads ? numThreads : 1) * (queuesPerThread ? queuesPerThread : 1);
+   if (numQueues < 2)
+      numQueues = 2;
+   this->numChoices = numChoices < 1 ? 1 : numChoices > numQueues ? numQueues : numChoices;
+   queues.reset(new Queue[numQueues]);
+}
+
+/*****************************************
+ * MULTI QUEUE :: PUSH
+ * Into whichever random queue is free
+ ****************************************/
+template <class T>
+void multi_queue <T> :: push(const T & t)
+{
+   push(T(t));
+}
+template <class T>
+void multi_queue <T> :: push(T && t)
+{
+   size_t i = lockRandom();
+   queues[i].heap.push(std::move(t));
+   numElements++;
+   queues[i].lock.unlock();
+}
+
+/**********************************************
+ * MULTI QUEUE :: TRY POP
+ * Lock a few random queues and take the biggest of
+ * their tops. If the queues picked were all empty,
+ * pick again; if that keeps happening the items are
+ * few and far between, so look through them all
+ **********************************************/
+template <class T>
+bool multi_queue <T> :: try_pop(T & t)
+{
+   for (size_t attempt = 0; attempt < numQueues * 4; attempt++)
+   {
+      if (numElements.load() == 0)
+         return false;
+
+      // pick the queues: all of them, or some at random
+      size_t chosen[64];
+      size_t numChosen = 0;
+      size_t numWanted = numChoices < 64 ? numChoices : 64;
+      for (size_t k = 0; numChosen < numWanted && k < numQueues; k++)
+      {
+         size_t i = numWanted == numQueues ? k : random() % numQueues;
+         bool isChosen = false;
+         for (size_t c = 0; c < numChosen; c++)
+            if (chosen[c] == i)
+               isChosen = true;
+         if (isChosen || !queues[i].lock.try_lock())
+            continue;
+         chosen[numChosen++] = i;
+      }
+
+      // the biggest top among them
+      size_t best = numQueues;
+      for (size_t c = 0; c < numChosen; c++)
+      {
+         const custom::priority_queue<T> & heap = queues[chosen[c]].heap;
+         if (!heap.empty() && (best == numQueues || queues[best].heap.top() < heap.top()))
+            best = chosen[c];
+      }
+      if (best != numQueues)
+      {
+         queues[best].heap.try_pop(t);
+         numElements--;
+      }
+      for (size_t c = 0; c < numChosen; c++)
+         queues[chosen[c]].lock.unlock();
+      if (best != numQueues)
+         return true;
+   }
+   return popAny(t);
+}
+
+/**********************************************
+ * MULTI QUEUE :: POP ANY
+ * Sweep every queue whose lock is free and take the
+ * first item found. A busy queue is skipped, and the
+ * sweep goes again until one finds every queue free
+ * and empty, or there is nothing left to find
+ **********************************************/
+template <class T>
+bool multi_queue <T> :: popAny(T & t)
+{
+   while (numElements.load() != 0)
+   {
+      bool isSkipped = false;
+      for (size_t i = 0; i < numQueues; i++)
+      {
+         if (!queues[i].lock.try_lock())
+         {
+            isSkipped = true;
+            continue;
+         }
+         bool isPopped = queues[i].heap.try_pop(t);
+         if (isPopped)
+            numElements--;
+         queues[i].lock.unlock();
+         if (isPopped)
+            return true;
+      }
+      if (!isSkipped)
+         return false;
+      std::this_thread::yield();
+   }
+   return false;
+}
+
+/**********************************************
+ * MULTI QUEUE :: LOCK RANDOM
+ * Try random queues until one of them is free
+ **********************************************/
+template <class T>
+size_t multi_queue <T> :: lockRandom()
+{
+   while (true)
+   {
+      size_t i = random() % numQueues;
+      if (queues[i].lock.try_lock())
+         return i;
+   }
+}
+
+/**********************************************
+ * MULTI QUEUE :: RANDOM
+ * xorshift64*, one state per thread
+ **********************************************/
+template <class T>
+size_t multi_queue <T> :: random()
+{
+   static thread_local unsigned long long state =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+   state ^= state >> 12;
+   state ^= state << 25;
+   state ^= state >> 27;
+   return (size_t)((state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+}; // namespace custom
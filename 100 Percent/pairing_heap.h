@@ -0,0 +1,495 @@
+/***********************************************************************
+ * Header:
+ *    PAIRING HEAP
+ * Summary:
+ *    A priority queue built from a heap-ordered tree rather than an
+ *    array, so two of them can be melded together in O(1)
+ *
+ *    This will contain the class definition of:
+ *        pairing_heap           : A Priority Queue that melds cheaply
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <new>      // for placement new
+#include "vector.h" // for the stack used when tearing down the tree
+
+class TestPairingHeap;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * PAIRING HEAP
+ * Same interface as priority_queue plus meld().
+ * Each node points to its first child and next
+ * sibling. Nodes are carved out of slabs, and each
+ * slab keeps its own free list of popped nodes, so
+ * push almost never calls the allocator.
+ *
+ * A heap owns every slab its nodes are in, and no
+ * other heap ever touches them. meld() hands the
+ * slabs of rhs over along with its nodes, so after a
+ * meld the two heaps still share nothing and can be
+ * used from different threads. A slab whose nodes
+ * have all been popped is given back, all but one
+ * kept spare for the next push, so a worker queue
+ * melded into a global one every tick does not leave
+ * a trail of slabs behind in the global one.
+ *************************************************/
+template<class T>
+class pairing_heap
+{
+   friend class ::TestPairingHeap; // give the unit test class access to the privates
+   template <class TT>
+   friend void swap(pairing_heap<TT>& lhs, pairing_heap<TT>& rhs);
+public:
+
+   //
+   // construct
+   //
+   pairing_heap() : pRoot(nullptr), numElements(0),
+      pRoomHead(nullptr), pRoomTail(nullptr), pSpare(nullptr), numSlabs(0)
+   {
+   }
+   pairing_heap(const pairing_heap & rhs) : pairing_heap()
+   {
+      *this = rhs;
+   }
+   pairing_heap(pairing_heap && rhs) : pairing_heap()
+   {
+      swap(rhs);
+   }
+  ~pairing_heap()
+   {
+      clear();
+      if (pSpare)
+         deleteSlab(pSpare);
+   }
+
+   //
+   // Assign
+   //
+   pairing_heap & operator = (const pairing_heap & rhs);
+   pairing_heap & operator = (pairing_heap && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(pairing_heap & rhs);
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   void  push(const T& t);
+   void  push(T&& t);
+   void  meld(pairing_heap & rhs);    // take all of rhs, leaving it empty
+
+   //
+   // Remove
+   //
+   void  pop();
+   void  clear();
+
+   //
+   // Status
+   //
+   size_t size()  const
+   {
+      return numElements;
+   }
+   bool empty() const
+   {
+      return numElements == 0;
+   }
+
+private:
+
+   struct Slab;
+
+   struct Node
+   {
+      template <class U>
+      Node(U && t) : data(std::forward<U>(t)), pChild(nullptr), pSibling(nullptr) {}
+      T      data;
+      Node * pChild;           // first child, the head of the child list
+      Node * pSibling;         // next sibling
+      Slab * pSlab;            // where the node was carved from
+   };
+
+   struct FreeNode             // what a node turns into once it is popped
+   {
+      FreeNode * pNext;
+   };
+
+   struct Slab
+   {
+      Slab *     pPrev;        // the list of slabs with room, if this has any
+      Slab *     pNext;
+      Node *     nodes;        // raw storage for numNodes nodes
+      size_t     numNodes;
+      size_t     numCarved;    // nodes handed out at least once
+      size_t     numLive;      // nodes holding an item now
+      FreeNode * pFree;        // popped nodes of this slab
+   };
+
+   template <class U>
+   Node * allocateNode(U && t);
+   void   freeNode(Node * pNode);
+   Slab * newSlab();
+   void   deleteSlab(Slab * pSlab);
+   void   linkRoom(Slab * pSlab);      // pSlab has room now
+   void   unlinkRoom(Slab * pSlab);    // pSlab is full, or about to go
+   static Node * link(Node * pLHS, Node * pRHS);
+
+   Node * pRoot;               // the biggest item
+   size_t numElements;
+
+   // the slabs. Full ones are found only through their nodes
+   Slab * pRoomHead;           // slabs with live nodes and room for more
+   Slab * pRoomTail;           // the last of them, so meld can splice in O(1)
+   Slab * pSpare;              // an empty slab kept for the next push
+   size_t numSlabs;            // every slab this heap owns, the spare included
+};
+
+/************************************************
+ * PAIRING HEAP :: ASSIGN
+ * Copy every item of rhs into this heap
+ ***********************************************/
+template <class T>
+pairing_heap <T> & pairing_heap <T> :: operator = (const pairing_heap & rhs)
+{
+   if (this == &rhs)
+      return *this;
+   clear();
+
+   custom::vector<Node *> stack;
+   if (rhs.pRoot)
+      stack.push_back(rhs.pRoot);
+   while (!stack.empty())
+   {
+      Node * pNode = stack.back();
+      stack.pop_back();
+      push(pNode->data);
+      if (pNode->pChild)
+         stack.push_back(pNode->pChild);
+      if (pNode->pSibling)
+         stack.push_back(pNode->pSibling);
+   }
+   return *this;
+}
+
+/************************************************
+ * PAIRING HEAP :: SWAP
+ * Exchange everything, pool included
+ ***********************************************/
+template <class T>
+void pairing_heap <T> :: swap(pairing_heap & rhs)
+{
+   std::swap(pRoot,        rhs.pRoot);
+   std::swap(numElements,  rhs.numElements);
+   std::swap(pRoomHead,    rhs.pRoomHead);
+   std::swap(pRoomTail,    rhs.pRoomTail);
+   std::swap(pSpare,       rhs.pSpare);
+   std::swap(numSlabs,     rhs.numSlabs);
+}
+
+/************************************************
+ * PAIRING HEAP :: TOP
+ * Get the maximum item from the heap: the top item.
+ ***********************************************/
+template <class T>
+const T & pairing_heap <T> :: top() const
+{
+   if (nullptr == pRoot)
+      throw "std:out_of_range";
+   return pRoot->data;
+}
+
+/*****************************************
+ * PAIRING HEAP :: PUSH
+ * A new item is a one-node tree linked with the root
+ ****************************************/
+template <class T>
+void pairing_heap <T> :: push(const T & t)
+{
+   Node * pNode = allocateNode(t);
+   pRoot = pRoot ? link(pRoot, pNode) : pNode;
+   numElements++;
+}
+template <class T>
+void pairing_heap <T> :: push(T && t)
+{
+   Node * pNode = allocateNode(std::move(t));
+   pRoot = pRoot ? link(pRoot, pNode) : pNode;
+   numElements++;
+}
+
+/*****************************************
+ * PAIRING HEAP :: MELD
+ * Link the two roots and take over every slab of rhs
+ * that holds a node: those with room are spliced onto
+ * our list, the full ones come along with their
+ * nodes. rhs keeps its spare, which is empty, so it
+ * has somewhere to push next without the allocator.
+ ****************************************/
+template <class T>
+void pairing_heap <T> :: meld(pairing_heap & rhs)
+{
+   if (this == &rhs || nullptr == rhs.pRoot)
+      return;
+
+   pRoot = pRoot ? link(pRoot, rhs.pRoot) : rhs.pRoot;
+   numElements += rhs.numElements;
+
+   if (rhs.pRoomHead)
+   {
+      rhs.pRoomHead->pPrev = pRoomTail;
+      if (pRoomTail)
+         pRoomTail->pNext = rhs.pRoomHead;
+      else
+         pRoomHead = rhs.pRoomHead;
+      pRoomTail = rhs.pRoomTail;
+   }
+   size_t numSpare = rhs.pSpare ? 1 : 0;
+   numSlabs += rhs.numSlabs - numSpare;
+
+   rhs.pRoot       = nullptr;
+   rhs.numElements = 0;
+   rhs.pRoomHead   = nullptr;
+   rhs.pRoomTail   = nullptr;
+   rhs.numSlabs    = numSpare;
+}
+
+/**********************************************
+ * PAIRING HEAP :: POP
+ * Delete the top item from the heap. The children
+ * of the root are linked in pairs from left to right
+ * and the pairs are then linked from right to left.
+ **********************************************/
+template <class T>
+void pairing_heap <T> :: pop()
+{
+   if (nullptr == pRoot)
+      return;
+
+   Node * pFirst = pRoot->pChild;
+   freeNode(pRoot);
+   numElements--;
+
+   // first pass: link neighbors, stacking the results in reverse order
+   Node * pPaired = nullptr;
+   while (pFirst)
+   {
+      Node * pLHS = pFirst;
+      Node * pRHS = pLHS->pSibling;
+      if (nullptr == pRHS)
+      {
+         pLHS->pSibling = pPaired;
+         pPaired = pLHS;
+         break;
+      }
+      pFirst = pRHS->pSibling;
+      pLHS->pSibling = pRHS->pSibling = nullptr;
+      Node * pLink = link(pLHS, pRHS);
+      pLink->pSibling = pPaired;
+      pPaired = pLink;
+   }
+
+   // second pass: fold the pairs into one tree, last pair first
+   pRoot = nullptr;
+   while (pPaired)
+   {
+      Node * pNext = pPaired->pSibling;
+      pPaired->pSibling = nullptr;
+      pRoot = pRoot ? link(pRoot, pPaired) : pPaired;
+      pPaired = pNext;
+   }
+}
+
+/**********************************************
+ * PAIRING HEAP :: CLEAR
+ * Destroy every item. One empty slab is kept spare
+ **********************************************/
+template <class T>
+void pairing_heap <T> :: clear()
+{
+   custom::vector<Node *> stack;
+   if (pRoot)
+      stack.push_back(pRoot);
+   while (!stack.empty())
+   {
+      Node * pNode = stack.back();
+      stack.pop_back();
+      if (pNode->pChild)
+         stack.push_back(pNode->pChild);
+      if (pNode->pSibling)
+         stack.push_back(pNode->pSibling);
+      freeNode(pNode);
+   }
+   pRoot = nullptr;
+   numElements = 0;
+}
+
+/**********************************************
+ * PAIRING HEAP :: LINK
+ * Make the smaller root the first child of the bigger
+ **********************************************/
+template <class T>
+typename pairing_heap <T> :: Node * pairing_heap <T> :: link(Node * pLHS, Node * pRHS)
+{
+   if (pLHS->data < pRHS->data)
+      std::swap(pLHS, pRHS);
+   pRHS->pSibling = pLHS->pChild;
+   pLHS->pChild = pRHS;
+   return pLHS;
+}
+
+/**********************************************
+ * PAIRING HEAP :: ALLOCATE NODE
+ * Take a node from the first slab with room: one of
+ * its popped nodes, or a fresh one. With no slab
+ * with room, start on the spare, or only then go to
+ * the allocator for a new slab.
+ **********************************************/
+template <class T>
+template <class U>
+typename pairing_heap <T> :: Node * pairing_heap <T> :: allocateNode(U && t)
+{
+   if (nullptr == pRoomHead)
+   {
+      Slab * pSlab = pSpare ? pSpare : newSlab();
+      pSpare = nullptr;
+      linkRoom(pSlab);
+   }
+
+   // construct before taking the node, in case the item throws
+   Slab * pSlab = pRoomHead;
+   void * pMemory = pSlab->pFree ? (void *)pSlab->pFree : (void *)(pSlab->nodes + pSlab->numCarved);
+   Node * pNode = new (pMemory) Node(std::forward<U>(t));
+   pNode->pSlab = pSlab;
+
+   if (pMemory == (void *)pSlab->pFree)
+      pSlab->pFree = pSlab->pFree->pNext;
+   else
+      pSlab->numCarved++;
+   pSlab->numLive++;
+   if (nullptr == pSlab->pFree && pSlab->numCarved == pSlab->numNodes)
+      unlinkRoom(pSlab);
+   return pNode;
+}
+
+/**********************************************
+ * PAIRING HEAP :: FREE NODE
+ * Destroy the item and put the node on its slab's
+ * free list. A slab left with no live nodes becomes
+ * the spare, or is given back if there already is one
+ **********************************************/
+template <class T>
+void pairing_heap <T> :: freeNode(Node * pNode)
+{
+   Slab * pSlab = pNode->pSlab;
+   bool isFull = nullptr == pSlab->pFree && pSlab->numCarved == pSlab->numNodes;
+   pNode->~Node();
+   pSlab->pFree = new (static_cast<void *>(pNode)) FreeNode{pSlab->pFree};
+   pSlab->numLive--;
+   if (isFull)
+      linkRoom(pSlab);
+
+   if (pSlab->numLive == 0)
+   {
+      unlinkRoom(pSlab);
+      if (pSpare)
+         deleteSlab(pSlab);
+      else
+      {
+         pSlab->pFree = nullptr;
+         pSlab->numCarved = 0;
+         pSpare = pSlab;
+      }
+   }
+}
+
+/**********************************************
+ * PAIRING HEAP :: NEW SLAB
+ * Big enough for as many nodes again as the heap
+ * holds, so slabs grow with the heap, within limits
+ **********************************************/
+template <class T>
+typename pairing_heap <T> :: Slab * pairing_heap <T> :: newSlab()
+{
+   size_t numNodes = numElements < 16 ? 16 : numElements > 4096 ? 4096 : numElements;
+   Slab * pSlab = new Slab;
+   pSlab->nodes = static_cast<Node *>(::operator new(numNodes * sizeof(Node)));
+   pSlab->pPrev = pSlab->pNext = nullptr;
+   pSlab->numNodes  = numNodes;
+   pSlab->numCarved = 0;
+   pSlab->numLive   = 0;
+   pSlab->pFree     = nullptr;
+   numSlabs++;
+   return pSlab;
+}
+
+/**********************************************
+ * PAIRING HEAP :: DELETE SLAB
+ * No live nodes allowed
+ **********************************************/
+template <class T>
+void pairing_heap <T> :: deleteSlab(Slab * pSlab)
+{
+   assert(pSlab->numLive == 0);
+   ::operator delete(pSlab->nodes);
+   delete pSlab;
+   numSlabs--;
+}
+
+/**********************************************
+ * PAIRING HEAP :: LINK ROOM / UNLINK ROOM
+ * Keep the list of slabs with room up to date
+ **********************************************/
+template <class T>
+void pairing_heap <T> :: linkRoom(Slab * pSlab)
+{
+   pSlab->pPrev = nullptr;
+   pSlab->pNext = pRoomHead;
+   if (pRoomHead)
+      pRoomHead->pPrev = pSlab;
+   else
+      pRoomTail = pSlab;
+   pRoomHead = pSlab;
+}
+template <class T>
+void pairing_heap <T> :: unlinkRoom(Slab * pSlab)
+{
+   if (pSlab->pPrev)
+      pSlab->pPrev->pNext = pSlab->pNext;
+   else
+      pRoomHead = pSlab->pNext;
+   if (pSlab->pNext)
+      pSlab->pNext->pPrev = pSlab->pPrev;
+   else
+      pRoomTail = pSlab->pPrev;
+   pSlab->pPrev = pSlab->pNext = nullptr;
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two pairing heaps
+ ************************************************/
+template <class T>
+inline void swap(custom::pairing_heap <T>& lhs,
+                 custom::pairing_heap <T>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}; // namespace custom
@@ -0,0 +1,246 @@
+/***********************************************************************
+ * Header:
+ *    PERSISTENT PRIORITY QUEUE
+ * Summary:
+ *    A priority queue kept in a memory-mapped file. After a crash or a
+ *    restart, opening the file again gives back the heap as it was,
+ *    with nothing to rebuild
+ *
+ *    This will contain the class definition of:
+ *        persistent_priority_queue : A file-backed Priority Queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>       // for std::atomic_signal_fence
+#include <cassert>
+#include <string>
+#include "mapped_vector.h"
+
+class TestPersistentPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * PERSISTENT P QUEUE
+ * A binary max-heap in a mapped_vector. The sifts
+ * move a hole, so the heap is in order after every
+ * single store; what a crash can leave behind is an
+ * item copied into the hole and the moving item not
+ * yet placed. So each push or pop first writes the
+ * moving item and the hole into the file's journal,
+ * keeps the hole there up to date, and clears it
+ * when done. Opening the file finishes any push or
+ * pop the journal says was under way.
+ *************************************************/
+template<class T>
+class persistent_priority_queue
+{
+   friend class ::TestPersistentPQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   explicit persistent_priority_queue(const std::string & path) : container(path)
+   {
+      recover();
+   }
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   void  push(const T& t);
+
+   //
+   // Remove
+   //
+   void  pop();
+
+   //
+   // Status
+   //
+   size_t size()  const
+   {
+      return container.size();
+   }
+   bool empty() const
+   {
+      return container.size() == 0;
+   }
+
+   // make sure the file on disk has everything so far
+   void sync()
+   {
+      container.sync();
+   }
+
+private:
+
+   enum { OP_NONE = 0, OP_PUSH = 1, OP_POP = 2 };
+
+   void recover();              // finish whatever the journal says was going on
+   void siftUp();               // move the journal's hole up to where its item fits
+   void siftDown();             // move the journal's hole down to where its item fits
+
+   // the stores before this must reach the file before the ones after
+   static void order()
+   {
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+   }
+
+   static size_t indexParent(size_t index)     { return (index - 1) / 2; }
+   static size_t indexFirstChild(size_t index) { return index * 2 + 1;   }
+
+   custom::mapped_vector<T> container;
+};
+
+/************************************************
+ * PERSISTENT P QUEUE :: TOP
+ * Get the maximum item from the heap: the top item.
+ ***********************************************/
+template <class T>
+const T & persistent_priority_queue <T> :: top() const
+{
+   if (container.empty())
+      throw "std:out_of_range";
+   return container.front();
+}
+
+/*****************************************
+ * PERSISTENT P QUEUE :: PUSH
+ * Journal the new item and the new slot, and only
+ * then make the heap bigger
+ ****************************************/
+template <class T>
+void persistent_priority_queue <T> :: push(const T & t)
+{
+   if (container.size() == container.capacity())
+   {
+      T copy(t);    // t may be in the mapping about to move
+      container.reserve(container.capacity() ? container.capacity() * 2 : 16);
+      container.journalItem() = copy;
+   }
+   else
+      container.journalItem() = t;
+
+   typename mapped_vector<T>::Journal & journal = container.journal();
+   journal.index = container.size();
+   journal.size = container.size() + 1;
+   order();
+   journal.op = OP_PUSH;
+   order();
+   container.resize((size_t)journal.size);
+   order();
+   siftUp();
+}
+
+/**********************************************
+ * PERSISTENT P QUEUE :: POP
+ * Journal the last item and the hole at the top,
+ * and only then make the heap smaller
+ **********************************************/
+template <class T>
+void persistent_priority_queue <T> :: pop()
+{
+   if (container.empty())
+      return;
+   if (container.size() == 1)
+   {
+      container.pop_back();
+      return;
+   }
+
+   typename mapped_vector<T>::Journal & journal = container.journal();
+   container.journalItem() = container.back();
+   journal.index = 0;
+   journal.size = container.size() - 1;
+   order();
+   journal.op = OP_POP;
+   order();
+   container.resize((size_t)journal.size);
+   order();
+   siftDown();
+}
+
+/**********************************************
+ * PERSISTENT P QUEUE :: RECOVER
+ * Every step of a sift can be done twice, so just
+ * carry on from the hole the journal remembers
+ **********************************************/
+template <class T>
+void persistent_priority_queue <T> :: recover()
+{
+   typename mapped_vector<T>::Journal & journal = container.journal();
+   if (journal.op == OP_NONE)
+      return;
+
+   container.resize((size_t)journal.size);
+   if (journal.op == OP_PUSH)
+      siftUp();
+   else
+      siftDown();
+}
+
+/************************************************
+ * PERSISTENT P QUEUE :: SIFT UP
+ * Pull smaller parents down into the hole, noting
+ * each new place of the hole in the journal
+ ************************************************/
+template <class T>
+void persistent_priority_queue <T> :: siftUp()
+{
+   typename mapped_vector<T>::Journal & journal = container.journal();
+   const T & value = container.journalItem();
+   size_t indexHole = (size_t)journal.index;
+   while (indexHole != 0 && container[indexParent(indexHole)] < value)
+   {
+      container[indexHole] = container[indexParent(indexHole)];
+      order();
+      indexHole = indexParent(indexHole);
+      journal.index = indexHole;
+      order();
+   }
+   container[indexHole] = value;
+   order();
+   journal.op = OP_NONE;
+}
+
+/************************************************
+ * PERSISTENT P QUEUE :: SIFT DOWN
+ * Pull bigger children up into the hole, noting
+ * each new place of the hole in the journal
+ ************************************************/
+template <class T>
+void persistent_priority_queue <T> :: siftDown()
+{
+   typename mapped_vector<T>::Journal & journal = container.journal();
+   const T & value = container.journalItem();
+   size_t indexHole = (size_t)journal.index;
+   while (indexFirstChild(indexHole) < container.size())
+   {
+      size_t indexBigger = indexFirstChild(indexHole);
+      if (indexBigger + 1 < container.size() && container[indexBigger] < container[indexBigger + 1])
+         indexBigger++;
+      if (!(value < container[indexBigger]))
+         break;
+      container[indexHole] = container[indexBigger];
+      order();
+      indexHole = indexBigger;
+      journal.index = indexHole;
+      order();
+   }
+   container[indexHole] = value;
+   order();
+   journal.op = OP_NONE;
+}
+
+}; // namespace custom
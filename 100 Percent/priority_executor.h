@@ -0,0 +1,344 @@
+/***********************************************************************
+ * Header:
+ *    PRIORITY EXECUTOR
+ * Summary:
+ *    A thread pool that runs the most important task first. Each
+ *    worker keeps its own priority queue of tasks; a worker with
+ *    nothing to do steals from the others
+ *
+ *    This will contain the class definition of:
+ *        priority_executor      : A work-stealing pool of worker threads
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>                // for std::atomic
+#include <cassert>
+#include <condition_variable>    // for std::condition_variable
+#include <functional>            // for std::function, std::hash
+#include <future>                // for std::future, std::packaged_task
+#include <iterator>              // for std::make_move_iterator
+#include <memory>                // for std::unique_ptr, std::shared_ptr
+#include <mutex>                 // for std::mutex
+#include <thread>                // for std::thread
+#include "priority_queue.h"
+#include "vector.h"
+
+class TestPriorityExecutor;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * PRIORITY EXECUTOR
+ * One priority_queue of tasks per worker. A task
+ * submitted from a worker goes on that worker's own
+ * queue, so a task that forks keeps its children
+ * close; from anywhere else it goes to the workers in
+ * turn. A worker runs the top of its own queue.
+ *
+ * When its queue is empty, a worker steals: it picks
+ * a victim at random and, holding both their locks,
+ * moves the top half of the victim's heap into its
+ * own as one batch. No task is ever between heaps
+ * where another idle worker could not find it, so a
+ * count of pending tasks always means one to take.
+ * Taking the top half rather than one task means the
+ * thief has the most important work and the next
+ * steal is far off.
+ *
+ * With no work anywhere the workers sleep. shutdown()
+ * is graceful: no new tasks from outside, but every
+ * task already submitted runs, including any they
+ * submit themselves, before the workers stop. A task
+ * cannot call it, since its worker would be waiting
+ * for itself to finish.
+ *************************************************/
+class priority_executor
+{
+   friend class ::TestPriorityExecutor; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   explicit priority_executor(size_t numWorkers = std::thread::hardware_concurrency());
+   priority_executor(const priority_executor &) = delete;
+   priority_executor & operator = (const priority_executor &) = delete;
+   ~priority_executor()
+   {
+      shutdown();
+   }
+
+   //
+   // Insert. The bigger the priority, the sooner it runs;
+   // equal priorities run in the order submitted
+   //
+   template <class Function>
+   auto submit(int priority, Function && f) -> std::future<decltype(f())>;
+
+   //
+   // Stop. Waits for every task to finish, so not from a task
+   //
+   void shutdown();
+
+   //
+   // Status
+   //
+   size_t size() const
+   {
+      return numWorkers;
+   }
+
+private:
+
+   struct Task
+   {
+      int                   priority;
+      unsigned long long    sequence;
+      std::function<void()> run;
+      Task() : priority(0), sequence(0) {}
+      Task(int priority, unsigned long long sequence, std::function<void()> && run) :
+         priority(priority), sequence(sequence), run(std::move(run)) {}
+
+      // lower priority is less; so is younger, at equal priority
+      bool operator < (const Task & rhs) const
+      {
+         return priority < rhs.priority ||
+                (priority == rhs.priority && sequence > rhs.sequence);
+      }
+   };
+
+   struct Worker
+   {
+      std::mutex                   lock;
+      custom::priority_queue<Task> heap;
+      std::thread                  thread;
+   };
+
+   // the worker this thread is, if any
+   struct Current
+   {
+      priority_executor * pool;
+      size_t              index;
+   };
+   static Current & current()
+   {
+      static thread_local Current c = { nullptr, 0 };
+      return c;
+   }
+
+   void work(size_t index);                  // the life of a worker
+   bool takeLocal(size_t index, Task & task);
+   bool steal(size_t index, Task & task);
+   void finish();                            // a task is done
+   size_t random();
+
+   std::unique_ptr<Worker[]> workers;
+   size_t                    numWorkers;
+   std::atomic<size_t>       indexNext;      // where the next outside task goes
+   std::atomic<unsigned long long> sequenceNext;
+   std::atomic<size_t>       numPending;     // tasks in some queue
+   std::atomic<size_t>       numUnfinished;  // tasks in some queue or running
+   std::atomic<size_t>       numSleeping;
+   std::atomic<bool>         isStopping;
+   std::mutex                lockIdle;
+   std::condition_variable   idle;
+   bool                      isJoined;       // guarded by lockIdle
+};
+
+/************************************************
+ * PRIORITY EXECUTOR :: CONSTRUCTOR
+ ***********************************************/
+inline priority_executor :: priority_executor(size_t numWorkers) :
+   numWorkers(numWorkers ? numWorkers : 1), indexNext(0), sequenceNext(0),
+   numPending(0), numUnfinished(0), numSleeping(0), isStopping(false), isJoined(false)
+{
+   workers.reset(new Worker[this->numWorkers]);
+   for (size_t i = 0; i < this->numWorkers; i++)
+      workers[i].thread = std::thread(&priority_executor::work, this, i);
+}
+
+/*****************************************
+ * PRIORITY EXECUTOR :: SUBMIT
+ * Wrap the callable so its result or exception ends
+ * up in the future, and queue it
+ ****************************************/
+template <class Function>
+auto priority_executor :: submit(int priority, Function && f) -> std::future<decltype(f())>
+{
+   typedef decltype(f()) R;
+   bool isWorker = current().pool == this;
+
+   // counted first, so shutdown cannot miss it
+   numUnfinished++;
+   if (isStopping && !isWorker)
+   {
+      finish();
+      throw "std:runtime_error";
+   }
+
+   std::shared_ptr<std::packaged_task<R()>> task =
+      std::make_shared<std::packaged_task<R()>>(std::forward<Function>(f));
+   std::future<R> future = task->get_future();
+
+   size_t index = isWorker ? current().index : indexNext++ % numWorkers;
+   {
+      std::lock_guard<std::mutex> guard(workers[index].lock);
+      workers[index].heap.push(Task(priority, sequenceNext++, [task]() { (*task)(); }));
+   }
+   numPending++;
+
+   if (numSleeping > 0)
+   {
+      std::lock_guard<std::mutex> guard(lockIdle);
+      idle.notify_one();
+   }
+   return future;
+}
+
+/**********************************************
+ * PRIORITY EXECUTOR :: SHUTDOWN
+ * Let the workers run dry, then join them
+ **********************************************/
+inline void priority_executor :: shutdown()
+{
+   if (current().pool == this)
+      throw "std:runtime_error";
+   {
+      std::lock_guard<std::mutex> guard(lockIdle);
+      if (isJoined)
+         return;
+      isJoined = true;
+      isStopping = true;
+      idle.notify_all();
+   }
+   for (size_t i = 0; i < numWorkers; i++)
+      if (workers[i].thread.joinable())
+         workers[i].thread.join();
+}
+
+/**********************************************
+ * PRIORITY EXECUTOR :: WORK
+ * Run our own tasks, then stolen ones, and sleep when
+ * there are none. Sleeping is announced before the
+ * last look, so a submit either sees the sleeper or
+ * the sleeper sees the task. A task pending that we
+ * just missed is being taken by its owner or by
+ * another thief: let them run before looking again
+ **********************************************/
+inline void priority_executor :: work(size_t index)
+{
+   current().pool = this;
+   current().index = index;
+
+   Task task;
+   while (true)
+   {
+      if (takeLocal(index, task) || steal(index, task))
+      {
+         task.run();
+         task.run = nullptr;
+         finish();
+         continue;
+      }
+
+      std::unique_lock<std::mutex> guard(lockIdle);
+      numSleeping++;
+      bool isSlept = false;
+      while (numPending == 0 && !(isStopping && numUnfinished == 0))
+      {
+         idle.wait(guard);
+         isSlept = true;
+      }
+      numSleeping--;
+      if (numPending == 0 && isStopping && numUnfinished == 0)
+         return;
+      if (!isSlept)
+      {
+         guard.unlock();
+         std::this_thread::yield();
+      }
+   }
+}
+
+/**********************************************
+ * PRIORITY EXECUTOR :: TAKE LOCAL
+ **********************************************/
+inline bool priority_executor :: takeLocal(size_t index, Task & task)
+{
+   std::lock_guard<std::mutex> guard(workers[index].lock);
+   if (!workers[index].heap.try_pop(task))
+      return false;
+   numPending--;
+   return true;
+}
+
+/**********************************************
+ * PRIORITY EXECUTOR :: STEAL
+ * Take the top half of the first victim that has
+ * anything, starting at a random one. The biggest is
+ * run now, the rest go on our own heap in the same
+ * step, with both locks held, taken together so two
+ * thieves robbing each other cannot deadlock
+ **********************************************/
+inline bool priority_executor :: steal(size_t index, Task & task)
+{
+   Worker & thief = workers[index];
+   custom::vector<Task> loot;
+   size_t start = random() % numWorkers;
+   for (size_t k = 0; k < numWorkers; k++)
+   {
+      Worker & victim = workers[(start + k) % numWorkers];
+      if (&victim == &thief)
+         continue;
+      std::unique_lock<std::mutex> guardVictim(victim.lock, std::defer_lock);
+      std::unique_lock<std::mutex> guardThief(thief.lock, std::defer_lock);
+      std::lock(guardVictim, guardThief);
+      if (victim.heap.empty())
+         continue;
+
+      size_t numTake = (victim.heap.size() + 1) / 2;
+      loot.reserve(numTake);
+      for (size_t i = 0; i < numTake; i++)
+         victim.heap.try_pop_into(loot);
+      task = std::move(loot[0]);
+      if (loot.size() > 1)
+         thief.heap.push(std::make_move_iterator(&loot[0] + 1),
+                         std::make_move_iterator(&loot[0] + loot.size()));
+      numPending--;
+      return true;
+   }
+   return false;
+}
+
+/**********************************************
+ * PRIORITY EXECUTOR :: FINISH
+ * The last task of a shutdown lets the workers go
+ **********************************************/
+inline void priority_executor :: finish()
+{
+   if (--numUnfinished == 0 && isStopping)
+   {
+      std::lock_guard<std::mutex> guard(lockIdle);
+      idle.notify_all();
+   }
+}
+
+/**********************************************
+ * PRIORITY EXECUTOR :: RANDOM
+ * xorshift64*, one state per thread
+ **********************************************/
+inline size_t priority_executor :: random()
+{
+   static thread_local unsigned long long state =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+   state ^= state >> 12;
+   state ^= state << 25;
+   state ^= state >> 27;
+   return (size_t)((state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+}; // namespace custom
@@ -19,8 +19,12 @@
 #pragma once
 
 #include <cassert>
+#include <functional>   // for std::less
+#include <memory>       // for std::uses_allocator
 #include "vector.h"
 #include <string>
+#include <type_traits>  // for std::is_same, std::enable_if
+#include <utility>      // for std::swap
 
 class TestPQueue;    // forward declaration for unit test class
 
@@ -31,47 +35,233 @@ class TestPQueue;    // forward declaration for unit test class
 namespace custom
 {
 
+/*************************************************
+ * POP POLICIES
+ * How pop() refills the hole left by the top item.
+ *    pop_classic   : sift the last item down from the
+ *                    top, two compares per level
+ *    pop_bottom_up : walk the hole to a leaf along the
+ *                    biggest children, one compare per
+ *                    level, then sift the last item up.
+ *                    Pays off when operator< is costly
+ *************************************************/
+struct pop_classic   {};
+struct pop_bottom_up {};
+
+/*************************************************
+ * LAYOUTS
+ * Where each node of the heap lives in the container.
+ *    layout_flat    : breadth first, the children of
+ *                     i are i*Arity+1 onwards. Every
+ *                     level of a sift is a new cache
+ *                     line once the heap is big
+ *    layout_blocked : the tree is cut into complete
+ *                     subtrees of Height levels, each
+ *                     stored in one run of the container.
+ *                     A sift then touches one block per
+ *                     Height levels, so pick Height to
+ *                     fill a cache line or a page
+ * Either way the nodes fill the container from the
+ * front with no gaps, and a parent always comes
+ * before its children.
+ *************************************************/
+struct layout_flat
+{
+   template <size_t Arity>
+   static size_t parent(size_t index)           { return (index - 1) / Arity;     }
+   template <size_t Arity>
+   static size_t child(size_t index, size_t k)  { return index * Arity + 1 + k;   }
+};
+
+template <size_t Height>
+struct layout_blocked
+{
+   static_assert(Height >= 2, "a block needs at least two levels");
+
+   // a block has numLeaves(), each with Arity child blocks hanging off it
+   template <size_t Arity>
+   static constexpr size_t numLeaves(size_t levels = Height)
+   {
+      return levels == 1 ? 1 : Arity * numLeaves<Arity>(levels - 1);
+   }
+   template <size_t Arity>
+   static constexpr size_t numNodes()  { return (Arity * numLeaves<Arity>() - 1) / (Arity - 1); }
+   template <size_t Arity>
+   static constexpr size_t numFanout() { return Arity * numLeaves<Arity>(); }
+
+   template <size_t Arity>
+   static size_t parent(size_t index)
+   {
+      size_t block = index / numNodes<Arity>();
+      size_t local = index % numNodes<Arity>();
+      if (local != 0)
+         return block * numNodes<Arity>() + (local - 1) / Arity;
+
+      // the root of a block hangs off a leaf of its parent block
+      size_t blockParent = (block - 1) / numFanout<Arity>();
+      size_t leaf        = (block - 1) % numFanout<Arity>() / Arity;
+      return blockParent * numNodes<Arity>() + numNodes<Arity>() - numLeaves<Arity>() + leaf;
+   }
+   template <size_t Arity>
+   static size_t child(size_t index, size_t k)
+   {
+      size_t block = index / numNodes<Arity>();
+      size_t local = index % numNodes<Arity>();
+      if (local < numNodes<Arity>() - numLeaves<Arity>())
+         return block * numNodes<Arity>() + local * Arity + 1 + k;
+
+      // the children of a leaf are the roots of child blocks
+      size_t leaf = local - (numNodes<Arity>() - numLeaves<Arity>());
+      return (block * numFanout<Arity>() + 1 + leaf * Arity + k) * numNodes<Arity>();
+   }
+};
+
+/*************************************************
+ * HEAP SIFT
+ * The hole-based sift loops, apart from where the
+ * nodes are kept. A sift lifts one value out, moves
+ * the hole it leaves through the tree one node per
+ * level, then places the value in the hole at the
+ * end. Heap is whatever holds the nodes; it says how
+ * many there are and how to compare and move them:
+ *    size()                : number of nodes
+ *    lessNodes(i, j)       : node i is the lesser
+ *    lessValueNode(v, i)   : v is less than node i
+ *    lessNodeValue(i, v)   : node i is less than v
+ *    moveTo(to, from)      : node from fills the hole
+ *    place(index, v)       : v fills the hole
+ * priority_queue keeps only items; a heap that also
+ * tracks where each item is, like the addressable
+ * queue, does its bookkeeping in moveTo and place.
+ *************************************************/
+template <size_t Arity, class Layout>
+struct heap_sift
+{
+   static size_t parent(size_t index)          { return Layout::template parent<Arity>(index);  }
+   static size_t child(size_t index, size_t k) { return Layout::template child<Arity>(index, k); }
+
+   // the biggest child of a node which is known to have one
+   template <class Heap>
+   static size_t biggestChild(const Heap & heap, size_t index)
+   {
+      size_t indexBigger = child(index, 0);
+      for (size_t k = 1; k < Arity; k++)
+      {
+         size_t indexChild = child(index, k);
+         if (indexChild >= heap.size())
+            break;
+         if (heap.lessNodes(indexBigger, indexChild))
+            indexBigger = indexChild;
+      }
+      return indexBigger;
+   }
+
+   // pull bigger children up into the hole until value fits
+   template <class Heap, class Value>
+   static void down(Heap & heap, size_t indexHole, Value && value)
+   {
+      while (child(indexHole, 0) < heap.size())
+      {
+         size_t indexBigger = biggestChild(heap, indexHole);
+         if (!heap.lessValueNode(value, indexBigger))
+            break;
+         heap.moveTo(indexHole, indexBigger);
+         indexHole = indexBigger;
+      }
+      heap.place(indexHole, std::forward<Value>(value));
+   }
+
+   // push smaller parents down into the hole until value fits
+   template <class Heap, class Value>
+   static void up(Heap & heap, size_t indexHole, Value && value)
+   {
+      while (indexHole != 0 && heap.lessNodeValue(parent(indexHole), value))
+      {
+         heap.moveTo(indexHole, parent(indexHole));
+         indexHole = parent(indexHole);
+      }
+      heap.place(indexHole, std::forward<Value>(value));
+   }
+
+   // take the hole to a leaf along the biggest children, without
+   // a value to compare against. Returns where the hole ends up
+   template <class Heap>
+   static size_t toLeaf(Heap & heap, size_t indexHole)
+   {
+      while (child(indexHole, 0) < heap.size())
+      {
+         size_t indexBigger = biggestChild(heap, indexHole);
+         heap.moveTo(indexHole, indexBigger);
+         indexHole = indexBigger;
+      }
+      return indexHole;
+   }
+};
+
 /*************************************************
  * P QUEUE
- * Create a priority queue.
+ * Create a priority queue. The first three
+ * parameters are std::priority_queue's.
+ * Container holds the nodes: anything with vector's
+ * push_back, pop_back, subscript and size, such as
+ * small_vector for queues that stay tiny. Compare
+ * says which of two items is the lesser; the biggest
+ * is on top.
+ * Arity is the number of children of each node in
+ * the heap: 2 is the classic binary heap, 4 or 8
+ * make a shallower tree whose siblings share a
+ * cache line. PopPolicy picks how pop refills the
+ * top, and Layout decides where each node is stored.
  *************************************************/
-template<class T>
+template<class T, class Container = custom::vector<T>, class Compare = std::less<T>,
+         size_t Arity = 2, class PopPolicy = pop_classic, class Layout = layout_flat>
 class priority_queue
 {
+   static_assert(Arity >= 2, "a heap node needs at least two children");
+
    friend class ::TestPQueue; // give the unit test class access to the privates
-   template <class TT>
-   friend void swap(priority_queue<TT>& lhs, priority_queue<TT>& rhs);
+   friend struct heap_sift<Arity, Layout>;
+   template <class TT, class CC, class CCompare, size_t AA, class PP, class LL>
+   friend void swap(priority_queue<TT, CC, CCompare, AA, PP, LL>& lhs,
+                    priority_queue<TT, CC, CCompare, AA, PP, LL>& rhs);
 public:
 
    //
    // construct
    //
-   priority_queue() 
+   priority_queue(const Compare & c = Compare()) : compare(c)
    {
    }
-   priority_queue(const priority_queue &  rhs)  
+   priority_queue(const priority_queue &  rhs) : container(rhs.container), compare(rhs.compare)
    {
-       container = rhs.container;
    }
-   priority_queue(priority_queue && rhs)  
+   priority_queue(priority_queue && rhs) : container(std::move(rhs.container)), compare(rhs.compare)
+   {
+   }
+   // an empty queue whose container allocates with a
+   template <class Alloc, class = typename std::enable_if<
+                std::uses_allocator<Container, Alloc>::value>::type>
+   explicit priority_queue(const Alloc & a, const Compare & c = Compare()) :
+      container(a), compare(c)
    {
-       container = std::move(rhs.container);
    }
    template <class Iterator>
-   priority_queue(Iterator first, Iterator last) 
+   priority_queue(Iterator first, Iterator last, const Compare & c = Compare()) : compare(c)
    {
        container.reserve(last-first);
        for(auto it = first; it!= last; it++)
            container.push_back(*it);
-       
+       heapify();
    }
-   explicit priority_queue (custom::vector<T> && rhs) 
+   explicit priority_queue (Container && rhs, const Compare & c = Compare()) :
+      container(std::move(rhs)), compare(c)
    {
-       container = std::move(rhs);
+       heapify();
    }
-   explicit priority_queue (custom::vector<T>& rhs)
+   explicit priority_queue (Container& rhs, const Compare & c = Compare()) : compare(c)
    {
        container = rhs;
+       heapify();
    }
     
   ~priority_queue() {}
@@ -86,11 +276,22 @@ public:
    //
    void  push(const T& t);
    void  push(T&& t);     
+   template <class Iterator>
+   void  push(Iterator first, Iterator last);   // many at once
+   void  reserve(size_t n)                      // room for n without growing
+   {
+      container.reserve(n);
+   }
 
    //
-   // Remove
+   // Remove. try_pop moves the top out first; false when empty.
+   // try_pop_into moves it onto the back of items, so the caller
+   // needs no T of its own to move it into
    //
    void  pop(); 
+   bool  try_pop(T & t);
+   template <class Items>
+   bool  try_pop_into(Items & items);
 
    //
    // Status
@@ -107,8 +308,30 @@ public:
 private:
 
    bool percolateDown(size_t indexHeap);      // fix heap from index down. This is a heap index!
-
-   custom::vector<T> container; 
+   bool percolateUp(size_t indexHeap);        // fix heap from index up. Also a heap index!
+   void heapify();                            // turn the whole container into a heap
+
+   // move a hole through the heap, then drop value into it. Container indices
+   typedef heap_sift<Arity, Layout> sift;
+   void siftDown(size_t indexHole, T && value) { sift::down(*this, indexHole, std::move(value)); }
+   void siftUp  (size_t indexHole, T && value) { sift::up  (*this, indexHole, std::move(value)); }
+   size_t indexBiggestChild(size_t index) const { return sift::biggestChild(*this, index); }
+   void fillTop(T && value, pop_classic);
+   void fillTop(T && value, pop_bottom_up);
+
+   // what heap_sift needs to compare and move the nodes
+   bool lessNodes(size_t i, size_t j) const           { return compare(container[i], container[j]); }
+   bool lessValueNode(const T & t, size_t i) const    { return compare(t, container[i]);            }
+   bool lessNodeValue(size_t i, const T & t) const    { return compare(container[i], t);            }
+   void moveTo(size_t indexTo, size_t indexFrom)      { container[indexTo] = std::move(container[indexFrom]); }
+   void place(size_t index, T && t)                   { container[index] = std::move(t);            }
+
+   // navigate the heap. These are container indices, not heap indices
+   static size_t indexParent(size_t index)          { return sift::parent(index);   }
+   static size_t indexChild(size_t index, size_t k) { return sift::child(index, k); }
+
+   Container container; 
+   Compare   compare;         // which of two items is the lesser
 
 };
 
@@ -116,8 +339,8 @@ private:
  * P QUEUE :: TOP
  * Get the maximum item from the heap: the top item.
  ***********************************************/
-template <class T>
-const T & priority_queue <T> :: top() const
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+const T & priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: top() const
 {
    if(container.empty())
       throw "std:out_of_range";
@@ -128,48 +351,106 @@ const T & priority_queue <T> :: top() const
  * P QUEUE :: POP
  * Delete the top item from the heap.
  **********************************************/
-template <class T>
-void priority_queue <T> :: pop()
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+void priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: pop()
 {
    if (container.empty())
       return;
 
-   std::swap(container[0], container[container.size()-1]);
-
+   // the last item fills the hole left by the top one
+   T value(std::move(container.back()));
    container.pop_back();
-   percolateDown(1);
-   
+   if (!container.empty())
+      fillTop(std::move(value), PopPolicy());
+}
+
+/**********************************************
+ * P QUEUE :: TRY POP
+ * Move the top item into t, then delete it. A
+ * top() and pop() would copy it instead
+ **********************************************/
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+bool priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: try_pop(T & t)
+{
+   if (container.empty())
+      return false;
+   t = std::move(container.front());
+   pop();
+   return true;
+}
+
+/**********************************************
+ * P QUEUE :: TRY POP INTO
+ * As try_pop, but onto the back of items
+ **********************************************/
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+template <class Items>
+bool priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: try_pop_into(Items & items)
+{
+   if (container.empty())
+      return false;
+   items.push_back(std::move(container.front()));
+   pop();
+   return true;
+}
+
+/**********************************************
+ * P QUEUE :: FILL TOP
+ * Put value in the hole left at the top by pop()
+ **********************************************/
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+void priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: fillTop(T && value, pop_classic)
+{
+   siftDown(0, std::move(value));
+}
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+void priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: fillTop(T && value, pop_bottom_up)
+{
+   // the last item almost always belongs near the bottom, so take the
+   // hole all the way down without comparing against it
+   siftUp(sift::toLeaf(*this, 0), std::move(value));
 }
 
 /*****************************************
  * P QUEUE :: PUSH
  * Add a new element to the heap, reallocating as necessary
  ****************************************/
-template <class T>
-void priority_queue <T> :: push(const T & t)
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+void priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: push(const T & t)
 {
    container.push_back(t);
-   size_t parentIndex = (size_t) (container.size()-1)/ 2;
-   parentIndex++;
-   while(parentIndex !=0 && percolateDown(parentIndex))
-    {
-      percolateDown(parentIndex);
-      parentIndex = (size_t) (parentIndex) / 2;
-    }
-
+   percolateUp(container.size());
 }
-template <class T>
-void priority_queue <T> :: push(T && t)
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+void priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: push(T && t)
 {
    container.push_back(std::move(t));
-   size_t parentIndex = (size_t)(container.size() - 1) / 2;
-   parentIndex++;
-   
-   while(parentIndex !=0 && percolateDown(parentIndex))
-    {
-      percolateDown(parentIndex);
-      parentIndex = (size_t) (parentIndex) / 2;
-    }
+   percolateUp(container.size());
+}
+
+/*****************************************
+ * P QUEUE :: PUSH RANGE
+ * Add a batch of elements. Pushing each one costs
+ * up to one compare per level; appending them all
+ * and heapifying costs about two per element of the
+ * whole heap. Do whichever is cheaper
+ ****************************************/
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+template <class Iterator>
+void priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: push(Iterator first, Iterator last)
+{
+   size_t sizeOld = container.size();
+   for (Iterator it = first; it != last; ++it)
+      container.push_back(*it);
+
+   size_t numLevels = 1;
+   for (size_t num = container.size(); num >= Arity; num /= Arity)
+      numLevels++;
+   if ((container.size() - sizeOld) * numLevels < container.size() * 2)
+      for (size_t indexHeap = sizeOld + 1; indexHeap <= container.size(); indexHeap++)
+         percolateUp(indexHeap);
+   else
+      heapify();
 }
 
 /************************************************
@@ -178,53 +459,74 @@ void priority_queue <T> :: push(T && t)
  * order. Take care of that little detail!
  * Return TRUE if anything changed.
  ************************************************/
-template <class T>
-bool priority_queue <T> :: percolateDown(size_t indexHeap)
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+bool priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: percolateDown(size_t indexHeap)
 {
-   indexHeap -= 1;
-   
-   
-   bool valueChanged = false;
-   if(indexHeap+1 >= container.size()-1)
-       return 0;
-
-
-   int childLeft = (int) indexHeap * 2 + 1;
-
-   int childRight = (int)indexHeap*2  +2 <= (int) container.size() -1 ? (int)indexHeap*2 +2 : -1;
-
-
-   int indexBigger = 0;
-   // Find Bigger Child
-   if (childRight != -1 && container[childLeft] < container[childRight])
-   {
-      indexBigger = childRight;
-   }
-   else
-   {
-      indexBigger = childLeft;
-   }
-
-   if (container[indexHeap] < container[indexBigger])
-   {
+   size_t index = indexHeap - 1;
+   if (indexChild(index, 0) >= container.size())
+      return false;
+
+   size_t indexBigger = indexBiggestChild(index);
+   if (!compare(container[index], container[indexBigger]))
+      return false;
+
+   // lift the item out, leaving a hole to push down the tree
+   T value(std::move(container[index]));
+   container[index] = std::move(container[indexBigger]);
+   siftDown(indexBigger, std::move(value));
+   return true;
+}
 
-      std::swap(container[indexHeap], container[indexBigger]);
-      valueChanged = true;
-      percolateDown(indexBigger+1);
-   }
-   return valueChanged;
+/************************************************
+ * P QUEUE :: PERCOLATE UP
+ * The item at the passed index may be bigger than
+ * its parent. Float it up to where it belongs.
+ * Return TRUE if anything changed.
+ ************************************************/
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+bool priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: percolateUp(size_t indexHeap)
+{
+   size_t index = indexHeap - 1;
+   if (index == 0 || !compare(container[indexParent(index)], container[index]))
+      return false;
+
+   // lift the item out, leaving a hole to pull up the tree
+   T value(std::move(container[index]));
+   container[index] = std::move(container[indexParent(index)]);
+   siftUp(indexParent(index), std::move(value));
+   return true;
 }
 
+/************************************************
+ * P QUEUE :: HEAPIFY
+ * Floyd's bottom-up heap construction: percolate
+ * every parent down, last one first. Most nodes
+ * are near the leaves, so this is O(n) rather
+ * than the O(n log n) of pushing one at a time.
+ * In the blocked layout the parents are not all
+ * at the front, so every node gets a look.
+ ************************************************/
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+void priority_queue <T, Container, Compare, Arity, PopPolicy, Layout> :: heapify()
+{
+   if (container.size() < 2)
+      return;
+   size_t indexLast = std::is_same<Layout, layout_flat>::value ?
+                      indexParent(container.size() - 1) + 1 : container.size();
+   for (size_t indexHeap = indexLast; indexHeap > 0; indexHeap--)
+      percolateDown(indexHeap);
+}
 
 /************************************************
  * SWAP
  * Swap the contents of two priority queues
  ************************************************/
-template <class T>
-inline void swap(custom::priority_queue <T>& lhs,
-                 custom::priority_queue <T>& rhs)
+template <class T, class Container, class Compare, size_t Arity, class PopPolicy, class Layout>
+inline void swap(custom::priority_queue <T, Container, Compare, Arity, PopPolicy, Layout>& lhs,
+                 custom::priority_queue <T, Container, Compare, Arity, PopPolicy, Layout>& rhs)
 {
     lhs.container.swap(rhs.container);
+    std::swap(lhs.compare, rhs.compare);
 }
 
 };
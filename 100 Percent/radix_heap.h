@@ -0,0 +1,240 @@
+/***********************************************************************
+ * Header:
+ *    RADIX HEAP
+ * Summary:
+ *    A min priority queue for integer keys that are popped in
+ *    non-decreasing order, such as the distances in Dijkstra's
+ *    shortest path
+ *
+ *    This will contain the class definition of:
+ *        radix_heap             : A monotone Priority Queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <type_traits>  // for std::make_unsigned
+#include "vector.h"
+#include "bits.h"
+
+class TestRadixHeap;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * RADIX HEAP
+ * Items are kept in buckets by how far their key is
+ * from the last key popped: bucket 0 holds keys equal
+ * to it, bucket i keys whose highest differing bit is
+ * bit i-1. Popping scans for the first full bucket and
+ * spreads it over the buckets below. No compares with
+ * random heap slots, and amortized O(log C) per item.
+ *
+ * Unlike priority_queue this is a min-heap, and a key
+ * may never be smaller than the last one popped.
+ *************************************************/
+template<class Key, class Value>
+class radix_heap
+{
+   static_assert(std::is_integral<Key>::value, "radix_heap needs integer keys");
+
+   friend class ::TestRadixHeap; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   radix_heap() : numElements(0), last(0), isTopKnown(false), bucketTop(0), indexTop(0)
+   {
+   }
+
+   //
+   // Access
+   //
+   const Value & top() const;
+   Key           topKey() const;
+
+   //
+   // Insert
+   //
+   void  push(Key key, const Value & value);
+   void  push(Key key, Value && value);
+
+   //
+   // Remove
+   //
+   void  pop();
+
+   //
+   // Status
+   //
+   size_t size()  const
+   {
+      return numElements;
+   }
+   bool empty() const
+   {
+      return numElements == 0;
+   }
+
+private:
+
+   typedef typename std::make_unsigned<Key>::type Bits;
+   static const int numBits = sizeof(Key) * 8;
+
+   struct Item
+   {
+      Bits  key;
+      Value value;
+   };
+
+   // flip the sign bit so signed keys sort the same as their bit patterns
+   static Bits toBits(Key key)
+   {
+      return (Bits)key ^ (std::is_signed<Key>::value ? (Bits)((Bits)1 << (numBits - 1)) : (Bits)0);
+   }
+   static Key fromBits(Bits bits)
+   {
+      return (Key)(bits ^ (std::is_signed<Key>::value ? (Bits)((Bits)1 << (numBits - 1)) : (Bits)0));
+   }
+
+   size_t bucketIndex(Bits key) const
+   {
+      return bitWidth(key ^ last);
+   }
+   void findTop() const;        // remember where the smallest item is
+
+   custom::vector<Item> buckets[numBits + 1];
+   size_t numElements;
+   Bits   last;                 // the last key popped, as bits
+
+   // top() has to find the smallest item without disturbing the
+   // buckets, so it caches where it is. push keeps this up to date
+   mutable bool   isTopKnown;
+   mutable size_t bucketTop;
+   mutable size_t indexTop;
+};
+
+/************************************************
+ * RADIX HEAP :: TOP
+ * Get the item with the smallest key
+ ***********************************************/
+template <class Key, class Value>
+const Value & radix_heap <Key, Value> :: top() const
+{
+   if (empty())
+      throw "std:out_of_range";
+   findTop();
+   return buckets[bucketTop][indexTop].value;
+}
+
+template <class Key, class Value>
+Key radix_heap <Key, Value> :: topKey() const
+{
+   if (empty())
+      throw "std:out_of_range";
+   findTop();
+   return fromBits(buckets[bucketTop][indexTop].key);
+}
+
+/*****************************************
+ * RADIX HEAP :: PUSH
+ * Drop the item into the bucket for its key
+ ****************************************/
+template <class Key, class Value>
+void radix_heap <Key, Value> :: push(Key key, const Value & value)
+{
+   push(key, Value(value));
+}
+template <class Key, class Value>
+void radix_heap <Key, Value> :: push(Key key, Value && value)
+{
+   Bits bits = toBits(key);
+   assert(bits >= last);   // keys may not go below the last one popped
+
+   Item item;
+   item.key = bits;
+   item.value = std::move(value);
+   size_t iBucket = bucketIndex(bits);
+   buckets[iBucket].push_back(std::move(item));
+   numElements++;
+
+   if (isTopKnown && bits < buckets[bucketTop][indexTop].key)
+   {
+      bucketTop = iBucket;
+      indexTop = buckets[iBucket].size() - 1;
+   }
+}
+
+/**********************************************
+ * RADIX HEAP :: POP
+ * Delete the item with the smallest key. If it is
+ * not in bucket 0, its key becomes the new last and
+ * its bucket is spread over the buckets below: every
+ * item moves down at least one bucket, which is where
+ * the amortized bound comes from.
+ **********************************************/
+template <class Key, class Value>
+void radix_heap <Key, Value> :: pop()
+{
+   if (empty())
+      return;
+
+   findTop();
+   if (bucketTop != 0)
+   {
+      custom::vector<Item> & bucket = buckets[bucketTop];
+      last = bucket[indexTop].key;
+      size_t indexMoved = 0;
+      for (size_t i = 0; i < bucket.size(); i++)
+      {
+         size_t iBucket = bucketIndex(bucket[i].key);
+         if (i == indexTop)
+            indexMoved = buckets[iBucket].size();
+         buckets[iBucket].push_back(std::move(bucket[i]));
+      }
+      bucket.clear();
+      bucketTop = 0;
+      indexTop = indexMoved;
+   }
+
+   // remove the very item top() handed out, by moving the last one over it
+   custom::vector<Item> & bucket0 = buckets[0];
+   if (indexTop != bucket0.size() - 1)
+      bucket0[indexTop] = std::move(bucket0.back());
+   bucket0.pop_back();
+   numElements--;
+
+   // everything left in bucket 0 has the same key, so any one will do
+   isTopKnown = !bucket0.empty();
+   indexTop = bucket0.size() - 1;
+}
+
+/**********************************************
+ * RADIX HEAP :: FIND TOP
+ * Bucket 0 holds the smallest keys if it has any.
+ * Otherwise the smallest key is somewhere in the first
+ * bucket with anything in it.
+ **********************************************/
+template <class Key, class Value>
+void radix_heap <Key, Value> :: findTop() const
+{
+   if (isTopKnown)
+      return;
+
+   size_t i = 0;
+   while (buckets[i].empty())
+      i++;
+
+   bucketTop = i;
+   indexTop = buckets[i].size() - 1;
+   for (size_t j = 0; j < buckets[i].size(); j++)
+      if (buckets[i][j].key < buckets[i][indexTop].key)
+         indexTop = j;
+   isTopKnown = true;
+}
+
+}; // namespace custom
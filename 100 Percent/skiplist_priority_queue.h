@@ -0,0 +1,502 @@
+/***********************************************************************
+ * Header:
+ *    SKIPLIST PRIORITY QUEUE
+ * Summary:
+ *    A lock-free priority queue: the items are kept in order in a
+ *    skiplist, so the biggest is always at the front. No thread ever
+ *    waits on another, so one that is preempted holds nobody up
+ *
+ *    This will contain the class definition of:
+ *        skiplist_priority_queue : A lock-free Priority Queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>       // for std::atomic
+#include <cassert>
+#include <cstdint>      // for uintptr_t
+#include <functional>   // for std::less, std::hash
+#include <thread>       // for std::this_thread
+
+class TestSkiplistPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * SKIPLIST P QUEUE
+ * The queue of Linden and Jonsson (2013). The items
+ * are in a skiplist, biggest first, between a head and
+ * a tail that hold no item.
+ *    push : find the place for the item and link it in
+ *           with compare-and-swap, bottom level first
+ *    pop  : walk the bottom level from the head, setting
+ *           the low bit of each next pointer, until one
+ *           was not yet set. That item is ours
+ * The bit on a pointer means the node it points to is
+ * deleted. Since pop always sets the first unset one,
+ * the deleted nodes are a prefix of the list, and the
+ * pops all meet at its end rather than fight over the
+ * first live node.
+ *
+ * Taking the deleted nodes out of the list is batched:
+ * only when a pop had to walk past boundOffset of them
+ * does it swing the head past the prefix, once for the
+ * whole batch.
+ *
+ * Unlinked nodes may still be in use by other threads,
+ * so they are freed by epochs. Each operation marks
+ * itself active in the epoch it started in; the epoch
+ * moves on only when every active operation has seen
+ * the current one; and a node unlinked in epoch e is
+ * freed once the epoch reaches e + 2, by which time
+ * everyone who might have seen it has left.
+ *
+ * Compare is the same as priority_queue's: the item
+ * that is not less than any other comes out first.
+ *************************************************/
+template<class T, class Compare = std::less<T>>
+class skiplist_priority_queue
+{
+   friend class ::TestSkiplistPQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   explicit skiplist_priority_queue(size_t boundOffset = 32, const Compare & c = Compare());
+   skiplist_priority_queue(const skiplist_priority_queue &) = delete;
+   skiplist_priority_queue & operator = (const skiplist_priority_queue &) = delete;
+   ~skiplist_priority_queue();
+
+   //
+   // Insert
+   //
+   void  push(const T& t);
+
+   //
+   // Remove. Between threads, a top() would be stale by
+   // the time pop() came, so it is one call
+   //
+   bool  try_pop(T & t);
+
+   //
+   // Status. Only a snapshot while other threads are busy
+   //
+   size_t size()  const
+   {
+      return numElements.load();
+   }
+   bool empty() const
+   {
+      return size() == 0;
+   }
+
+private:
+
+   enum { levelMax = 24 };
+
+   // the links of a node; the head and tail are only links
+   struct Link
+   {
+      std::atomic<uintptr_t> * next;      // low bit set: the next node is deleted
+      int                      height;
+      std::atomic<bool>        isInserting;
+      Link *                   pRetired;  // chains the nodes waiting to be freed
+      explicit Link(int height) : next(new std::atomic<uintptr_t>[height]),
+         height(height), isInserting(false), pRetired(nullptr)
+      {
+         for (int i = 0; i < height; i++)
+            next[i].store(0);
+      }
+      ~Link()
+      {
+         delete [] next;
+      }
+   };
+
+   struct Node : public Link
+   {
+      T data;
+      Node(const T & t, int height) : Link(height), data(t) {}
+   };
+
+   // one operation in progress, and what it has unlinked
+   struct Slot
+   {
+      std::atomic<bool>               isClaimed;
+      std::atomic<bool>               isActive;
+      std::atomic<unsigned long long> epoch;
+      Link *                          limbo[3];   // unlinked nodes, by epoch
+      Slot *                          pNext;
+      Slot() : isClaimed(true), isActive(false), epoch(0), pNext(nullptr)
+      {
+         limbo[0] = limbo[1] = limbo[2] = nullptr;
+      }
+   };
+
+   // holds a slot for the length of one operation
+   class Guard
+   {
+   public:
+      explicit Guard(skiplist_priority_queue & pq) : pq(pq), slot(pq.enter()) {}
+      ~Guard() { pq.leave(slot); }
+      Slot * get() const { return slot; }
+   private:
+      skiplist_priority_queue & pq;
+      Slot * slot;
+   };
+
+   static bool   isMarked(uintptr_t p)  { return (p & 1) != 0;                }
+   static Link * unmarked(uintptr_t p)  { return (Link *)(p & ~(uintptr_t)1); }
+   static uintptr_t pointer(Link * p)   { return (uintptr_t)p;                }
+   static const T & dataOf(Link * p)    { return static_cast<Node *>(p)->data; }
+
+   Link * locatePreds(const T & t, Link * preds[], Link * succs[]);
+   void   restructure();
+   int    randomHeight();
+
+   // epochs
+   Slot * enter();
+   void   leave(Slot * slot);
+   void   retire(Slot * slot, Link * link);
+   void   tryAdvance();
+   static void freeChain(Link * link);
+
+   Link   head;
+   Link   tail;
+   size_t boundOffset;
+   Compare compare;
+   std::atomic<size_t> numElements;
+   std::atomic<unsigned long long> epochGlobal;
+   std::atomic<Slot *> slots;
+};
+
+/************************************************
+ * SKIPLIST P QUEUE :: CONSTRUCTOR
+ ***********************************************/
+template <class T, class Compare>
+skiplist_priority_queue <T, Compare> :: skiplist_priority_queue(size_t boundOffset, const Compare & c) :
+   head(levelMax), tail(1), boundOffset(boundOffset), compare(c),
+   numElements(0), epochGlobal(0), slots(nullptr)
+{
+   for (int i = 0; i < levelMax; i++)
+      head.next[i].store(pointer(&tail));
+}
+
+/************************************************
+ * SKIPLIST P QUEUE :: DESTRUCTOR
+ * No other thread may be using the queue by now, so
+ * everything can go: the list, deleted prefix and
+ * all, and whatever is waiting on an epoch
+ ***********************************************/
+template <class T, class Compare>
+skiplist_priority_queue <T, Compare> :: ~skiplist_priority_queue()
+{
+   Link * p = unmarked(head.next[0].load());
+   while (p != &tail)
+   {
+      Link * pNext = unmarked(p->next[0].load());
+      delete static_cast<Node *>(p);
+      p = pNext;
+   }
+
+   Slot * slot = slots.load();
+   while (slot)
+   {
+      Slot * slotNext = slot->pNext;
+      for (int i = 0; i < 3; i++)
+         freeChain(slot->limbo[i]);
+      delete slot;
+      slot = slotNext;
+   }
+}
+
+/*****************************************
+ * SKIPLIST P QUEUE :: PUSH
+ * Link the bottom level first: from then on the item
+ * is in the queue. The levels above only make the
+ * search faster, so if the place for one of them is
+ * gone by the time we get there, we stop building
+ ****************************************/
+template <class T, class Compare>
+void skiplist_priority_queue <T, Compare> :: push(const T & t)
+{
+   int height = randomHeight();
+   Node * node = new Node(t, height);
+   node->isInserting.store(true);
+   Guard guard(*this);
+   numElements++;                 // before a pop can take it, so size never wraps
+
+   Link * preds[levelMax];
+   Link * succs[levelMax];
+   Link * del;
+   uintptr_t expected;
+   do
+   {
+      del = locatePreds(node->data, preds, succs);
+      node->next[0].store(pointer(succs[0]));
+      expected = pointer(succs[0]);
+   }
+   while (!preds[0]->next[0].compare_exchange_strong(expected, pointer(node)));
+
+   for (int i = 1; i < height; )
+   {
+      node->next[i].store(pointer(succs[i]));
+      if (isMarked(node->next[0].load()) ||          // we were popped
+          isMarked(succs[i]->next[0].load()) ||      // the successor was
+          del == succs[i])
+         break;
+
+      expected = pointer(succs[i]);
+      if (preds[i]->next[i].compare_exchange_strong(expected, pointer(node)))
+         i++;
+      else
+      {
+         del = locatePreds(node->data, preds, succs);
+         if (succs[0] != node)
+            break;
+      }
+   }
+   node->isInserting.store(false);
+}
+
+/**********************************************
+ * SKIPLIST P QUEUE :: TRY POP
+ * Claim the first node nobody else has, and now and
+ * then cut the deleted ones off the front
+ **********************************************/
+template <class T, class Compare>
+bool skiplist_priority_queue <T, Compare> :: try_pop(T & t)
+{
+   Guard guard(*this);
+
+   Link * x = &head;
+   Link * newHead = nullptr;
+   size_t offset = 0;
+   uintptr_t observedHead = head.next[0].load();
+   uintptr_t next;
+   do
+   {
+      next = x->next[0].load();
+      if (unmarked(next) == &tail)
+         return false;
+      // do not cut past a node whose upper levels are still being linked
+      if (newHead == nullptr && x->isInserting.load())
+         newHead = x;
+      next = x->next[0].fetch_or(1);
+      offset++;
+      x = unmarked(next);
+   }
+   while (isMarked(next));
+   numElements--;
+
+   // other threads may still be comparing against it, so copy, not move
+   t = dataOf(x);
+   if (offset < boundOffset)
+      return true;
+
+   // cut the prefix: the head skips straight to the last node taken
+   if (newHead == nullptr)
+      newHead = x;
+   if (head.next[0].compare_exchange_strong(observedHead, pointer(newHead) | 1))
+   {
+      restructure();
+      Link * p = unmarked(observedHead);
+      while (p != newHead)
+      {
+         Link * pNext = unmarked(p->next[0].load());
+         retire(guard.get(), p);
+         p = pNext;
+      }
+      tryAdvance();
+   }
+   return true;
+}
+
+/**********************************************
+ * SKIPLIST P QUEUE :: LOCATE PREDS
+ * For each level, the last node before the place for t
+ * and the first after. A node goes in before those
+ * equal to it, and never inside the deleted prefix.
+ * Returns the last deleted node seen on the bottom
+ * level, if any
+ **********************************************/
+template <class T, class Compare>
+typename skiplist_priority_queue <T, Compare> :: Link *
+skiplist_priority_queue <T, Compare> :: locatePreds(const T & t, Link * preds[], Link * succs[])
+{
+   Link * pred = &head;
+   Link * del = nullptr;
+   for (int i = levelMax - 1; i >= 0; i--)
+   {
+      uintptr_t next = pred->next[i].load();
+      bool isDeleted = isMarked(next);
+      Link * cur = unmarked(next);
+      while (cur != &tail &&
+             (isMarked(cur->next[0].load()) ||
+              (isDeleted && i == 0) ||
+              compare(t, dataOf(cur))))
+      {
+         if (isDeleted && i == 0)
+            del = cur;
+         pred = cur;
+         next = pred->next[i].load();
+         isDeleted = isMarked(next);
+         cur = unmarked(next);
+      }
+      preds[i] = pred;
+      succs[i] = cur;
+   }
+   return del;
+}
+
+/**********************************************
+ * SKIPLIST P QUEUE :: RESTRUCTURE
+ * Once the bottom level of the head skips the prefix,
+ * make the upper levels skip it too
+ **********************************************/
+template <class T, class Compare>
+void skiplist_priority_queue <T, Compare> :: restructure()
+{
+   Link * pred = &head;
+   for (int i = levelMax - 1; i > 0; )
+   {
+      uintptr_t h = head.next[i].load();
+      Link * cur = unmarked(pred->next[i].load());
+      if (!isMarked(unmarked(h)->next[0].load()))
+      {
+         i--;
+         continue;
+      }
+      while (isMarked(cur->next[0].load()))
+      {
+         pred = cur;
+         cur = unmarked(pred->next[i].load());
+      }
+      if (head.next[i].compare_exchange_strong(h, pred->next[i].load()))
+         i--;
+   }
+}
+
+/**********************************************
+ * SKIPLIST P QUEUE :: RANDOM HEIGHT
+ * One level, and another with each heads of a coin.
+ * xorshift64*, one state per thread
+ **********************************************/
+template <class T, class Compare>
+int skiplist_priority_queue <T, Compare> :: randomHeight()
+{
+   static thread_local unsigned long long state =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+   state ^= state >> 12;
+   state ^= state << 25;
+   state ^= state >> 27;
+   unsigned long long bits = (state * 0x2545f4914f6cdd1dull) >> 32;
+   int height = 1;
+   while ((bits & 1) && height < levelMax)
+   {
+      height++;
+      bits >>= 1;
+   }
+   return height;
+}
+
+/**********************************************
+ * SKIPLIST P QUEUE :: ENTER
+ * Claim a free slot, or add one, and mark it active
+ * in the current epoch. Whatever the slot unlinked
+ * two epochs ago can be freed now
+ **********************************************/
+template <class T, class Compare>
+typename skiplist_priority_queue <T, Compare> :: Slot *
+skiplist_priority_queue <T, Compare> :: enter()
+{
+   Slot * slot = slots.load();
+   while (slot)
+   {
+      bool isClaimed = false;
+      if (!slot->isClaimed.load() && slot->isClaimed.compare_exchange_strong(isClaimed, true))
+         break;
+      slot = slot->pNext;
+   }
+   if (!slot)
+   {
+      slot = new Slot;
+      Slot * first = slots.load();
+      do
+         slot->pNext = first;
+      while (!slots.compare_exchange_weak(first, slot));
+   }
+
+   // the epoch we are in must be the one after we became active
+   slot->isActive.store(true);
+   unsigned long long epoch;
+   do
+   {
+      epoch = epochGlobal.load();
+      slot->epoch.store(epoch);
+   }
+   while (epochGlobal.load() != epoch);
+
+   // unlinked in epoch - 2 or before, and nobody from then is left
+   freeChain(slot->limbo[(epoch + 1) % 3]);
+   slot->limbo[(epoch + 1) % 3] = nullptr;
+   return slot;
+}
+
+/**********************************************
+ * SKIPLIST P QUEUE :: LEAVE
+ **********************************************/
+template <class T, class Compare>
+void skiplist_priority_queue <T, Compare> :: leave(Slot * slot)
+{
+   slot->isActive.store(false);
+   slot->isClaimed.store(false);
+}
+
+/**********************************************
+ * SKIPLIST P QUEUE :: RETIRE
+ * The node is unlinked, but others may still hold it:
+ * file it under the epoch it is now
+ **********************************************/
+template <class T, class Compare>
+void skiplist_priority_queue <T, Compare> :: retire(Slot * slot, Link * link)
+{
+   unsigned long long epoch = epochGlobal.load();
+   link->pRetired = slot->limbo[epoch % 3];
+   slot->limbo[epoch % 3] = link;
+}
+
+/**********************************************
+ * SKIPLIST P QUEUE :: TRY ADVANCE
+ * Move to the next epoch if every active operation
+ * has seen this one
+ **********************************************/
+template <class T, class Compare>
+void skiplist_priority_queue <T, Compare> :: tryAdvance()
+{
+   unsigned long long epoch = epochGlobal.load();
+   for (Slot * slot = slots.load(); slot; slot = slot->pNext)
+      if (slot->isActive.load() && slot->epoch.load() != epoch)
+         return;
+   epochGlobal.compare_exchange_strong(epoch, epoch + 1);
+}
+
+/**********************************************
+ * SKIPLIST P QUEUE :: FREE CHAIN
+ **********************************************/
+template <class T, class Compare>
+void skiplist_priority_queue <T, Compare> :: freeChain(Link * link)
+{
+   while (link)
+   {
+      Link * pNext = link->pRetired;
+      delete static_cast<Node *>(link);
+      link = pNext;
+   }
+}
+
+}; // namespace custom
@@ -0,0 +1,327 @@
+/***********************************************************************
+ * Header:
+ *    SMALL VECTOR
+ * Summary:
+ *    A vector that keeps its first N elements inside the object itself
+ *    and only goes to the heap when it holds more. A container that
+ *    stays small never allocates at all.
+ *
+ *    This will contain the class definition of:
+ *        small_vector           : A Vector with inline room for N elements
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstring>      // for std::memcpy
+#include <memory>       // for std::allocator
+#include <new>          // for placement new
+#include <type_traits>  // for std::is_trivially_copyable
+#include <utility>      // for std::move
+
+class TestSmallVector;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * SMALL VECTOR
+ * The same raw storage scheme as vector, except the
+ * first buffer is a block of N slots in the object.
+ * data points at it until a push finds it full; then
+ * the elements are relocated to a heap buffer of
+ * twice the size and growth doubles from there, as
+ * in vector. A queue that never passes N costs no
+ * allocations, where vector would pay one for each
+ * doubling on the way up to it.
+ *
+ * Moving a small_vector that is still inline has to
+ * move the elements one by one, since the buffer goes
+ * with the object. Moving one that has spilled just
+ * takes the pointer.
+ *************************************************/
+template <class T, size_t N>
+class small_vector
+{
+   static_assert(N >= 1, "a small_vector needs room for at least one element inline");
+
+   friend class ::TestSmallVector; // give the unit test class access to the privates
+public:
+
+   //
+   // Construct
+   //
+   small_vector() : data(inlineData()), numCapacity(N), numElements(0) {}
+   small_vector(const small_vector &  rhs);
+   small_vector(      small_vector && rhs);
+   ~small_vector();
+
+   //
+   // Assign
+   //
+   small_vector & operator = (const small_vector &  rhs);
+   small_vector & operator = (      small_vector && rhs);
+   void swap(small_vector & rhs)
+   {
+      small_vector tmp(std::move(rhs));
+      rhs   = std::move(*this);
+      *this = std::move(tmp);
+   }
+
+   //
+   // Iterator
+   //
+   T * begin() { return data;               }
+   T * end()   { return data + numElements; }
+
+   //
+   // Access
+   //
+         T & operator [] (size_t index)       { return data[index];           }
+   const T & operator [] (size_t index) const { return data[index];           }
+         T & front()                          { return data[0];               }
+   const T & front() const                    { return data[0];               }
+         T & back()                           { return data[numElements - 1]; }
+   const T & back()  const                    { return data[numElements - 1]; }
+
+   //
+   // Insert
+   //
+   void push_back(const T & t);
+   void push_back(T && t);
+   void reserve(size_t newCapacity);
+
+   //
+   // Remove
+   //
+   void pop_back()
+   {
+      if (numElements)
+         data[--numElements].~T();
+   }
+   void clear()
+   {
+      destroy(0, numElements);
+      numElements = 0;
+   }
+
+   //
+   // Status
+   //
+   size_t size()     const { return numElements;      }
+   size_t capacity() const { return numCapacity;      }
+   bool   empty()    const { return numElements == 0; }
+
+private:
+
+   T * inlineData()             { return reinterpret_cast<T *>(storage);             }
+   const T * inlineData() const { return reinterpret_cast<const T *>(storage);       }
+   bool isInline() const        { return data == inlineData();                       }
+
+   void destroy(size_t begin, size_t end);
+   void adopt(T * pNew, size_t newCapacity);   // relocate into pNew, free the old buffer
+   void relocate(T * pNew, std::true_type);    // trivially copyable: copy the bytes
+   void relocate(T * pNew, std::false_type);   // otherwise move each element
+   void release();                             // free a heap buffer, go back inline
+
+   alignas(T) unsigned char storage[sizeof(T) * N];   // raw room for N elements
+   T *               data;          // either storage or a heap buffer from alloc
+   size_t            numCapacity;
+   size_t            numElements;
+   std::allocator<T> alloc;
+};
+
+/************************************************
+ * SMALL VECTOR :: COPY CONSTRUCTOR
+ ***********************************************/
+template <class T, size_t N>
+small_vector <T, N> :: small_vector(const small_vector & rhs) :
+   data(inlineData()), numCapacity(N), numElements(0)
+{
+   reserve(rhs.numElements);
+   for (size_t i = 0; i < rhs.numElements; i++)
+      new ((void *)(data + i)) T(rhs.data[i]);
+   numElements = rhs.numElements;
+}
+
+/************************************************
+ * SMALL VECTOR :: MOVE CONSTRUCTOR
+ * Take the heap buffer if there is one, otherwise
+ * move the inline elements across
+ ***********************************************/
+template <class T, size_t N>
+small_vector <T, N> :: small_vector(small_vector && rhs) :
+   data(inlineData()), numCapacity(N), numElements(0)
+{
+   *this = std::move(rhs);
+}
+
+/************************************************
+ * SMALL VECTOR :: DESTRUCTOR
+ ***********************************************/
+template <class T, size_t N>
+small_vector <T, N> :: ~small_vector()
+{
+   destroy(0, numElements);
+   release();
+}
+
+/************************************************
+ * SMALL VECTOR :: ASSIGNMENT
+ ***********************************************/
+template <class T, size_t N>
+small_vector <T, N> & small_vector <T, N> :: operator = (const small_vector & rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   clear();
+   reserve(rhs.numElements);
+   for (size_t i = 0; i < rhs.numElements; i++)
+      new ((void *)(data + i)) T(rhs.data[i]);
+   numElements = rhs.numElements;
+   return *this;
+}
+
+/************************************************
+ * SMALL VECTOR :: MOVE ASSIGNMENT
+ * rhs is left empty, and inline
+ ***********************************************/
+template <class T, size_t N>
+small_vector <T, N> & small_vector <T, N> :: operator = (small_vector && rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   clear();
+   if (!rhs.isInline())
+   {
+      release();
+      data        = rhs.data;
+      numCapacity = rhs.numCapacity;
+      numElements = rhs.numElements;
+      rhs.data        = rhs.inlineData();
+      rhs.numCapacity = N;
+      rhs.numElements = 0;
+      return *this;
+   }
+
+   // rhs has at most N, which always fits
+   for (size_t i = 0; i < rhs.numElements; i++)
+      new ((void *)(data + i)) T(std::move(rhs.data[i]));
+   numElements = rhs.numElements;
+   rhs.clear();
+   return *this;
+}
+
+/***************************************
+ * SMALL VECTOR :: PUSH BACK
+ * Out of room: build the new element in the new
+ * buffer first, since t may live in the old one
+ **************************************/
+template <class T, size_t N>
+void small_vector <T, N> :: push_back(const T & t)
+{
+   if (numElements == numCapacity)
+   {
+      T * pNew = alloc.allocate(numCapacity * 2);
+      new ((void *)(pNew + numElements)) T(t);
+      adopt(pNew, numCapacity * 2);
+   }
+   else
+      new ((void *)(data + numElements)) T(t);
+   numElements++;
+}
+
+template <class T, size_t N>
+void small_vector <T, N> :: push_back(T && t)
+{
+   if (numElements == numCapacity)
+   {
+      T * pNew = alloc.allocate(numCapacity * 2);
+      new ((void *)(pNew + numElements)) T(std::move(t));
+      adopt(pNew, numCapacity * 2);
+   }
+   else
+      new ((void *)(data + numElements)) T(std::move(t));
+   numElements++;
+}
+
+/***************************************
+ * SMALL VECTOR :: RESERVE
+ * Never shrinks, so the inline buffer is only
+ * ever left behind, not returned to
+ **************************************/
+template <class T, size_t N>
+void small_vector <T, N> :: reserve(size_t newCapacity)
+{
+   if (newCapacity <= numCapacity)
+      return;
+
+   adopt(alloc.allocate(newCapacity), newCapacity);
+}
+
+/***************************************
+ * SMALL VECTOR :: DESTROY
+ * Call the destructor on the elements in
+ * [begin, end), leaving their slots raw
+ **************************************/
+template <class T, size_t N>
+void small_vector <T, N> :: destroy(size_t begin, size_t end)
+{
+   for (size_t i = begin; i < end; i++)
+      data[i].~T();
+}
+
+/***************************************
+ * SMALL VECTOR :: ADOPT
+ * Relocate the elements into a heap buffer and
+ * free the old one, unless that was inline
+ **************************************/
+template <class T, size_t N>
+void small_vector <T, N> :: adopt(T * pNew, size_t newCapacity)
+{
+   relocate(pNew, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+   destroy(0, numElements);
+   release();
+
+   data = pNew;
+   numCapacity = newCapacity;
+}
+
+/***************************************
+ * SMALL VECTOR :: RELOCATE
+ * As in vector: one memcpy for plain bytes,
+ * a move construction each for anything else
+ **************************************/
+template <class T, size_t N>
+void small_vector <T, N> :: relocate(T * pNew, std::true_type)
+{
+   if (numElements != 0)
+      std::memcpy((void *)pNew, (const void *)data, numElements * sizeof(T));
+}
+
+template <class T, size_t N>
+void small_vector <T, N> :: relocate(T * pNew, std::false_type)
+{
+   for (size_t i = 0; i < numElements; i++)
+      new ((void *)(pNew + i)) T(std::move(data[i]));
+}
+
+/***************************************
+ * SMALL VECTOR :: RELEASE
+ * The elements must already be destroyed
+ **************************************/
+template <class T, size_t N>
+void small_vector <T, N> :: release()
+{
+   if (isInline())
+      return;
+   alloc.deallocate(data, numCapacity);
+   data = inlineData();
+   numCapacity = N;
+}
+
+}; // namespace custom
@@ -0,0 +1,226 @@
+/***********************************************************************
+ * Header:
+ *    STATIC PRIORITY QUEUE
+ * Summary:
+ *    A priority queue with a fixed capacity, kept entirely inside the
+ *    object. It never calls the allocator, so it is safe on a thread
+ *    that must not.
+ *
+ *    This will contain the class definition of:
+ *        static_vector          : A Vector of at most N elements, inline
+ *        static_priority_queue  : A fixed-capacity Priority Queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <functional>   // for std::less
+#include <new>          // for placement new
+#include <utility>      // for std::move
+#include "priority_queue.h"
+
+class TestStaticPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * STATIC VECTOR
+ * Room for N elements in the object and no more.
+ * Just enough of vector for priority_queue to use
+ * it as its container. The caller is expected to
+ * check size() before a push_back; reserve past N
+ * throws, since the room cannot be made.
+ *************************************************/
+template <class T, size_t N>
+class static_vector
+{
+   friend class ::TestStaticPQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // Construct
+   //
+   static_vector() : numElements(0) {}
+   static_vector(const static_vector & rhs) : numElements(0)
+   {
+      *this = rhs;
+   }
+   static_vector(static_vector && rhs) : numElements(0)
+   {
+      *this = std::move(rhs);
+   }
+   ~static_vector()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+   static_vector & operator = (const static_vector & rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         for (size_t i = 0; i < rhs.numElements; i++)
+            push_back(rhs[i]);
+      }
+      return *this;
+   }
+   static_vector & operator = (static_vector && rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         for (size_t i = 0; i < rhs.numElements; i++)
+            push_back(std::move(rhs[i]));
+         rhs.clear();
+      }
+      return *this;
+   }
+   void swap(static_vector & rhs)
+   {
+      static_vector tmp(std::move(rhs));
+      rhs   = std::move(*this);
+      *this = std::move(tmp);
+   }
+
+   //
+   // Access
+   //
+         T & operator [] (size_t index)       { return data()[index];           }
+   const T & operator [] (size_t index) const { return data()[index];           }
+         T & front()                          { return data()[0];               }
+   const T & front() const                    { return data()[0];               }
+         T & back()                           { return data()[numElements - 1]; }
+   const T & back()  const                    { return data()[numElements - 1]; }
+
+   //
+   // Insert
+   //
+   void push_back(const T & t)
+   {
+      assert(numElements < N);
+      new ((void *)(data() + numElements)) T(t);
+      numElements++;
+   }
+   void push_back(T && t)
+   {
+      assert(numElements < N);
+      new ((void *)(data() + numElements)) T(std::move(t));
+      numElements++;
+   }
+   void reserve(size_t newCapacity)
+   {
+      if (newCapacity > N)
+         throw "std:length_error";
+   }
+
+   //
+   // Remove
+   //
+   void pop_back()
+   {
+      if (numElements)
+         data()[--numElements].~T();
+   }
+   void clear()
+   {
+      while (numElements)
+         pop_back();
+   }
+
+   //
+   // Status
+   //
+   size_t size()     const { return numElements;      }
+   size_t capacity() const { return N;                }
+   bool   empty()    const { return numElements == 0; }
+
+private:
+
+   T * data()             { return reinterpret_cast<T *>(storage);       }
+   const T * data() const { return reinterpret_cast<const T *>(storage); }
+
+   alignas(T) unsigned char storage[sizeof(T) * N];   // raw room for N elements
+   size_t numElements;
+};
+
+/*************************************************
+ * STATIC P QUEUE
+ * A priority_queue on a static_vector, so the heap
+ * and its sifting are the ones in priority_queue.h.
+ * What this adds is the capacity check: try_push
+ * returns false rather than growing, and try_pop
+ * moves the top item out rather than copying it,
+ * so an item that owns memory is not duplicated on
+ * the way through.
+ *************************************************/
+template <class T, size_t N, class Compare = std::less<T>, size_t Arity = 2>
+class static_priority_queue
+{
+   static_assert(N >= 1, "a static_priority_queue needs room for at least one item");
+
+   friend class ::TestStaticPQueue; // give the unit test class access to the privates
+public:
+
+   //
+   // construct
+   //
+   explicit static_priority_queue(const Compare & c = Compare()) : pq(c) {}
+
+   //
+   // Access
+   //
+   const T & top() const
+   {
+      return pq.top();
+   }
+
+   //
+   // Insert. False when full, and t is left alone
+   //
+   bool try_push(const T & t)
+   {
+      if (full())
+         return false;
+      pq.push(t);
+      return true;
+   }
+   bool try_push(T && t)
+   {
+      if (full())
+         return false;
+      pq.push(std::move(t));
+      return true;
+   }
+
+   //
+   // Remove. try_pop moves the top into t; false when empty
+   //
+   void pop()
+   {
+      pq.pop();
+   }
+   bool try_pop(T & t)
+   {
+      return pq.try_pop(t);
+   }
+
+   //
+   // Status
+   //
+   size_t size()     const { return pq.size();  }
+   bool   empty()    const { return pq.empty(); }
+   bool   full()     const { return pq.size() == N; }
+   size_t capacity() const { return N; }
+
+private:
+
+   priority_queue<T, static_vector<T, N>, Compare, Arity> pq;
+};
+
+}; // namespace custom
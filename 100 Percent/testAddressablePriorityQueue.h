@@ -0,0 +1,368 @@
+/***********************************************************************
+ * Header:
+ *    TEST ADDRESSABLE PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the addressable priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "addressable_priority_queue.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <functional>
+
+#undef assertHeap
+#define assertHeap(x) assertHeapParameters(x, __LINE__, __FUNCTION__)
+
+class TestAddressablePQueue : public UnitTest
+{
+   typedef custom::addressable_priority_queue <int> ::handle handle;
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Insert
+      test_push_handles();
+      test_update_increase();
+      test_update_decrease();
+      test_update_compare();
+
+      // Remove
+      test_pop_handles();
+      test_erase_middle();
+      test_erase_last();
+      test_erase_invalid();
+      test_push_reuseHandle();
+      test_push_staleHandle();
+
+      // Stress
+      test_random_operations();
+
+      report("AddressablePQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::addressable_priority_queue <int> pq;
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.size() == 0);
+      assertUnit(pq.contains(handle{ 0, 0 }) == false);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // every pushed item is found again through its handle
+   void test_push_handles()
+   {  // setup
+      custom::addressable_priority_queue <int> pq;
+      handle h[7];
+      // exercise
+      setupStandardFixture(pq, h);
+      // verify
+      //                10
+      //          8            9
+      //       4     3      7     5
+      assertStandardFixture(pq);
+      assertUnit(pq.get(h[0]) == 10);
+      assertUnit(pq.get(h[3]) == 4);
+      assertUnit(pq.get(h[6]) == 5);
+      assertUnit(pq.topHandle() == h[0]);
+   }  // teardown
+
+   /***************************************
+    * UPDATE
+    ***************************************/
+
+   // a leaf becomes the biggest item
+   void test_update_increase()
+   {  // setup
+      custom::addressable_priority_queue <int> pq;
+      handle h[7];
+      setupStandardFixture(pq, h);
+      // exercise
+      pq.update(h[3] /*4*/, 20);
+      // verify
+      //                20
+      //          10           9
+      //       8     3      7     5
+      assertUnit(pq.top() == 20);
+      assertUnit(pq.topHandle() == h[3]);
+      assertUnit(pq.get(h[1]) == 8);
+      assertUnit(pq.container[1] == 10);
+      assertUnit(pq.container[3] == 8);
+      assertHeap(pq);
+   }  // teardown
+
+   // the top becomes the smallest item
+   void test_update_decrease()
+   {  // setup
+      custom::addressable_priority_queue <int> pq;
+      handle h[7];
+      setupStandardFixture(pq, h);
+      // exercise
+      pq.update(h[0] /*10*/, 1);
+      // verify
+      //                9
+      //          8            7
+      //       4     3      1     5
+      assertUnit(pq.top() == 9);
+      assertUnit(pq.topHandle() == h[2]);
+      assertUnit(pq.get(h[0]) == 1);
+      assertUnit(pq.container[5] == 1);
+      assertHeap(pq);
+   }  // teardown
+
+   // with std::greater the smallest is on top, and updates follow it
+   void test_update_compare()
+   {  // setup
+      custom::addressable_priority_queue <int, std::greater<int> > pq;
+      custom::addressable_priority_queue <int, std::greater<int> > ::handle h[5];
+      for (int i = 0; i < 5; i++)
+         h[i] = pq.push(10 * (i + 1));
+      // exercise
+      pq.update(h[4] /*50*/, 5);
+      pq.update(h[0] /*10*/, 60);
+      // verify
+      assertUnit(pq.top() == 5);
+      assertUnit(pq.topHandle() == h[4]);
+      pq.pop();
+      assertUnit(pq.top() == 20);
+      assertUnit(pq.topHandle() == h[1]);
+      assertUnit(pq.get(h[0]) == 60);
+   }  // teardown
+
+   /***************************************
+    * POP / ERASE
+    ***************************************/
+
+   // popping the top invalidates its handle only
+   void test_pop_handles()
+   {  // setup
+      custom::addressable_priority_queue <int> pq;
+      handle h[7];
+      setupStandardFixture(pq, h);
+      // exercise
+      pq.pop();
+      // verify
+      assertUnit(pq.size() == 6);
+      assertUnit(pq.top() == 9);
+      assertUnit(pq.contains(h[0]) == false);
+      for (int i = 1; i < 7; i++)
+         assertUnit(pq.contains(h[i]));
+      assertHeap(pq);
+   }  // teardown
+
+   // erase an item from the middle of the heap
+   void test_erase_middle()
+   {  // setup
+      custom::addressable_priority_queue <int> pq;
+      handle h[7];
+      setupStandardFixture(pq, h);
+      // exercise
+      pq.erase(h[1] /*8*/);
+      // verify
+      //                10
+      //          5            9
+      //       4     3      7
+      assertUnit(pq.size() == 6);
+      assertUnit(pq.contains(h[1]) == false);
+      assertUnit(pq.get(h[6]) == 5);
+      assertUnit(pq.container[1] == 5);
+      assertHeap(pq);
+   }  // teardown
+
+   // erase the item in the last slot
+   void test_erase_last()
+   {  // setup
+      custom::addressable_priority_queue <int> pq;
+      handle h[7];
+      setupStandardFixture(pq, h);
+      // exercise
+      pq.erase(h[6] /*5*/);
+      // verify
+      assertUnit(pq.size() == 6);
+      assertUnit(pq.contains(h[6]) == false);
+      assertHeap(pq);
+   }  // teardown
+
+   // erase a handle that is not there
+   void test_erase_invalid()
+   {  // setup
+      custom::addressable_priority_queue <int> pq;
+      handle h[7];
+      setupStandardFixture(pq, h);
+      pq.erase(h[2]);
+      // exercise
+      try
+      {
+         pq.erase(h[2]);
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:out_of_range"));
+      }
+      assertUnit(pq.size() == 6);
+   }  // teardown
+
+   // a freed slot is given out again, in a new generation
+   void test_push_reuseHandle()
+   {  // setup
+      custom::addressable_priority_queue <int> pq;
+      handle h[7];
+      setupStandardFixture(pq, h);
+      pq.erase(h[4]);
+      // exercise
+      handle hNew = pq.push(6);
+      // verify
+      assertUnit(hNew.slot == h[4].slot);
+      assertUnit(hNew != h[4]);
+      assertUnit(pq.get(hNew) == 6);
+      assertUnit(pq.positions.size() == 7);
+      assertHeap(pq);
+   }  // teardown
+
+   // a handle kept after its item is gone does not find the item in its slot now
+   void test_push_staleHandle()
+   {  // setup
+      custom::addressable_priority_queue <int> pq;
+      handle h[7];
+      setupStandardFixture(pq, h);
+      pq.pop();
+      handle hNew = pq.push(1);
+      // exercise
+      bool isContained = pq.contains(h[0]);
+      bool isGetThrown = false;
+      bool isUpdateThrown = false;
+      bool isEraseThrown = false;
+      try { pq.get(h[0]); } catch (const char *) { isGetThrown = true; }
+      try { pq.update(h[0], 20); } catch (const char *) { isUpdateThrown = true; }
+      try { pq.erase(h[0]); } catch (const char *) { isEraseThrown = true; }
+      // verify
+      assertUnit(hNew.slot == h[0].slot);
+      assertUnit(isContained == false);
+      assertUnit(isGetThrown);
+      assertUnit(isUpdateThrown);
+      assertUnit(isEraseThrown);
+      assertUnit(pq.get(hNew) == 1);
+      assertUnit(pq.size() == 7);
+      assertHeap(pq);
+   }  // teardown
+
+   /***************************************
+    * STRESS
+    ***************************************/
+
+   // a long mix of operations keeps the heap and the handles consistent
+   void test_random_operations()
+   {  // setup
+      custom::addressable_priority_queue <int, std::less<int>, 4> pq;
+      custom::addressable_priority_queue <int, std::less<int>, 4> ::handle live[64];
+      int numLive = 0;
+      unsigned int seed = 12345;
+      // exercise
+      for (int i = 0; i < 2000; i++)
+      {
+         seed = seed * 1103515245 + 12345;
+         unsigned int r = (seed >> 8) % 100;
+         if (numLive == 0 || (r < 40 && numLive < 64))
+            live[numLive++] = pq.push((int)(seed % 1000));
+         else if (r < 70)
+            pq.update(live[r % numLive], (int)((seed >> 4) % 1000));
+         else if (r < 85)
+         {
+            int iGone = r % numLive;
+            pq.erase(live[iGone]);
+            live[iGone] = live[--numLive];
+         }
+         else
+         {
+            custom::addressable_priority_queue <int, std::less<int>, 4> ::handle hTop = pq.topHandle();
+            pq.pop();
+            for (int j = 0; j < numLive; j++)
+               if (live[j] == hTop)
+                  live[j] = live[--numLive];
+         }
+      }
+      // verify
+      assertUnit(pq.size() == (size_t)numLive);
+      for (int j = 0; j < numLive; j++)
+         assertUnit(pq.contains(live[j]));
+      assertHeap(pq);
+   }  // teardown
+
+   /***************************************************
+    * SETUP STANDARD FIXTURE
+    *                 10
+    *           8            9
+    *        4     3      7     5
+    ***************************************************/
+   void setupStandardFixture(custom::addressable_priority_queue <int>& pq, handle h[7])
+   {
+      int values[7] = {10, 8, 9, 4, 3, 7, 5};
+      for (int i = 0; i < 7; i++)
+         h[i] = pq.push(values[i]);
+   }
+
+   /***************************************************
+    * VERIFY STANDARD FIXTURE
+    ***************************************************/
+   void assertStandardFixtureParameters(const custom::addressable_priority_queue <int>& pq, int line, const char* function)
+   {
+      assertIndirect(pq.container.size() == 7);
+      if (pq.container.size() >= 7)
+      {
+         assertIndirect(pq.container[0] == int(10));
+         assertIndirect(pq.container[1] == int(8));
+         assertIndirect(pq.container[2] == int(9));
+         assertIndirect(pq.container[3] == int(4));
+         assertIndirect(pq.container[4] == int(3));
+         assertIndirect(pq.container[5] == int(7));
+         assertIndirect(pq.container[6] == int(5));
+      }
+   }
+
+   /***************************************************
+    * VERIFY HEAP
+    * Every parent is at least as big as its children and
+    * every slot points back at its own heap position
+    ***************************************************/
+   template <size_t Arity>
+   void assertHeapParameters(const custom::addressable_priority_queue <int, std::less<int>, Arity>& pq, int line, const char* function)
+   {
+      bool isHeap = true;
+      bool isIndexed = pq.slots.size() == pq.container.size();
+      for (size_t i = 0; i < pq.container.size(); i++)
+      {
+         if (i != 0 && pq.container[(i - 1) / Arity] < pq.container[i])
+            isHeap = false;
+         if (isIndexed && pq.positions[pq.slots[i]] != i)
+            isIndexed = false;
+      }
+      assertIndirect(isHeap);
+      assertIndirect(isIndexed);
+   }
+};
+
+#endif // DEBUG
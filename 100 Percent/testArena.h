@@ -0,0 +1,197 @@
+/***********************************************************************
+ * Header:
+ *    TEST ARENA
+ * Summary:
+ *    Unit tests for the arena, and for vector and priority_queue
+ *    allocating from one
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "arena.h"
+#include "vector.h"
+#include "priority_queue.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+
+
+class TestArena : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Allocate
+      test_allocate_aligned();
+      test_allocate_bump();
+      test_allocate_newBlock();
+      test_allocate_buffer();
+
+      // Release
+      test_release_startOver();
+
+      // Vector
+      test_vector_arena();
+      test_vector_copyKeepsArena();
+
+      // Priority queue
+      test_pqueue_arena();
+
+      report("Arena");
+   }
+
+   /***************************************
+    * ALLOCATE
+    ***************************************/
+
+   // whatever came before, the alignment asked for is met
+   void test_allocate_aligned()
+   {  // setup
+      custom::arena a;
+      // exercise
+      void * p1  = a.allocate(1, 1);
+      void * p8  = a.allocate(3, 8);
+      void * p16 = a.allocate(5, 16);
+      void * p64 = a.allocate(7, 64);
+      // verify
+      assertUnit(p1 != nullptr);
+      assertUnit((uintptr_t)p8  % 8  == 0);
+      assertUnit((uintptr_t)p16 % 16 == 0);
+      assertUnit((uintptr_t)p64 % 64 == 0);
+      assertUnit(a.blocks() == 1);
+   }  // teardown
+
+   // small requests come one after the other from the same block
+   void test_allocate_bump()
+   {  // setup
+      custom::arena a;
+      // exercise
+      char * p1 = (char *)a.allocate(16, 8);
+      char * p2 = (char *)a.allocate(16, 8);
+      // verify
+      assertUnit(p2 == p1 + 16);
+      assertUnit(a.blocks() == 1);
+   }  // teardown
+
+   // too big for what is left: a new, bigger block
+   void test_allocate_newBlock()
+   {  // setup
+      custom::arena a(256);
+      a.allocate(100, 8);
+      // exercise
+      char * p = (char *)a.allocate(10000, 8);
+      p[9999] = 'x';
+      // verify
+      assertUnit(a.blocks() == 2);
+      assertUnit(a.sizeNext > 10000);
+   }  // teardown
+
+   // what fits in the caller's buffer never goes to the heap
+   void test_allocate_buffer()
+   {  // setup
+      alignas(16) char buffer[4096];
+      custom::arena a(buffer, sizeof(buffer));
+      // exercise
+      char * p = (char *)a.allocate(1000, 16);
+      // verify
+      assertUnit(p >= buffer && p + 1000 <= buffer + sizeof(buffer));
+      assertUnit(a.blocks() == 0);
+   }  // teardown
+
+   /***************************************
+    * RELEASE
+    ***************************************/
+
+   // every heap block goes, and the buffer is used again from the start
+   void test_release_startOver()
+   {  // setup
+      alignas(16) char buffer[64];
+      custom::arena a(buffer, sizeof(buffer));
+      char * pFirst = (char *)a.allocate(32, 16);
+      a.allocate(1000, 16);
+      a.allocate(5000, 16);
+      // exercise
+      a.release();
+      // verify
+      assertUnit(a.blocks() == 0);
+      assertUnit(a.pBlocks == nullptr);
+      assertUnit((char *)a.allocate(32, 16) == pFirst);
+   }  // teardown
+
+   /***************************************
+    * VECTOR
+    ***************************************/
+
+   // a vector grows inside the arena, and still destroys its elements
+   void test_vector_arena()
+   {  // setup
+      alignas(16) char buffer[8192];
+      custom::arena a(buffer, sizeof(buffer));
+      Spy::reset();
+      // exercise
+      {
+         custom::vector <Spy, custom::arena_allocator<Spy> > v((custom::arena_allocator<Spy>(a)));
+         for (int i = 0; i < 100; i++)
+            v.push_back(Spy(i));
+         // verify
+         assertUnit(v.size() == 100);
+         assertUnit((char *)&v[0] >= buffer && (char *)&v[99] < buffer + sizeof(buffer));
+         assertUnit(v[99].get() == 99);
+      }
+      assertUnit(a.blocks() == 0);
+      assertUnit(Spy::numNondefault() + Spy::numCopyMove() == Spy::numDestructor());
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   // a copy allocates from the same arena
+   void test_vector_copyKeepsArena()
+   {  // setup
+      custom::arena a;
+      custom::vector <int, custom::arena_allocator<int> > v((custom::arena_allocator<int>(a)));
+      for (int i = 0; i < 10; i++)
+         v.push_back(i);
+      // exercise
+      custom::vector <int, custom::arena_allocator<int> > vCopy(v);
+      // verify
+      assertUnit(vCopy.get_allocator() == v.get_allocator());
+      assertUnit(vCopy.size() == 10);
+      assertUnit(vCopy[9] == 9);
+      assertUnit(&vCopy[0] != &v[0]);
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // the queue hands the allocator to its container
+   void test_pqueue_arena()
+   {  // setup
+      custom::arena a(64);
+      custom::priority_queue <int, custom::vector<int, custom::arena_allocator<int> > >
+         pq((custom::arena_allocator<int>(a)));
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 263) % 1000);
+      bool inOrder = true;
+      for (int expect = 999; expect >= 0; expect--)
+      {
+         if (pq.top() != expect)
+            inOrder = false;
+         pq.pop();
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(a.blocks() > 0);
+   }  // teardown
+};
+
+#endif // DEBUG
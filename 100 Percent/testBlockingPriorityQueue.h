@@ -0,0 +1,315 @@
+/***********************************************************************
+ * Header:
+ *    TEST BLOCKING PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the bounded, blocking priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "blocking_priority_queue.h"
+#include "vector.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+
+class TestBlockingPQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_capacity();
+
+      // Insert
+      test_tryPush_full();
+      test_push_waitsForRoom();
+
+      // Remove
+      test_popWait_timeout();
+      test_popWait_woken();
+      test_popBatch_biggestFirst();
+      test_popBatch_empty();
+      test_popBatch_noDefault();
+
+      // Wakeups
+      test_notify_burstCoalesced();
+
+      // Threads
+      test_threads_pipeline();
+
+      report("BlockingPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // room for at least one
+   void test_construct_capacity()
+   {  // setup
+      // exercise
+      custom::blocking_priority_queue <int> pq(10);
+      custom::blocking_priority_queue <int> pqNone(0);
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.capacity() == 10);
+      assertUnit(pqNone.capacity() == 1);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // no room, no push
+   void test_tryPush_full()
+   {  // setup
+      custom::blocking_priority_queue <int> pq(2);
+      // exercise
+      bool isFirst  = pq.try_push(1);
+      bool isSecond = pq.try_push(2);
+      bool isThird  = pq.try_push(3);
+      // verify
+      assertUnit(isFirst);
+      assertUnit(isSecond);
+      assertUnit(!isThird);
+      assertUnit(pq.size() == 2);
+   }  // teardown
+
+   // push on a full queue sleeps until a pop makes room
+   void test_push_waitsForRoom()
+   {  // setup
+      custom::blocking_priority_queue <int> pq(1);
+      pq.push(5);
+      std::atomic<bool> isPushed(false);
+      std::thread producer([&pq, &isPushed]()
+      {
+         pq.push(7);
+         isPushed = true;
+      });
+      waitFor([&pq]() { std::lock_guard<std::mutex> guard(pq.lock); return pq.numWaitingPush == 1; });
+      bool isPushedEarly = isPushed;
+      // exercise
+      int value = 0;
+      bool isPopped = pq.pop_wait(value, std::chrono::seconds(1));
+      producer.join();
+      // verify
+      assertUnit(!isPushedEarly);
+      assertUnit(isPopped);
+      assertUnit(value == 5);
+      assertUnit(isPushed);
+      assertUnit(pq.size() == 1);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // nothing comes: give up after the timeout
+   void test_popWait_timeout()
+   {  // setup
+      custom::blocking_priority_queue <int> pq(4);
+      int value = 99;
+      std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+      // exercise
+      bool isPopped = pq.pop_wait(value, std::chrono::milliseconds(20));
+      // verify
+      assertUnit(!isPopped);
+      assertUnit(value == 99);
+      assertUnit(std::chrono::steady_clock::now() - begin >= std::chrono::milliseconds(20));
+      assertUnit(pq.numWaitingPop == 0);
+   }  // teardown
+
+   // a push wakes the waiting consumer
+   void test_popWait_woken()
+   {  // setup
+      custom::blocking_priority_queue <int> pq(4);
+      int value = 0;
+      bool isPopped = false;
+      std::thread consumer([&pq, &value, &isPopped]()
+      {
+         isPopped = pq.pop_wait(value, std::chrono::seconds(10));
+      });
+      waitFor([&pq]() { std::lock_guard<std::mutex> guard(pq.lock); return pq.numWaitingPop == 1; });
+      // exercise
+      pq.push(42);
+      consumer.join();
+      // verify
+      assertUnit(isPopped);
+      assertUnit(value == 42);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // up to n, biggest first, added to what is there
+   void test_popBatch_biggestFirst()
+   {  // setup
+      custom::blocking_priority_queue <int> pq(10);
+      int values[] = {4, 9, 1, 7, 3};
+      for (int value : values)
+         pq.push(value);
+      custom::vector <int> items;
+      items.push_back(100);
+      // exercise
+      size_t numTaken = pq.pop_batch(items, 3);
+      // verify
+      assertUnit(numTaken == 3);
+      assertUnit(items.size() == 4);
+      if (items.size() == 4)
+      {
+         assertUnit(items[0] == 100);
+         assertUnit(items[1] == 9);
+         assertUnit(items[2] == 7);
+         assertUnit(items[3] == 4);
+      }
+      assertUnit(pq.size() == 2);
+   }  // teardown
+
+   // an empty queue gives nothing, at once by default
+   void test_popBatch_empty()
+   {  // setup
+      custom::blocking_priority_queue <int> pq(10);
+      custom::vector <int> items;
+      // exercise
+      size_t numTaken = pq.pop_batch(items, 8);
+      // verify
+      assertUnit(numTaken == 0);
+      assertUnit(items.size() == 0);
+   }  // teardown
+
+   // an item with no default constructor can still be taken in a batch
+   void test_popBatch_noDefault()
+   {  // setup
+      custom::blocking_priority_queue <Ticket> pq(10);
+      pq.push(Ticket(4));
+      pq.push(Ticket(9));
+      pq.push(Ticket(1));
+      custom::vector <Ticket> items;
+      // exercise
+      size_t numTaken = pq.pop_batch(items, 2);
+      // verify
+      assertUnit(numTaken == 2);
+      assertUnit(items.size() == 2);
+      if (items.size() == 2)
+      {
+         assertUnit(items[0].number == 9);
+         assertUnit(items[1].number == 4);
+      }
+      assertUnit(pq.size() == 1);
+   }  // teardown
+
+   /***************************************
+    * WAKEUPS
+    ***************************************/
+
+   // a burst of pushes wakes each sleeping consumer, and each takes one item
+   void test_notify_burstCoalesced()
+   {  // setup
+      const int numConsumers = 3;
+      custom::blocking_priority_queue <int> pq(1000);
+      std::atomic<int> numPopped(0);
+      std::thread consumers[numConsumers];
+      for (int c = 0; c < numConsumers; c++)
+         consumers[c] = std::thread([&pq, &numPopped]()
+         {
+            int value;
+            if (pq.pop_wait(value, std::chrono::seconds(10)))
+               numPopped++;
+         });
+      waitFor([&pq]() { std::lock_guard<std::mutex> guard(pq.lock); return pq.numWaitingPop == 3; });
+      // exercise
+      {
+         std::lock_guard<std::mutex> guard(pq.lock);
+         for (int i = 0; i < 100; i++)
+         {
+            pq.heap.push(i);
+            pq.notifyPushed();
+         }
+      }
+      for (int c = 0; c < numConsumers; c++)
+         consumers[c].join();
+      // verify
+      assertUnit(numPopped == numConsumers);
+      assertUnit(pq.size() == 100 - numConsumers);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // producers into a small queue, consumers in batches: every item
+   // gets through exactly once, and the queue never overfills
+   void test_threads_pipeline()
+   {  // setup
+      const int numProducers = 4;
+      const int numConsumers = 4;
+      const int numEach = 5000;
+      custom::blocking_priority_queue <int> pq(16);
+      custom::vector <int> seen(numProducers * numEach, 0);
+      custom::vector <int> popped[numConsumers];
+      std::atomic<int> numLeft(numProducers * numEach);
+      std::atomic<bool> isOverfull(false);
+      // exercise
+      std::thread producers[numProducers];
+      std::thread consumers[numConsumers];
+      for (int p = 0; p < numProducers; p++)
+         producers[p] = std::thread([&pq, p, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+               pq.push(p * numEach + i);
+         });
+      for (int c = 0; c < numConsumers; c++)
+         consumers[c] = std::thread([&pq, &popped, &numLeft, &isOverfull, c]()
+         {
+            while (numLeft > 0)
+            {
+               if (pq.size() > pq.capacity())
+                  isOverfull = true;
+               numLeft -= (int)pq.pop_batch(popped[c], 8, std::chrono::milliseconds(1));
+            }
+         });
+      for (int p = 0; p < numProducers; p++)
+         producers[p].join();
+      for (int c = 0; c < numConsumers; c++)
+         consumers[c].join();
+      // verify
+      for (int c = 0; c < numConsumers; c++)
+         for (size_t i = 0; i < popped[c].size(); i++)
+            seen[popped[c][i]]++;
+      bool isOnce = true;
+      for (int i = 0; i < numProducers * numEach; i++)
+         if (seen[i] != 1)
+            isOnce = false;
+      assertUnit(isOnce);
+      assertUnit(!isOverfull);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // spin until another thread has got somewhere
+   template <class Condition>
+   void waitFor(Condition condition)
+   {
+      while (!condition())
+         std::this_thread::yield();
+   }
+
+   // an item that can only be made from a number
+   struct Ticket
+   {
+      explicit Ticket(int number) : number(number) {}
+      bool operator < (const Ticket & rhs) const { return number < rhs.number; }
+      int number;
+   };
+};
+
+#endif // DEBUG
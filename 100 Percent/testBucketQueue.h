@@ -0,0 +1,310 @@
+/***********************************************************************
+ * Header:
+ *    TEST BUCKET QUEUE
+ * Summary:
+ *    Unit tests for the bucket queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "bucket_queue.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <string>
+
+
+class TestBucketQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_small();
+      test_constructRange_standard();
+      test_constructMoveInit_standard();
+      test_constructCopy_standard();
+
+      // Assign
+      test_swap_standardEmpty();
+
+      // Access
+      test_top_empty();
+
+      // Insert
+      test_push_bitmap();
+      test_push_outOfRange();
+
+      // Remove
+      test_pop_ordered();
+      test_pop_runDry();
+      test_pop_steady();
+      test_pop_highLevels();
+
+      report("BucketQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::bucket_queue <> bq;
+      // verify
+      assertUnit(bq.empty());
+      assertUnit(bq.size() == 0);
+      assertUnit(bq.summary == 0);
+   }  // teardown
+
+   // an empty queue takes nothing from the heap and little room inline
+   void test_construct_small()
+   {  // setup
+      // exercise
+      custom::bucket_queue <> bq;
+      // verify
+      assertUnit(bq.counts.capacity() == 0);
+      assertUnit(sizeof(bq) < 128);
+   }  // teardown
+
+   // bucket_queue({10, 8, 9, 4, 3, 7, 5})
+   void test_constructRange_standard()
+   {  // setup
+      std::initializer_list<int> il{10, 8, 9, 4, 3, 7, 5};
+      // exercise
+      custom::bucket_queue <> bq(il.begin(), il.end());
+      // verify
+      assertStandardFixture(bq);
+   }  // teardown
+
+   // bucket_queue(move([10, 8, 9, 4, 3, 7, 5]))
+   void test_constructMoveInit_standard()
+   {  // setup
+      custom::vector <int> v{10, 8, 9, 4, 3, 7, 5};
+      // exercise
+      custom::bucket_queue <> bq(std::move(v));
+      // verify
+      assertStandardFixture(bq);
+      assertUnit(v.size() == 0);
+   }  // teardown
+
+   // copy constructor makes an independent queue
+   void test_constructCopy_standard()
+   {  // setup
+      custom::bucket_queue <> bqSrc;
+      setupStandardFixture(bqSrc);
+      // exercise
+      custom::bucket_queue <> bqDest(bqSrc);
+      // verify
+      bqSrc.pop();
+      assertUnit(bqSrc.size() == 6);
+      assertStandardFixture(bqDest);
+   }  // teardown
+
+   /***************************************
+    * SWAP
+    ***************************************/
+
+   // swap(standard, empty)
+   void test_swap_standardEmpty()
+   {  // setup
+      custom::bucket_queue <> bqLHS;
+      setupStandardFixture(bqLHS);
+      custom::bucket_queue <> bqRHS;
+      // exercise
+      swap(bqLHS, bqRHS);
+      // verify
+      assertUnit(bqLHS.empty());
+      assertUnit(bqLHS.summary == 0);
+      assertStandardFixture(bqRHS);
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty queue
+   void test_top_empty()
+   {  // setup
+      custom::bucket_queue <> bq;
+      // exercise
+      try
+      {
+         bq.top();
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:out_of_range"));
+      }
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // push sets the bit of the bucket and of its word
+   void test_push_bitmap()
+   {  // setup
+      custom::bucket_queue <> bq;
+      // exercise
+      bq.push(3);
+      bq.push(3);
+      bq.push(130);
+      // verify
+      //   words[0] = ...1000   words[2] = ...0100   summary = 101
+      assertUnit(bq.size() == 3);
+      assertUnit(bq.words[0] == (1ull << 3));
+      assertUnit(bq.words[1] == 0);
+      assertUnit(bq.words[2] == (1ull << 2));
+      assertUnit(bq.summary == 5);
+      assertUnit(bq.counts[3] == 2);
+      assertUnit(bq.top() == 130);
+   }  // teardown
+
+   // a priority that has no bucket
+   void test_push_outOfRange()
+   {  // setup
+      custom::bucket_queue <int, 16> bq;
+      // exercise
+      try
+      {
+         bq.push(16);
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:out_of_range"));
+      }
+      assertUnit(bq.empty());
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // items come out biggest first
+   void test_pop_ordered()
+   {  // setup
+      custom::bucket_queue <> bq;
+      for (int i = 0; i < 1000; i++)
+         bq.push((i * 37) % 256);
+      // exercise
+      bool inOrder = true;
+      int previous = 255;
+      while (!bq.empty())
+      {
+         if (bq.top() > previous)
+            inOrder = false;
+         previous = bq.top();
+         bq.pop();
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(bq.summary == 0);
+   }  // teardown
+
+   // popping a bucket dry clears its bit and moves the top down
+   void test_pop_runDry()
+   {  // setup
+      custom::bucket_queue <> bq;
+      bq.push(70);
+      bq.push(70);
+      bq.push(5);
+      // exercise
+      bq.pop();
+      assertUnit(bq.counts[70] == 1);
+      assertUnit(bq.top() == 70);
+      bq.pop();
+      // verify
+      assertUnit(bq.counts[70] == 0);
+      assertUnit(bq.words[1] == 0);
+      assertUnit(bq.summary == 1);
+      assertUnit(bq.top() == 5);
+   }  // teardown
+
+   // a bucket that never runs dry only ever holds its count
+   void test_pop_steady()
+   {  // setup
+      custom::bucket_queue <int, 8> bq;
+      bq.push(7);
+      bq.push(7);
+      bq.push(7);
+      // exercise
+      for (int i = 0; i < 100000; i++)
+      {
+         bq.pop();
+         bq.push(7);
+      }
+      // verify
+      assertUnit(bq.size() == 3);
+      assertUnit(bq.counts[7] == 3);
+      assertUnit(bq.top() == 7);
+   }  // teardown
+
+   // more levels than one word of the bitmap holds
+   void test_pop_highLevels()
+   {  // setup
+      custom::bucket_queue <int, 4096> bq;
+      bq.push(4095);
+      bq.push(0);
+      bq.push(2048);
+      // exercise
+      int first = bq.top();
+      bq.pop();
+      int second = bq.top();
+      bq.pop();
+      int third = bq.top();
+      bq.pop();
+      // verify
+      assertUnit(first == 4095);
+      assertUnit(second == 2048);
+      assertUnit(third == 0);
+      assertUnit(bq.empty());
+   }  // teardown
+
+   /***************************************************
+    * SETUP STANDARD FIXTURE
+    *    {10, 8, 9, 4, 3, 7, 5}
+    ***************************************************/
+   void setupStandardFixture(custom::bucket_queue <>& bq)
+   {
+      int values[7] = {10, 8, 9, 4, 3, 7, 5};
+      for (int value : values)
+         bq.push(value);
+   }
+
+   /***************************************************
+    * VERIFY STANDARD FIXTURE
+    * Drains a copy, so the fixture itself is untouched
+    ***************************************************/
+   void assertStandardFixtureParameters(const custom::bucket_queue <>& bq, int line, const char* function)
+   {
+      assertIndirect(bq.size() == 7);
+      custom::bucket_queue <> bqCopy(bq);
+      int sorted[] = {10, 9, 8, 7, 5, 4, 3};
+      bool inOrder = true;
+      for (int value : sorted)
+      {
+         if (bqCopy.empty() || bqCopy.top() != value)
+            inOrder = false;
+         bqCopy.pop();
+      }
+      assertIndirect(inOrder);
+      assertIndirect(bqCopy.empty());
+   }
+};
+
+#endif // DEBUG
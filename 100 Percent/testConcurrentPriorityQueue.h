@@ -0,0 +1,228 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the concurrent priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrent_priority_queue.h"
+#include "vector.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <string>
+#include <thread>
+
+
+class TestConcurrentPQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_capacity();
+
+      // Insert
+      test_push_bitReversed();
+      test_push_full();
+
+      // Remove
+      test_pop_empty();
+      test_pop_ordered();
+
+      // Threads
+      test_threads_noneLostOrTwice();
+      test_threads_drainInOrder();
+
+      report("ConcurrentPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // the capacity is whole levels
+   void test_construct_capacity()
+   {  // setup
+      // exercise
+      custom::concurrent_priority_queue <int> pq(10);
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.capacity() == 15);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // a level is filled in bit-reversed order
+   void test_push_bitReversed()
+   {  // setup
+      typedef custom::concurrent_priority_queue <int> PQ;
+      // exercise
+      // verify
+      //   level 2 is 4..7, filled 4 6 5 7
+      assertUnit(PQ::indexOf(1) == 1);
+      assertUnit(PQ::indexOf(2) == 2);
+      assertUnit(PQ::indexOf(3) == 3);
+      assertUnit(PQ::indexOf(4) == 4);
+      assertUnit(PQ::indexOf(5) == 6);
+      assertUnit(PQ::indexOf(6) == 5);
+      assertUnit(PQ::indexOf(7) == 7);
+      assertUnit(PQ::indexOf(9) == 12);
+   }  // teardown
+
+   // no room for another
+   void test_push_full()
+   {  // setup
+      custom::concurrent_priority_queue <int> pq(3);
+      pq.push(1);
+      pq.push(2);
+      pq.push(3);
+      // exercise
+      try
+      {
+         pq.push(4);
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:length_error"));
+      }
+      assertUnit(pq.size() == 3);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // nothing to pop
+   void test_pop_empty()
+   {  // setup
+      custom::concurrent_priority_queue <int> pq(8);
+      int value = 99;
+      // exercise
+      bool isPopped = pq.try_pop(value);
+      // verify
+      assertUnit(!isPopped);
+      assertUnit(value == 99);
+   }  // teardown
+
+   // one thread: biggest first, every slot tagged as it should be
+   void test_pop_ordered()
+   {  // setup
+      custom::concurrent_priority_queue <int> pq(1000);
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 263) % 1000);
+      bool isAvailable = true;
+      for (size_t i = 1; i <= 1000; i++)
+         if (pq.nodes[PQ_indexOf(i)].tag != 1)
+            isAvailable = false;
+      // exercise
+      bool inOrder = true;
+      for (int expect = 999; expect >= 0; expect--)
+      {
+         int value = -1;
+         if (!pq.try_pop(value) || value != expect)
+            inOrder = false;
+      }
+      // verify
+      assertUnit(isAvailable);
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // pushes and pops at once: every item comes out exactly once
+   void test_threads_noneLostOrTwice()
+   {  // setup
+      const int numThreads = 8;
+      const int numEach = 5000;
+      custom::concurrent_priority_queue <int> pq(numThreads * numEach);
+      custom::vector <int> seen(numThreads * numEach, 0);
+      custom::vector <int> popped[numThreads];
+      // exercise
+      std::thread threads[numThreads];
+      for (int t = 0; t < numThreads; t++)
+         threads[t] = std::thread([&pq, &popped, t, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+            {
+               pq.push(t * numEach + i);
+               int value;
+               if (i % 2 && pq.try_pop(value))
+                  popped[t].push_back(value);
+            }
+         });
+      for (int t = 0; t < numThreads; t++)
+         threads[t].join();
+      int value;
+      while (pq.try_pop(value))
+         popped[0].push_back(value);
+      // verify
+      for (int t = 0; t < numThreads; t++)
+         for (size_t i = 0; i < popped[t].size(); i++)
+            seen[popped[t][i]]++;
+      bool isOnce = true;
+      for (int i = 0; i < numThreads * numEach; i++)
+         if (seen[i] != 1)
+            isOnce = false;
+      assertUnit(isOnce);
+   }  // teardown
+
+   // with nothing being pushed, each thread's pops must come out
+   // biggest first, and between them they must take everything
+   void test_threads_drainInOrder()
+   {  // setup
+      const int numThreads = 8;
+      const int numItems = 40000;
+      custom::concurrent_priority_queue <int> pq(numItems);
+      for (int i = 0; i < numItems; i++)
+         pq.push((int)(((long long)i * 7919) % numItems));
+      custom::vector <int> popped[numThreads];
+      // exercise
+      std::thread threads[numThreads];
+      for (int t = 0; t < numThreads; t++)
+         threads[t] = std::thread([&pq, &popped, t]()
+         {
+            int value;
+            while (pq.try_pop(value))
+               popped[t].push_back(value);
+         });
+      for (int t = 0; t < numThreads; t++)
+         threads[t].join();
+      // verify
+      bool inOrder = true;
+      size_t numPopped = 0;
+      for (int t = 0; t < numThreads; t++)
+      {
+         numPopped += popped[t].size();
+         for (size_t i = 1; i < popped[t].size(); i++)
+            if (!(popped[t][i] < popped[t][i - 1]))
+               inOrder = false;
+      }
+      assertUnit(inOrder);
+      assertUnit(numPopped == (size_t)numItems);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   static size_t PQ_indexOf(size_t number)
+   {
+      return custom::concurrent_priority_queue <int>::indexOf(number);
+   }
+};
+
+#endif // DEBUG
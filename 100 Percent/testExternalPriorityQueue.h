@@ -0,0 +1,406 @@
+/***********************************************************************
+ * Header:
+ *    TEST EXTERNAL PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the external priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "external_priority_queue.h"
+#include "priority_queue.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>    // for getenv
+#include <string>
+
+#ifndef _WIN32
+#include <signal.h>        // for signal, SIGXFSZ
+#include <sys/resource.h>  // for setrlimit, RLIMIT_FSIZE
+#endif
+
+
+class TestExternalPQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_destructor_removesRuns();
+
+      // Access
+      test_top_empty();
+
+      // Insert
+      test_push_underBudget();
+      test_push_spill();
+      test_push_badDirectory();
+      test_push_spillFails();
+
+      // Remove
+      test_pop_ordered();
+      test_pop_interleaved();
+      test_pop_closesRuns();
+
+      // Merge
+      test_merge_manyRuns();
+      test_merge_fails();
+
+      report("ExternalPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, half the budget for the hot heap
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::external_priority_queue <int> pq(4096, tempDirectory(), 256);
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.size() == 0);
+      assertUnit(pq.numHot == 512);
+      assertUnit(pq.numBlock == 64);
+      assertUnit(pq.numRunsMax == 8);
+      assertUnit(pq.runs.size() == 0);
+   }  // teardown
+
+   // the run files go away with the queue
+   void test_destructor_removesRuns()
+   {  // setup
+      std::string path;
+      {
+         custom::external_priority_queue <int> pq(64, tempDirectory(), 16);
+         for (int i = 0; i < 20; i++)
+            pq.push(i);
+         assertUnit(pq.numRunsOpen > 0);
+         if (pq.numRunsOpen > 0)
+            path = pq.runs[0].path;
+         // exercise
+      }
+      // verify
+      assertUnit(!isFile(path));
+   }
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty queue
+   void test_top_empty()
+   {  // setup
+      custom::external_priority_queue <int> pq(1024, tempDirectory());
+      // exercise
+      try
+      {
+         pq.top();
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:out_of_range"));
+      }
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // nothing touches the disk while the hot heap has room
+   void test_push_underBudget()
+   {  // setup
+      custom::external_priority_queue <int> pq(1024, tempDirectory());
+      // exercise
+      for (int i = 0; i < 100; i++)
+         pq.push(i);
+      // verify
+      assertUnit(pq.size() == 100);
+      assertUnit(pq.hot.size() == 100);
+      assertUnit(pq.runs.size() == 0);
+      assertUnit(pq.top() == 99);
+   }  // teardown
+
+   // a full hot heap goes to disk as one sorted run
+   void test_push_spill()
+   {  // setup
+      //   8 ints of hot heap, blocks of 4
+      custom::external_priority_queue <int> pq(64, tempDirectory(), 16);
+      int values[] = {3, 9, 1, 7, 5, 8, 2, 6};
+      for (int value : values)
+         pq.push(value);
+      // exercise
+      pq.push(4);
+      // verify
+      //   run 0 on disk is 9 8 7 6 | 5 3 2 1, its first block is read
+      assertUnit(pq.size() == 9);
+      assertUnit(pq.hot.size() == 1);
+      assertUnit(pq.numRunsOpen == 1);
+      assertUnit(pq.runs.size() == 1);
+      if (pq.runs.size() == 1)
+      {
+         assertUnit(pq.runs[0].sizeBlock == 4);
+         assertUnit(pq.runs[0].block[3] == 6);
+         assertUnit(isFile(pq.runs[0].path));
+      }
+      assertUnit(pq.heads.size() == 1);
+      assertUnit(pq.top() == 9);
+   }  // teardown
+
+   // a directory that is not there
+   void test_push_badDirectory()
+   {  // setup
+      custom::external_priority_queue <int> pq(16, "no/such/directory/anywhere");
+      bool isThrown = false;
+      // exercise
+      try
+      {
+         for (int i = 0; i < 10; i++)
+            pq.push(i);
+      }
+      catch (const char* s)
+      {
+         isThrown = std::string(s) == std::string("std:runtime_error");
+      }
+      // verify
+      assertUnit(isThrown);
+   }  // teardown
+
+   // a run that cannot be written leaves the hot heap as it was
+   void test_push_spillFails()
+   {
+#ifndef _WIN32
+      // setup
+      //   8 ints of hot heap, full
+      custom::external_priority_queue <int> pq(64, tempDirectory(), 16);
+      for (int i = 0; i < 8; i++)
+         pq.push((i * 5) % 8);
+      bool isThrown = false;
+      // exercise
+      limitFileSize(16);
+      try
+      {
+         pq.push(8);
+      }
+      catch (const char* s)
+      {
+         isThrown = std::string(s) == std::string("std:runtime_error");
+      }
+      unlimitFileSize();
+      // verify
+      assertUnit(isThrown);
+      assertUnit(pq.size() == 8);
+      assertUnit(pq.hot.size() == 8);
+      assertUnit(pq.runs.size() == 0);
+      bool inOrder = true;
+      for (int expect = 7; expect >= 0; expect--)
+      {
+         if (pq.empty() || pq.top() != expect)
+            inOrder = false;
+         pq.pop();
+      }
+      assertUnit(inOrder);
+#endif // !_WIN32
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // many spills, drained biggest first
+   void test_pop_ordered()
+   {  // setup
+      custom::external_priority_queue <int> pq(1024, tempDirectory(), 64);
+      for (int i = 0; i < 5000; i++)
+         pq.push((i * 2713) % 5000);
+      // exercise
+      bool inOrder = true;
+      for (int expect = 4999; expect >= 0; expect--)
+      {
+         if (pq.empty() || pq.top() != expect)
+            inOrder = false;
+         pq.pop();
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // pushes between pops agree with priority_queue
+   void test_pop_interleaved()
+   {  // setup
+      custom::external_priority_queue <long long> pqExternal(512, tempDirectory(), 32);
+      custom::priority_queue <long long> pqMemory;
+      // exercise
+      bool same = true;
+      for (long long i = 0; i < 4000; i++)
+      {
+         long long value = (i * 7919) % 1009;
+         pqExternal.push(value);
+         pqMemory.push(value);
+         if (i % 3 == 0)
+         {
+            if (pqExternal.top() != pqMemory.top())
+               same = false;
+            pqExternal.pop();
+            pqMemory.pop();
+         }
+      }
+      while (!pqMemory.empty())
+      {
+         if (pqExternal.empty() || pqExternal.top() != pqMemory.top())
+            same = false;
+         pqExternal.pop();
+         pqMemory.pop();
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(pqExternal.empty());
+   }  // teardown
+
+   // a drained run is closed and its file removed
+   void test_pop_closesRuns()
+   {  // setup
+      custom::external_priority_queue <int> pq(64, tempDirectory(), 16);
+      for (int i = 0; i < 9; i++)
+         pq.push(i);
+      std::string path = pq.runs[0].path;
+      // exercise
+      for (int i = 0; i < 9; i++)
+         pq.pop();
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.numRunsOpen == 0);
+      assertUnit(pq.runs.size() == 0);
+      assertUnit(!isFile(path));
+   }  // teardown
+
+   /***************************************
+    * MERGE
+    ***************************************/
+
+   // never more runs than there are blocks for
+   void test_merge_manyRuns()
+   {  // setup
+      //   8 ints of hot heap and room for 2 blocks of 4
+      custom::external_priority_queue <int> pq(64, tempDirectory(), 16);
+      // exercise
+      bool isCapped = true;
+      for (int i = 0; i < 200; i++)
+      {
+         pq.push((i * 37) % 200);
+         if (pq.numRunsOpen > pq.numRunsMax)
+            isCapped = false;
+      }
+      // verify
+      assertUnit(isCapped);
+      bool inOrder = true;
+      for (int expect = 199; expect >= 0; expect--)
+      {
+         if (pq.empty() || pq.top() != expect)
+            inOrder = false;
+         pq.pop();
+      }
+      assertUnit(inOrder);
+   }  // teardown
+
+   // a merged run that cannot be written leaves the old runs as they were
+   void test_merge_fails()
+   {
+#ifndef _WIN32
+      // setup
+      //   8 ints of hot heap and room for 2 blocks of 4: two runs of 8
+      //   and a full hot heap, so the next push merges
+      custom::external_priority_queue <int> pq(64, tempDirectory(), 16);
+      for (int i = 0; i < 24; i++)
+         pq.push((i * 7) % 24);
+      assertUnit(pq.numRunsOpen == 2);
+      std::string path0 = pq.runs[0].path;
+      bool isThrown = false;
+      // exercise
+      limitFileSize(40);
+      try
+      {
+         pq.push(24);
+      }
+      catch (const char* s)
+      {
+         isThrown = std::string(s) == std::string("std:runtime_error");
+      }
+      unlimitFileSize();
+      // verify
+      assertUnit(isThrown);
+      assertUnit(pq.size() == 24);
+      assertUnit(pq.numRunsOpen == 2);
+      assertUnit(pq.heads.size() == 2);
+      assertUnit(isFile(path0));
+      bool inOrder = true;
+      for (int expect = 23; expect >= 0; expect--)
+      {
+         if (pq.empty() || pq.top() != expect)
+            inOrder = false;
+         pq.pop();
+      }
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+#endif // !_WIN32
+   }  // teardown
+
+#ifndef _WIN32
+   /***************************************************
+    * LIMIT FILE SIZE
+    * Make every write past this many bytes fail
+    ***************************************************/
+   void limitFileSize(rlim_t size)
+   {
+      signal(SIGXFSZ, SIG_IGN);
+      getrlimit(RLIMIT_FSIZE, &limitBefore);
+      struct rlimit limit = limitBefore;
+      limit.rlim_cur = size;
+      setrlimit(RLIMIT_FSIZE, &limit);
+   }
+
+   void unlimitFileSize()
+   {
+      setrlimit(RLIMIT_FSIZE, &limitBefore);
+   }
+
+   struct rlimit limitBefore;
+#endif // !_WIN32
+
+   /***************************************************
+    * TEMP DIRECTORY
+    * Where the tests can put their runs
+    ***************************************************/
+   std::string tempDirectory()
+   {
+      const char * names[] = {"TMPDIR", "TEMP", "TMP"};
+      for (const char * name : names)
+         if (getenv(name))
+            return std::string(getenv(name));
+      return std::string(".");
+   }
+
+   bool isFile(const std::string & path)
+   {
+      FILE * file = fopen(path.c_str(), "rb");
+      if (!file)
+         return false;
+      fclose(file);
+      return true;
+   }
+};
+
+#endif // DEBUG
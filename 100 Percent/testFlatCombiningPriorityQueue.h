@@ -0,0 +1,263 @@
+/***********************************************************************
+ * Header:
+ *    TEST FLAT COMBINING PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the flat combining priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "flat_combining_priority_queue.h"
+#include "vector.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <thread>
+
+
+class TestFlatCombiningPQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_slots();
+
+      // Remove
+      test_pop_empty();
+      test_pop_ordered();
+
+      // Combine
+      test_combine_batch();
+      test_combine_popEmpty();
+
+      // Threads
+      test_threads_noneLostOrTwice();
+      test_threads_drainInOrder();
+      test_threads_moreThanSlots();
+
+      report("FlatCombiningPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // every slot starts free
+   void test_construct_slots()
+   {  // setup
+      // exercise
+      custom::flat_combining_priority_queue <int> pq(8);
+      custom::flat_combining_priority_queue <int> pqNone(0);
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.numSlots == 8);
+      assertUnit(pqNone.numSlots == 1);
+      bool isFree = true;
+      for (size_t i = 0; i < pq.numSlots; i++)
+         if (pq.slots[i].isClaimed.load() || pq.slots[i].state.load() != PQ::FREE)
+            isFree = false;
+      assertUnit(isFree);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // nothing to pop
+   void test_pop_empty()
+   {  // setup
+      custom::flat_combining_priority_queue <int> pq;
+      int value = 99;
+      // exercise
+      bool isPopped = pq.try_pop(value);
+      // verify
+      assertUnit(!isPopped);
+      assertUnit(value == 99);
+      assertUnit(pq.numPasses == 1);
+   }  // teardown
+
+   // one thread: each call is a pass of its own, biggest first
+   void test_pop_ordered()
+   {  // setup
+      custom::flat_combining_priority_queue <int> pq;
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 263) % 1000);
+      // exercise
+      bool inOrder = true;
+      for (int expect = 999; expect >= 0; expect--)
+      {
+         int value = -1;
+         if (!pq.try_pop(value) || value != expect)
+            inOrder = false;
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+      assertUnit(pq.numPasses == 2000);
+   }  // teardown
+
+   /***************************************
+    * COMBINE
+    ***************************************/
+
+   // one pass serves every slot: the pushes first, then the pops
+   void test_combine_batch()
+   {  // setup
+      custom::flat_combining_priority_queue <int> pq(8);
+      int values[] = {4, 9, 1, 7, 3};
+      for (int i = 0; i < 5; i++)
+      {
+         pq.slots[i].value = values[i];
+         pq.slots[i].state.store(PQ::POSTED_PUSH);
+      }
+      pq.slots[5].state.store(PQ::POSTED_POP);
+      pq.slots[6].state.store(PQ::POSTED_POP);
+      // exercise
+      pq.combine();
+      // verify
+      bool isDone = true;
+      for (size_t i = 0; i < 7; i++)
+         if (pq.slots[i].state.load() != PQ::DONE)
+            isDone = false;
+      assertUnit(isDone);
+      assertUnit(pq.slots[7].state.load() == PQ::FREE);
+      assertUnit(pq.slots[5].isPopped);
+      assertUnit(pq.slots[5].value == 9);
+      assertUnit(pq.slots[6].isPopped);
+      assertUnit(pq.slots[6].value == 7);
+      assertUnit(pq.heap.size() == 3);
+      assertUnit(pq.heap.top() == 4);
+   }  // teardown
+
+   // a pop with nothing in the heap is answered, empty handed
+   void test_combine_popEmpty()
+   {  // setup
+      custom::flat_combining_priority_queue <int> pq(4);
+      pq.slots[1].state.store(PQ::POSTED_POP);
+      // exercise
+      pq.combine();
+      // verify
+      assertUnit(pq.slots[1].state.load() == PQ::DONE);
+      assertUnit(!pq.slots[1].isPopped);
+      assertUnit(pq.heap.empty());
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // pushes and pops at once: every item comes out exactly once
+   void test_threads_noneLostOrTwice()
+   {  // setup
+      const int numThreads = 8;
+      const int numEach = 5000;
+      custom::flat_combining_priority_queue <int> pq;
+      custom::vector <int> seen(numThreads * numEach, 0);
+      custom::vector <int> popped[numThreads];
+      // exercise
+      std::thread threads[numThreads];
+      for (int t = 0; t < numThreads; t++)
+         threads[t] = std::thread([&pq, &popped, t, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+            {
+               pq.push(t * numEach + i);
+               int value;
+               if (i % 2 && pq.try_pop(value))
+                  popped[t].push_back(value);
+            }
+         });
+      for (int t = 0; t < numThreads; t++)
+         threads[t].join();
+      int value;
+      while (pq.try_pop(value))
+         popped[0].push_back(value);
+      // verify
+      for (int t = 0; t < numThreads; t++)
+         for (size_t i = 0; i < popped[t].size(); i++)
+            seen[popped[t][i]]++;
+      bool isOnce = true;
+      for (int i = 0; i < numThreads * numEach; i++)
+         if (seen[i] != 1)
+            isOnce = false;
+      assertUnit(isOnce);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // with nothing being pushed, each thread's pops must come out
+   // biggest first, and between them they must take everything
+   void test_threads_drainInOrder()
+   {  // setup
+      const int numThreads = 8;
+      const int numItems = 40000;
+      custom::flat_combining_priority_queue <int> pq;
+      for (int i = 0; i < numItems; i++)
+         pq.push((int)(((long long)i * 7919) % numItems));
+      custom::vector <int> popped[numThreads];
+      // exercise
+      std::thread threads[numThreads];
+      for (int t = 0; t < numThreads; t++)
+         threads[t] = std::thread([&pq, &popped, t]()
+         {
+            int value;
+            while (pq.try_pop(value))
+               popped[t].push_back(value);
+         });
+      for (int t = 0; t < numThreads; t++)
+         threads[t].join();
+      // verify
+      bool inOrder = true;
+      size_t numPopped = 0;
+      for (int t = 0; t < numThreads; t++)
+      {
+         numPopped += popped[t].size();
+         for (size_t i = 1; i < popped[t].size(); i++)
+            if (!(popped[t][i] < popped[t][i - 1]))
+               inOrder = false;
+      }
+      assertUnit(inOrder);
+      assertUnit(numPopped == (size_t)numItems);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // more threads than slots: the ones left out wait their turn
+   void test_threads_moreThanSlots()
+   {  // setup
+      const int numThreads = 8;
+      const int numEach = 2000;
+      custom::flat_combining_priority_queue <int> pq(2);
+      // exercise
+      std::thread threads[numThreads];
+      for (int t = 0; t < numThreads; t++)
+         threads[t] = std::thread([&pq, t, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+               pq.push(t * numEach + i);
+         });
+      for (int t = 0; t < numThreads; t++)
+         threads[t].join();
+      // verify
+      assertUnit(pq.size() == (size_t)(numThreads * numEach));
+      bool inOrder = true;
+      for (int expect = numThreads * numEach - 1; expect >= 0; expect--)
+      {
+         int value;
+         if (!pq.try_pop(value) || value != expect)
+            inOrder = false;
+      }
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   typedef custom::flat_combining_priority_queue <int> PQ;
+};
+
+#endif // DEBUG
@@ -0,0 +1,241 @@
+/***********************************************************************
+ * Header:
+ *    TEST HUGE PAGE ALLOCATOR
+ * Summary:
+ *    Unit tests for the huge page allocator, and for vector and
+ *    priority_queue using it
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "huge_page_allocator.h"
+#include "vector.h"
+#include "priority_queue.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+
+
+class TestHugePageAllocator : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Allocate
+      test_allocate_small();
+      test_allocate_bigAligned();
+      test_allocate_explicitFallback();
+
+      // Trim
+      test_trim_releasesTail();
+      test_trim_small();
+
+      // Vector
+      test_vector_shrinkInPlace();
+      test_vector_shrinkSmall();
+      test_vector_shrinkBelowMapping();
+
+      // Priority queue
+      test_pqueue_big();
+
+      report("HugePageAllocator");
+   }
+
+   /***************************************
+    * ALLOCATE
+    ***************************************/
+
+   // under the threshold it is an ordinary allocation
+   void test_allocate_small()
+   {  // setup
+      custom::huge_page_allocator<int> alloc;
+      // exercise
+      int * p = alloc.allocate(100);
+      p[0] = 1;
+      p[99] = 99;
+      // verify
+      assertUnit(p[0] + p[99] == 100);
+      // teardown
+      alloc.deallocate(p, 100);
+   }
+
+   // at or over it, the buffer starts on a huge page boundary
+   void test_allocate_bigAligned()
+   {  // setup
+      const size_t n = 3 * huge_pages::sizeHuge / sizeof(long long) + 5;
+      custom::huge_page_allocator<long long> alloc;
+      // exercise
+      long long * p = alloc.allocate(n);
+      p[0] = 1;
+      p[n - 1] = 2;
+      // verify
+      assertUnit(p[0] + p[n - 1] == 3);
+#ifndef _WIN32
+      assertUnit((uintptr_t)p % huge_pages::sizeHuge == 0);
+#endif
+      // teardown
+      alloc.deallocate(p, n);
+   }
+
+   // asking for reserved huge pages still works with none reserved
+   void test_allocate_explicitFallback()
+   {  // setup
+      const size_t n = huge_pages::sizeHuge;
+      custom::huge_page_allocator<char> alloc(huge_pages::sizeHuge, true);
+      // exercise
+      char * p = alloc.allocate(n);
+      p[0] = 'a';
+      p[n - 1] = 'z';
+      // verify
+      assertUnit(p[0] == 'a' && p[n - 1] == 'z');
+      // teardown
+      alloc.deallocate(p, n);
+   }
+
+   /***************************************
+    * TRIM
+    ***************************************/
+
+   // the pages past what is used go back, and come back as zeros
+   void test_trim_releasesTail()
+   {  // setup
+      const size_t n = 2 * huge_pages::sizeHuge / sizeof(int);
+      custom::huge_page_allocator<int> alloc;
+      int * p = alloc.allocate(n);
+      for (size_t i = 0; i < n; i++)
+         p[i] = 7;
+      // exercise
+      bool isTrimmed = alloc.trim(p, n, n / 2);
+      // verify
+      assertUnit(isTrimmed);
+      assertUnit(p[n / 2 - 1] == 7);
+#ifndef _WIN32
+      assertUnit(!isResident(p + n * 3 / 4));
+      assertUnit(p[n - 1] == 0);
+#endif
+      // teardown
+      alloc.deallocate(p, n);
+   }
+
+   // a buffer under the threshold is not trimmed, nor is one that
+   // would keep less than the threshold
+   void test_trim_small()
+   {  // setup
+      const size_t n = 2 * huge_pages::sizeHuge / sizeof(int);
+      custom::huge_page_allocator<int> alloc;
+      int * pSmall = alloc.allocate(1024);
+      int * pBig = alloc.allocate(n);
+      // exercise
+      bool isSmallTrimmed = alloc.trim(pSmall, 1024, 1000);
+      bool isBigTrimmed = alloc.trim(pBig, n, 10);
+      // verify
+      assertUnit(!isSmallTrimmed);
+      assertUnit(!isBigTrimmed);
+      // teardown
+      alloc.deallocate(pSmall, 1024);
+      alloc.deallocate(pBig, n);
+   }
+
+   /***************************************
+    * VECTOR
+    ***************************************/
+
+   // shrink_to_fit trims in place rather than copying to a new buffer
+   void test_vector_shrinkInPlace()
+   {  // setup
+      custom::vector <int, custom::huge_page_allocator<int> > v;
+      for (int i = 0; i < 1000000; i++)
+         v.push_back(i);
+      v.resize(600000);
+      int * pData = &v[0];
+      size_t capacity = v.capacity();
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(&v[0] == pData);
+      assertUnit(v.capacity() == capacity);
+      assertUnit(v.size() == 600000);
+      assertUnit(v[599999] == 599999);
+#ifndef _WIN32
+      assertUnit(!isResident(pData + capacity - 1));
+#endif
+   }  // teardown
+
+   // a buffer too small to be mapped is reallocated to fit
+   void test_vector_shrinkSmall()
+   {  // setup
+      custom::vector <int, custom::huge_page_allocator<int> > v;
+      v.reserve(1024);
+      for (int i = 0; i < 1000; i++)
+         v.push_back(i);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.capacity() == 1000);
+      assertUnit(v.size() == 1000);
+      assertUnit(v[999] == 999);
+   }  // teardown
+
+   // a mapping cut down below the threshold is let go for a small buffer
+   void test_vector_shrinkBelowMapping()
+   {  // setup
+      custom::vector <int, custom::huge_page_allocator<int> > v;
+      for (int i = 0; i < 1000000; i++)
+         v.push_back(i);
+      v.resize(10);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.capacity() == 10);
+      assertUnit(v.size() == 10);
+      assertUnit(v[9] == 9);
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // a heap big enough to be mapped still comes out in order
+   void test_pqueue_big()
+   {  // setup
+      const int numItems = 1000000;
+      custom::priority_queue <int, custom::vector<int, custom::huge_page_allocator<int> > > pq;
+      for (int i = 0; i < numItems; i++)
+         pq.push((int)(((long long)i * 7919) % numItems));
+      // exercise
+      bool inOrder = true;
+      for (int expect = numItems - 1; expect >= numItems - 1000; expect--)
+      {
+         if (pq.top() != expect)
+            inOrder = false;
+         pq.pop();
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(pq.size() == (size_t)numItems - 1000);
+   }  // teardown
+
+   typedef custom::huge_pages huge_pages;
+
+#ifndef _WIN32
+   // is the small page holding p in memory?
+   static bool isResident(const void * p)
+   {
+      size_t sizePage = (size_t)sysconf(_SC_PAGESIZE);
+      unsigned char status = 0;
+      void * pPage = (void *)((uintptr_t)p & ~(uintptr_t)(sizePage - 1));
+      mincore(pPage, sizePage, &status);
+      return status & 1;
+   }
+#endif
+};
+
+#endif // DEBUG
@@ -0,0 +1,284 @@
+/***********************************************************************
+ * Header:
+ *    TEST KEYED PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the key/payload split priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "keyed_priority_queue.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>    // for uintptr_t
+#include <functional>
+#include <string>
+
+
+class TestKeyedPQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_empty();
+
+      // Insert
+      test_push_top();
+
+      // Remove
+      test_tryPop_empty();
+      test_tryPop_ordered();
+      test_tryPop_compare();
+      test_pop_reusesSlots();
+      test_tryPop_noDefault();
+
+      // Spy
+      test_spy_keysOnly();
+      test_spy_popDestroys();
+      test_spy_copy();
+      test_spy_balanced();
+
+      report("KeyedPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // nothing in the heap or beside it
+   void test_construct_empty()
+   {  // setup
+      // exercise
+      custom::keyed_priority_queue <int, std::string> pq;
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.size() == 0);
+      assertUnit(pq.numSlots == 0);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // the top is the biggest key, with its own payload
+   void test_push_top()
+   {  // setup
+      custom::keyed_priority_queue <int, std::string> pq;
+      // exercise
+      pq.push(4, std::string("four"));
+      pq.push(9, std::string("nine"));
+      pq.push(1, std::string("one"));
+      // verify
+      assertUnit(pq.size() == 3);
+      assertUnit(pq.top_key() == 9);
+      assertUnit(pq.top() == std::string("nine"));
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // nothing to pop
+   void test_tryPop_empty()
+   {  // setup
+      custom::keyed_priority_queue <int, std::string> pq;
+      int key = 99;
+      std::string payload("left alone");
+      // exercise
+      bool isPopped = pq.try_pop(key, payload);
+      // verify
+      assertUnit(!isPopped);
+      assertUnit(key == 99);
+      assertUnit(payload == std::string("left alone"));
+   }  // teardown
+
+   // biggest key first, and each payload with its key
+   void test_tryPop_ordered()
+   {  // setup
+      custom::keyed_priority_queue <long long, int, std::less<long long>, 4> pq;
+      for (int i = 0; i < 1000; i++)
+         pq.push((long long)((i * 263) % 1000), -((i * 263) % 1000));
+      // exercise
+      bool inOrder = true;
+      long long key;
+      int payload;
+      for (long long expect = 999; expect >= 0; expect--)
+         if (!pq.try_pop(key, payload) || key != expect || payload != -expect)
+            inOrder = false;
+      // verify
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+      assertUnit(pq.numSlots == 0);
+   }  // teardown
+
+   // with std::greater the smallest key comes out first
+   void test_tryPop_compare()
+   {  // setup
+      custom::keyed_priority_queue <int, char, std::greater<int> > pq;
+      pq.push(4, 'd');
+      pq.push(9, 'i');
+      pq.push(1, 'a');
+      int key = 0;
+      char payload = ' ';
+      // exercise
+      pq.try_pop(key, payload);
+      // verify
+      assertUnit(key == 1);
+      assertUnit(payload == 'a');
+      assertUnit(pq.top_key() == 4);
+      assertUnit(pq.top() == 'd');
+   }  // teardown
+
+   // a key with no default constructor, and a payload aligned past what operator new promises
+   void test_tryPop_noDefault()
+   {  // setup
+      struct Priority
+      {
+         explicit Priority(int value) : value(value) {}
+         bool operator < (const Priority & rhs) const { return value < rhs.value; }
+         int value;
+      };
+      struct alignas(64) Block
+      {
+         explicit Block(int value) : value(value) {}
+         int value;
+      };
+      custom::keyed_priority_queue <Priority, Block> pq;
+      bool isAligned = true;
+      for (int i = 0; i < 100; i++)
+      {
+         pq.push(Priority((i * 37) % 100), Block(i));
+         if ((uintptr_t)&pq.top() % 64 != 0)
+            isAligned = false;
+      }
+      Priority key(-1);
+      Block payload(-1);
+      // exercise
+      bool isPopped = pq.try_pop(key, payload);
+      pq.pop();
+      // verify
+      assertUnit(isAligned);
+      assertUnit(isPopped);
+      assertUnit(key.value == 99);
+      assertUnit(payload.value == 27);
+      assertUnit(pq.top_key().value == 97);
+      assertUnit(pq.size() == 98);
+   }  // teardown
+
+   // popped slots are used again, so the side array stays small
+   void test_pop_reusesSlots()
+   {  // setup
+      custom::keyed_priority_queue <int, int> pq;
+      for (int i = 0; i < 8; i++)
+         pq.push(i, i);
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         pq.pop();
+         pq.push(i % 97, i);
+      }
+      // verify
+      assertUnit(pq.size() == 8);
+      assertUnit(pq.numSlots == 8);
+      assertUnit(pq.slotsFree.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * SPY
+    ***************************************/
+
+   // the payloads are never compared, and each moves out once
+   void test_spy_keysOnly()
+   {  // setup
+      custom::keyed_priority_queue <int, Spy> pq;
+      pq.reserve(100);
+      for (int i = 0; i < 100; i++)
+         pq.push((i * 37) % 100, Spy(i));
+      Spy payload;
+      int key;
+      Spy::reset();
+      // exercise
+      while (pq.try_pop(key, payload))
+         ;
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopyMove() + Spy::numAssignMove() == 100);
+   }  // teardown
+
+   // a popped payload is destroyed there and then, not when its slot is reused
+   void test_spy_popDestroys()
+   {  // setup
+      custom::keyed_priority_queue <int, Spy> pq;
+      for (int i = 0; i < 10; i++)
+         pq.push(i, Spy(i));
+      Spy payload;
+      int key;
+      Spy::reset();
+      // exercise
+      pq.pop();
+      pq.pop();
+      pq.try_pop(key, payload);
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 2);
+      assertUnit(payload.get() == 7);
+      assertUnit(pq.size() == 7);
+   }  // teardown
+
+   // a copy has its own payloads, in the same slots
+   void test_spy_copy()
+   {  // setup
+      custom::keyed_priority_queue <int, Spy> pqSrc;
+      for (int i = 0; i < 10; i++)
+         pqSrc.push(i, Spy(i));
+      pqSrc.pop();
+      pqSrc.pop();
+      Spy::reset();
+      // exercise
+      custom::keyed_priority_queue <int, Spy> pqDest(pqSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 8);
+      assertUnit(pqDest.size() == 8);
+      assertUnit(pqDest.top_key() == 7);
+      assertUnit(pqDest.top().get() == 7);
+      pqSrc.pop();
+      assertUnit(pqDest.top().get() == 7);
+   }  // teardown
+
+   // every Spy built is destroyed
+   void test_spy_balanced()
+   {  // setup
+      Spy::reset();
+      // exercise
+      {
+         custom::keyed_priority_queue <int, Spy> pq;
+         for (int i = 0; i < 50; i++)
+            pq.push(i % 7, Spy(i));
+         Spy payload;
+         int key;
+         for (int i = 0; i < 20; i++)
+            pq.try_pop(key, payload);
+         for (int i = 0; i < 10; i++)
+            pq.pop();
+         pq.push(3, payload);
+      }
+      // verify
+      assertUnit(Spy::numDefault() + Spy::numNondefault() + Spy::numCopy() +
+                 Spy::numCopyMove() == Spy::numDestructor());
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+};
+
+#endif // DEBUG
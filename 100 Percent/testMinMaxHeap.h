@@ -0,0 +1,381 @@
+/***********************************************************************
+ * Header:
+ *    TEST MIN MAX HEAP
+ * Summary:
+ *    Unit tests for the min-max heap
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "min_max_heap.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <string>
+
+#undef assertHeap
+#define assertHeap(x) assertHeapParameters(x, __LINE__, __FUNCTION__)
+
+class TestMinMaxHeap : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructRange_standard();
+      test_constructMoveInit_standard();
+      test_constructCopy_standard();
+
+      // Assign
+      test_swap_standardEmpty();
+
+      // Access
+      test_top_empty();
+      test_top_one();
+      test_top_two();
+
+      // Insert
+      test_push_levels();
+      test_push_spyOneCopy();
+
+      // Remove
+      test_popMin_standard();
+      test_popMax_standard();
+      test_popMax_last();
+      test_pop_mixed();
+      test_pop_empty();
+
+      report("MinMaxHeap");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::min_max_heap <int> mmh;
+      // verify
+      assertUnit(mmh.empty());
+      assertUnit(mmh.size() == 0);
+   }  // teardown
+
+   // min_max_heap({10, 8, 9, 4, 3, 7, 5})
+   void test_constructRange_standard()
+   {  // setup
+      std::initializer_list<int> il{10, 8, 9, 4, 3, 7, 5};
+      // exercise
+      custom::min_max_heap <int> mmh(il.begin(), il.end());
+      // verify
+      assertHeap(mmh);
+      assertStandardFixture(mmh);
+   }  // teardown
+
+   // min_max_heap(move([10, 8, 9, 4, 3, 7, 5]))
+   void test_constructMoveInit_standard()
+   {  // setup
+      custom::vector <int> v{10, 8, 9, 4, 3, 7, 5};
+      // exercise
+      custom::min_max_heap <int> mmh(std::move(v));
+      // verify
+      assertHeap(mmh);
+      assertStandardFixture(mmh);
+      assertUnit(v.size() == 0);
+   }  // teardown
+
+   // copy constructor makes an independent heap
+   void test_constructCopy_standard()
+   {  // setup
+      custom::min_max_heap <int> mmhSrc;
+      setupStandardFixture(mmhSrc);
+      // exercise
+      custom::min_max_heap <int> mmhDest(mmhSrc);
+      // verify
+      mmhSrc.pop_max();
+      assertUnit(mmhSrc.size() == 6);
+      assertStandardFixture(mmhDest);
+   }  // teardown
+
+   /***************************************
+    * SWAP
+    ***************************************/
+
+   // swap(standard, empty)
+   void test_swap_standardEmpty()
+   {  // setup
+      custom::min_max_heap <int> mmhLHS;
+      setupStandardFixture(mmhLHS);
+      custom::min_max_heap <int> mmhRHS;
+      // exercise
+      swap(mmhLHS, mmhRHS);
+      // verify
+      assertUnit(mmhLHS.empty());
+      assertStandardFixture(mmhRHS);
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty heap
+   void test_top_empty()
+   {  // setup
+      custom::min_max_heap <int> mmh;
+      // exercise
+      try
+      {
+         mmh.top_max();
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:out_of_range"));
+      }
+      try
+      {
+         mmh.top_min();
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:out_of_range"));
+      }
+   }  // teardown
+
+   // with one item it is both the biggest and the smallest
+   void test_top_one()
+   {  // setup
+      custom::min_max_heap <int> mmh;
+      // exercise
+      mmh.push(7);
+      // verify
+      assertUnit(mmh.top_max() == 7);
+      assertUnit(mmh.top_min() == 7);
+   }  // teardown
+
+   // with two items the root has only one child
+   void test_top_two()
+   {  // setup
+      custom::min_max_heap <int> mmh;
+      // exercise
+      mmh.push(3);
+      mmh.push(9);
+      // verify
+      assertUnit(mmh.container[0] == 3);
+      assertUnit(mmh.container[1] == 9);
+      assertUnit(mmh.top_max() == 9);
+      assertUnit(mmh.top_min() == 3);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // push alternates min and max levels
+   void test_push_levels()
+   {  // setup
+      custom::min_max_heap <int> mmh;
+      // exercise
+      setupStandardFixture(mmh);
+      // verify
+      //                3              min
+      //          10           9       max
+      //       8     4      7     5    min
+      assertUnit(mmh.size() == 7);
+      assertUnit(mmh.container[0] == 3);
+      assertUnit(mmh.container[1] == 10);
+      assertUnit(mmh.container[2] == 9);
+      assertUnit(mmh.container[3] == 8);
+      assertUnit(mmh.container[4] == 4);
+      assertUnit(mmh.container[5] == 7);
+      assertUnit(mmh.container[6] == 5);
+      assertHeap(mmh);
+   }  // teardown
+
+   // every item is stored once: one copy into the heap, no more
+   void test_push_spyOneCopy()
+   {  // setup
+      custom::min_max_heap <Spy> mmh;
+      mmh.container.reserve(64);
+      Spy s(42);
+      for (int i = 0; i < 50; i++)
+         mmh.push(Spy((i * 17) % 50));
+      Spy::reset();
+      // exercise
+      mmh.push(s);
+      // verify
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(mmh.size() == 51);
+      assertUnit(mmh.top_min().get() == 0);
+      assertUnit(mmh.top_max().get() == 49);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // pop_min takes the smallest each time
+   void test_popMin_standard()
+   {  // setup
+      custom::min_max_heap <int> mmh;
+      setupStandardFixture(mmh);
+      // exercise
+      mmh.pop_min();
+      // verify
+      assertUnit(mmh.size() == 6);
+      assertUnit(mmh.top_min() == 4);
+      assertUnit(mmh.top_max() == 10);
+      assertHeap(mmh);
+   }  // teardown
+
+   // pop_max takes the biggest each time
+   void test_popMax_standard()
+   {  // setup
+      custom::min_max_heap <int> mmh;
+      setupStandardFixture(mmh);
+      // exercise
+      mmh.pop_max();
+      // verify
+      assertUnit(mmh.size() == 6);
+      assertUnit(mmh.top_min() == 3);
+      assertUnit(mmh.top_max() == 9);
+      assertHeap(mmh);
+   }  // teardown
+
+   // the biggest is the very last item
+   void test_popMax_last()
+   {  // setup
+      custom::min_max_heap <int> mmh;
+      mmh.push(1);
+      mmh.push(2);
+      // exercise
+      mmh.pop_max();
+      // verify
+      assertUnit(mmh.size() == 1);
+      assertUnit(mmh.top_max() == 1);
+      assertUnit(mmh.top_min() == 1);
+   }  // teardown
+
+   // both ends against a sorted array
+   void test_pop_mixed()
+   {  // setup
+      custom::min_max_heap <int> mmh;
+      for (int i = 0; i < 1000; i++)
+         mmh.push((i * 379) % 1000);
+      int low = 0;
+      int high = 999;
+      // exercise
+      bool inOrder = true;
+      bool isHeap = true;
+      for (int i = 0; i < 1000; i++)
+      {
+         if (i % 3 == 0)
+         {
+            if (mmh.top_min() != low++)
+               inOrder = false;
+            mmh.pop_min();
+         }
+         else
+         {
+            if (mmh.top_max() != high--)
+               inOrder = false;
+            mmh.pop_max();
+         }
+         if (i % 97 == 0 && !isMinMaxHeap(mmh))
+            isHeap = false;
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(isHeap);
+      assertUnit(mmh.empty());
+   }  // teardown
+
+   // pop an empty heap
+   void test_pop_empty()
+   {  // setup
+      custom::min_max_heap <int> mmh;
+      // exercise
+      mmh.pop_max();
+      mmh.pop_min();
+      // verify
+      assertUnit(mmh.empty());
+   }  // teardown
+
+   /***************************************************
+    * SETUP STANDARD FIXTURE
+    *    {10, 8, 9, 4, 3, 7, 5}
+    ***************************************************/
+   void setupStandardFixture(custom::min_max_heap <int>& mmh)
+   {
+      int values[7] = {10, 8, 9, 4, 3, 7, 5};
+      for (int value : values)
+         mmh.push(value);
+   }
+
+   /***************************************************
+    * VERIFY STANDARD FIXTURE
+    * Drains copies from both ends, so the fixture
+    * itself is untouched
+    ***************************************************/
+   void assertStandardFixtureParameters(const custom::min_max_heap <int>& mmh, int line, const char* function)
+   {
+      assertIndirect(mmh.size() == 7);
+      int sorted[] = {3, 4, 5, 7, 8, 9, 10};
+      custom::min_max_heap <int> mmhMin(mmh);
+      custom::min_max_heap <int> mmhMax(mmh);
+      bool inOrder = true;
+      for (int i = 0; i < 7; i++)
+      {
+         if (mmhMin.top_min() != sorted[i] || mmhMax.top_max() != sorted[6 - i])
+            inOrder = false;
+         mmhMin.pop_min();
+         mmhMax.pop_max();
+      }
+      assertIndirect(inOrder);
+      assertIndirect(mmhMin.empty());
+   }
+
+   /***************************************************
+    * VERIFY HEAP
+    * Every node on a min level is no bigger than its
+    * descendants, every node on a max level no smaller.
+    * Checking against each parent and grandparent
+    * is enough.
+    ***************************************************/
+   bool isMinMaxHeap(const custom::min_max_heap <int>& mmh)
+   {
+      const custom::vector <int>& c = mmh.container;
+      for (size_t i = 1; i < c.size(); i++)
+      {
+         size_t parent = (i - 1) / 2;
+         bool parentIsMin = custom::min_max_heap <int>::isMinLevel(parent);
+         if (parentIsMin ? c[i] < c[parent] : c[parent] < c[i])
+            return false;
+         if (i > 2)
+         {
+            size_t grand = (parent - 1) / 2;
+            if (parentIsMin ? c[grand] < c[i] : c[i] < c[grand])
+               return false;
+         }
+      }
+      return true;
+   }
+   void assertHeapParameters(const custom::min_max_heap <int>& mmh, int line, const char* function)
+   {
+      assertIndirect(isMinMaxHeap(mmh));
+   }
+};
+
+#endif // DEBUG
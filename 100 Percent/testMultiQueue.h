@@ -0,0 +1,213 @@
+/***********************************************************************
+ * Header:
+ *    TEST MULTI QUEUE
+ * Summary:
+ *    Unit tests for the multi queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "multi_queue.h"
+#include "vector.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <thread>
+
+
+class TestMultiQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_queues();
+
+      // Remove
+      test_pop_empty();
+      test_pop_exact();
+      test_pop_rankError();
+      test_pop_moreChoices();
+
+      // Threads
+      test_threads_noneLostOrTwice();
+
+      report("MultiQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // c queues for each of P threads
+   void test_construct_queues()
+   {  // setup
+      // exercise
+      custom::multi_queue <int> mqFour(4);
+      custom::multi_queue <int> mqOne(1, 1, 5);
+      // verify
+      assertUnit(mqFour.empty());
+      assertUnit(mqFour.numQueues == 8);
+      assertUnit(mqFour.numChoices == 2);
+      assertUnit(mqOne.numQueues == 2);
+      assertUnit(mqOne.numChoices == 2);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // nothing to pop
+   void test_pop_empty()
+   {  // setup
+      custom::multi_queue <int> mq(4);
+      int value = 99;
+      // exercise
+      bool isPopped = mq.try_pop(value);
+      // verify
+      assertUnit(!isPopped);
+      assertUnit(value == 99);
+   }  // teardown
+
+   // looking at every queue makes it an ordinary priority queue
+   void test_pop_exact()
+   {  // setup
+      custom::multi_queue <int> mq(4, 2, 8);
+      for (int i = 0; i < 1000; i++)
+         mq.push((i * 263) % 1000);
+      // exercise
+      bool inOrder = true;
+      for (int expect = 999; expect >= 0; expect--)
+      {
+         int value = -1;
+         if (!mq.try_pop(value) || value != expect)
+            inOrder = false;
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(mq.empty());
+   }  // teardown
+
+   // two choices: nothing lost, and pops stay near the top
+   void test_pop_rankError()
+   {  // setup
+      custom::multi_queue <int> mq(4);
+      const int numItems = 4000;
+      for (int i = 0; i < numItems; i++)
+         mq.push((i * 2713) % numItems);
+      // exercise
+      double rankMean = 0.0;
+      int rankMax = 0;
+      bool isOnce = drainRanks(mq, numItems, rankMean, rankMax);
+      // verify
+      //   8 queues, 2 choices: the mean rank is a few items
+      assertUnit(isOnce);
+      assertUnit(rankMean < 8.0);
+      assertUnit(rankMax < 200);
+   }  // teardown
+
+   // more choices, smaller rank errors
+   void test_pop_moreChoices()
+   {  // setup
+      custom::multi_queue <int> mqTwo(8, 2, 2);
+      custom::multi_queue <int> mqEight(8, 2, 8);
+      const int numItems = 4000;
+      for (int i = 0; i < numItems; i++)
+      {
+         mqTwo.push((i * 2713) % numItems);
+         mqEight.push((i * 2713) % numItems);
+      }
+      // exercise
+      double rankMeanTwo = 0.0;
+      double rankMeanEight = 0.0;
+      int rankMax = 0;
+      drainRanks(mqTwo,   numItems, rankMeanTwo,   rankMax);
+      drainRanks(mqEight, numItems, rankMeanEight, rankMax);
+      // verify
+      assertUnit(rankMeanEight < rankMeanTwo);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // pushes and pops at once: every item comes out exactly once
+   void test_threads_noneLostOrTwice()
+   {  // setup
+      const int numThreads = 8;
+      const int numEach = 5000;
+      custom::multi_queue <int> mq(numThreads);
+      custom::vector <int> seen(numThreads * numEach, 0);
+      custom::vector <int> popped[numThreads];
+      // exercise
+      std::thread threads[numThreads];
+      for (int t = 0; t < numThreads; t++)
+         threads[t] = std::thread([&mq, &popped, t, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+            {
+               mq.push(t * numEach + i);
+               int value;
+               if (i % 2 && mq.try_pop(value))
+                  popped[t].push_back(value);
+            }
+         });
+      for (int t = 0; t < numThreads; t++)
+         threads[t].join();
+      int value;
+      while (mq.try_pop(value))
+         popped[0].push_back(value);
+      // verify
+      for (int t = 0; t < numThreads; t++)
+         for (size_t i = 0; i < popped[t].size(); i++)
+            seen[popped[t][i]]++;
+      bool isOnce = true;
+      for (int i = 0; i < numThreads * numEach; i++)
+         if (seen[i] != 1)
+            isOnce = false;
+      assertUnit(isOnce);
+      assertUnit(mq.empty());
+   }  // teardown
+
+   /***************************************************
+    * DRAIN RANKS
+    * Pop 0..numItems-1 out of the queue, noting how
+    * many bigger items were still in when each came
+    * out. True if every item came out once
+    ***************************************************/
+   bool drainRanks(custom::multi_queue <int>& mq, int numItems,
+                   double & rankMean, int & rankMax)
+   {
+      custom::vector <int> isOut(numItems, 0);
+      long long rankTotal = 0;
+      rankMax = 0;
+      int top = numItems - 1;       // the biggest item still in
+      for (int i = 0; i < numItems; i++)
+      {
+         int value = -1;
+         if (!mq.try_pop(value) || value < 0 || value >= numItems || isOut[value])
+            return false;
+         isOut[value] = 1;
+         int rank = 0;
+         for (int bigger = top; bigger > value; bigger--)
+            if (!isOut[bigger])
+               rank++;
+         rankTotal += rank;
+         if (rank > rankMax)
+            rankMax = rank;
+         while (top >= 0 && isOut[top])
+            top--;
+      }
+      rankMean = (double)rankTotal / numItems;
+      return mq.empty();
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,377 @@
+/***********************************************************************
+ * Header:
+ *    TEST PAIRING HEAP
+ * Summary:
+ *    Unit tests for the pairing heap
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "pairing_heap.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <thread>
+
+
+class TestPairingHeap : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+      test_destructor_spy();
+
+      // Assign
+      test_swap_standardEmpty();
+
+      // Access
+      test_top_empty();
+
+      // Insert / Remove
+      test_push_pop_ordered();
+      test_pop_empty();
+
+      // Meld
+      test_meld_standardStandard();
+      test_meld_emptyStandard();
+      test_meld_standardEmpty();
+      test_meld_repeatedSlabs();
+      test_meld_twoThreads();
+
+      // Pool
+      test_pool_reuse();
+      test_pool_spy();
+
+      report("PairingHeap");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no allocations
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::pairing_heap <int> ph;
+      // verify
+      assertUnit(ph.empty());
+      assertUnit(ph.size() == 0);
+      assertUnit(ph.pRoot == nullptr);
+      assertUnit(ph.numSlabs == 0);
+   }  // teardown
+
+   // copy constructor makes an independent heap
+   void test_constructCopy_standard()
+   {  // setup
+      custom::pairing_heap <int> phSrc;
+      setupStandardFixture(phSrc);
+      // exercise
+      custom::pairing_heap <int> phDest(phSrc);
+      // verify
+      phSrc.pop();
+      assertUnit(phSrc.size() == 6);
+      assertStandardFixture(phDest);
+   }  // teardown
+
+   // move constructor steals everything, pool included
+   void test_constructMove_standard()
+   {  // setup
+      custom::pairing_heap <int> phSrc;
+      setupStandardFixture(phSrc);
+      // exercise
+      custom::pairing_heap <int> phDest(std::move(phSrc));
+      // verify
+      assertUnit(phSrc.empty());
+      assertUnit(phSrc.numSlabs == 0);
+      assertStandardFixture(phDest);
+   }  // teardown
+
+   // every item is destroyed with the heap
+   void test_destructor_spy()
+   {  // setup
+      Spy::reset();
+      {
+         custom::pairing_heap <Spy> ph;
+         for (int i = 0; i < 100; i++)
+            ph.push(Spy(i % 17));
+         for (int i = 0; i < 30; i++)
+            ph.pop();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }
+
+   /***************************************
+    * SWAP
+    ***************************************/
+
+   // swap(standard, empty)
+   void test_swap_standardEmpty()
+   {  // setup
+      custom::pairing_heap <int> phLHS;
+      setupStandardFixture(phLHS);
+      custom::pairing_heap <int> phRHS;
+      // exercise
+      swap(phLHS, phRHS);
+      // verify
+      assertUnit(phLHS.empty());
+      assertStandardFixture(phRHS);
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty heap
+   void test_top_empty()
+   {  // setup
+      custom::pairing_heap <int> ph;
+      // exercise
+      try
+      {
+         ph.top();
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:out_of_range"));
+      }
+   }  // teardown
+
+   /***************************************
+    * PUSH / POP
+    ***************************************/
+
+   // items come out biggest first
+   void test_push_pop_ordered()
+   {  // setup
+      custom::pairing_heap <int> ph;
+      // exercise
+      for (int i = 0; i < 500; i++)
+         ph.push((i * 263) % 500);
+      // verify
+      assertUnit(ph.size() == 500);
+      bool inOrder = true;
+      for (int expect = 499; expect >= 0; expect--)
+      {
+         if (ph.empty() || ph.top() != expect)
+            inOrder = false;
+         ph.pop();
+      }
+      assertUnit(inOrder);
+      assertUnit(ph.empty());
+   }  // teardown
+
+   // pop an empty heap
+   void test_pop_empty()
+   {  // setup
+      custom::pairing_heap <int> ph;
+      // exercise
+      ph.pop();
+      // verify
+      assertUnit(ph.empty());
+   }  // teardown
+
+   /***************************************
+    * MELD
+    ***************************************/
+
+   // meld(standard, other)
+   void test_meld_standardStandard()
+   {  // setup
+      custom::pairing_heap <int> phLHS;
+      setupStandardFixture(phLHS);
+      custom::pairing_heap <int> phRHS;
+      phRHS.push(99);
+      phRHS.push(6);
+      phRHS.push(1);
+      // exercise
+      phLHS.meld(phRHS);
+      // verify
+      assertUnit(phRHS.empty());
+      assertUnit(phRHS.numSlabs == 0);
+      assertUnit(phLHS.numSlabs == 2);
+      assertUnit(phLHS.size() == 10);
+      int sorted[] = {99, 10, 9, 8, 7, 6, 5, 4, 3, 1};
+      bool inOrder = true;
+      for (int value : sorted)
+      {
+         if (phLHS.empty() || phLHS.top() != value)
+            inOrder = false;
+         phLHS.pop();
+      }
+      assertUnit(inOrder);
+      // the melded heap can be used again
+      phRHS.push(42);
+      assertUnit(phRHS.top() == 42);
+   }  // teardown
+
+   // meld(empty, standard)
+   void test_meld_emptyStandard()
+   {  // setup
+      custom::pairing_heap <int> phLHS;
+      custom::pairing_heap <int> phRHS;
+      setupStandardFixture(phRHS);
+      // exercise
+      phLHS.meld(phRHS);
+      // verify
+      assertUnit(phRHS.empty());
+      assertStandardFixture(phLHS);
+   }  // teardown
+
+   // meld(standard, empty)
+   void test_meld_standardEmpty()
+   {  // setup
+      custom::pairing_heap <int> phLHS;
+      setupStandardFixture(phLHS);
+      custom::pairing_heap <int> phRHS;
+      // exercise
+      phLHS.meld(phRHS);
+      // verify
+      assertUnit(phRHS.empty());
+      assertStandardFixture(phLHS);
+   }  // teardown
+
+   // a worker melded into a global heap every tick, the global one
+   // popping it all again: the nodes go round, the slabs do not pile up
+   void test_meld_repeatedSlabs()
+   {  // setup
+      custom::pairing_heap <int> phGlobal;
+      custom::pairing_heap <int> phWorker;
+      phGlobal.push(1000);
+      // exercise
+      for (int tick = 0; tick < 2000; tick++)
+      {
+         for (int i = 0; i < 100; i++)
+            phWorker.push((tick * 37 + i * 11) % 997);
+         phGlobal.meld(phWorker);
+         for (int i = 0; i < 100; i++)
+            phGlobal.pop();
+      }
+      // verify
+      assertUnit(phWorker.empty());
+      assertUnit(phGlobal.size() == 1);
+      assertUnit(phGlobal.numSlabs + phWorker.numSlabs <= 8);
+   }  // teardown
+
+   // a worker thread pushes while the global heap pops: after a meld
+   // the two share no nodes and no slabs, so nothing is raced on
+   void test_meld_twoThreads()
+   {  // setup
+      custom::pairing_heap <int> phGlobal;
+      custom::pairing_heap <int> phWorker;
+      size_t numPopped = 0;
+      // exercise
+      for (int tick = 0; tick < 200; tick++)
+      {
+         std::thread worker([&phWorker, tick]()
+         {
+            for (int i = 0; i < 100; i++)
+               phWorker.push((tick * 37 + i * 11) % 997);
+         });
+         for (int i = 0; i < 80 && !phGlobal.empty(); i++, numPopped++)
+            phGlobal.pop();
+         worker.join();
+         phGlobal.meld(phWorker);
+      }
+      // verify
+      assertUnit(phWorker.empty());
+      assertUnit(phGlobal.size() == 200 * 100 - numPopped);
+      bool inOrder = true;
+      int previous = 997;
+      while (!phGlobal.empty())
+      {
+         if (phGlobal.top() > previous)
+            inOrder = false;
+         previous = phGlobal.top();
+         phGlobal.pop();
+      }
+      assertUnit(inOrder);
+   }  // teardown
+
+   /***************************************
+    * POOL
+    ***************************************/
+
+   // popped nodes are reused rather than allocated again
+   void test_pool_reuse()
+   {  // setup
+      custom::pairing_heap <int> ph;
+      for (int i = 0; i < 16; i++)
+         ph.push(i);
+      for (int i = 0; i < 16; i++)
+         ph.pop();
+      // exercise
+      for (int i = 0; i < 16; i++)
+         ph.push(i);
+      // verify
+      assertUnit(ph.size() == 16);
+      assertUnit(ph.numSlabs == 1);
+   }  // teardown
+
+   // the only allocations are the ones the items make themselves
+   void test_pool_spy()
+   {  // setup
+      custom::pairing_heap <Spy> ph;
+      for (int i = 0; i < 10; i++)
+         ph.push(Spy(i));
+      ph.pop();
+      Spy s(50);
+      Spy::reset();
+      // exercise
+      ph.push(std::move(s));
+      // verify
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(ph.top().get() == 50);
+   }  // teardown
+
+   /***************************************************
+    * SETUP STANDARD FIXTURE
+    *    {10, 8, 9, 4, 3, 7, 5}
+    ***************************************************/
+   void setupStandardFixture(custom::pairing_heap <int>& ph)
+   {
+      int values[7] = {10, 8, 9, 4, 3, 7, 5};
+      for (int value : values)
+         ph.push(value);
+   }
+
+   /***************************************************
+    * VERIFY STANDARD FIXTURE
+    * Drains a copy, so the fixture itself is untouched
+    ***************************************************/
+   void assertStandardFixtureParameters(const custom::pairing_heap <int>& ph, int line, const char* function)
+   {
+      assertIndirect(ph.size() == 7);
+      custom::pairing_heap <int> phCopy(ph);
+      int sorted[] = {10, 9, 8, 7, 5, 4, 3};
+      bool inOrder = true;
+      for (int value : sorted)
+      {
+         if (phCopy.empty() || phCopy.top() != value)
+            inOrder = false;
+         phCopy.pop();
+      }
+      assertIndirect(inOrder);
+      assertIndirect(phCopy.empty());
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,466 @@
+/***********************************************************************
+ * Header:
+ *    TEST PERSISTENT PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the mapped vector and the persistent priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "persistent_priority_queue.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>    // for getenv
+#include <string>
+
+#ifndef _WIN32
+#include <signal.h>   // for kill
+#include <sys/wait.h> // for waitpid
+#include <unistd.h>   // for fork, pipe
+#endif
+
+
+class TestPersistentPQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_create();
+      test_construct_reopen();
+      test_construct_wrongType();
+      test_construct_notOurs();
+      test_construct_truncated();
+
+      // Access
+      test_top_empty();
+
+      // Insert / Remove
+      test_push_grow();
+      test_pop_ordered();
+
+      // Crash
+      test_recover_push();
+      test_recover_pop();
+      test_crash_killWriter();
+
+      report("PersistentPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // a new file is an empty heap
+   void test_construct_create()
+   {  // setup
+      std::string path = tempPath("create");
+      {
+         // exercise
+         custom::persistent_priority_queue <int> pq(path);
+         // verify
+         assertUnit(pq.empty());
+         assertUnit(pq.container.capacity() == 0);
+         assertUnit(pq.container.journal().op == 0);
+      }
+      assertUnit(isFile(path));
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   // open the file again and the heap is just as it was
+   void test_construct_reopen()
+   {  // setup
+      std::string path = tempPath("reopen");
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         setupStandardFixture(pq);
+      }
+      // exercise
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         // verify
+         //  +---+---+---+---+---+---+---+
+         //  | 10| 8 | 9 | 4 | 3 | 7 | 5 |
+         //  +---+---+---+---+---+---+---+
+         assertUnit(pq.size() == 7);
+         int heap[] = {10, 8, 9, 4, 3, 7, 5};
+         bool same = true;
+         for (size_t i = 0; i < 7 && i < pq.size(); i++)
+            if (pq.container[i] != heap[i])
+               same = false;
+         assertUnit(same);
+      }
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   // a file made for another type is refused
+   void test_construct_wrongType()
+   {  // setup
+      std::string path = tempPath("wrongType");
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         pq.push(1);
+      }
+      // exercise
+      bool isThrown = false;
+      try
+      {
+         custom::persistent_priority_queue <long long> pq(path);
+      }
+      catch (const char* s)
+      {
+         isThrown = std::string(s) == std::string("std:runtime_error");
+      }
+      // verify
+      assertUnit(isThrown);
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   // a file that is not a heap at all is refused
+   void test_construct_notOurs()
+   {  // setup
+      std::string path = tempPath("notOurs");
+      FILE * file = fopen(path.c_str(), "wb");
+      for (int i = 0; i < 100; i++)
+         fputs("not a heap ", file);
+      fclose(file);
+      // exercise
+      bool isThrown = false;
+      try
+      {
+         custom::persistent_priority_queue <int> pq(path);
+      }
+      catch (const char* s)
+      {
+         isThrown = std::string(s) == std::string("std:runtime_error");
+      }
+      // verify
+      assertUnit(isThrown);
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   // a file shorter than its capacity says is refused
+   void test_construct_truncated()
+   {  // setup
+      std::string path = tempPath("truncated");
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         for (int i = 0; i < 100; i++)
+            pq.push(i);
+      }
+      std::string bytes;
+      FILE * file = fopen(path.c_str(), "rb");
+      for (int c = fgetc(file); c != EOF; c = fgetc(file))
+         bytes += (char)c;
+      fclose(file);
+      file = fopen(path.c_str(), "wb");
+      fwrite(bytes.data(), 1, bytes.size() / 2, file);
+      fclose(file);
+      // exercise
+      bool isThrown = false;
+      try
+      {
+         custom::persistent_priority_queue <int> pq(path);
+      }
+      catch (const char* s)
+      {
+         isThrown = std::string(s) == std::string("std:runtime_error");
+      }
+      // verify
+      assertUnit(isThrown);
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty heap
+   void test_top_empty()
+   {  // setup
+      std::string path = tempPath("topEmpty");
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         // exercise
+         try
+         {
+            pq.top();
+            // verify
+            assertUnit(false);
+         }
+         catch (const char* s)
+         {
+            assertUnit(std::string(s) == std::string("std:out_of_range"));
+         }
+      }
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   /***************************************
+    * PUSH / POP
+    ***************************************/
+
+   // the file grows as the heap does
+   void test_push_grow()
+   {  // setup
+      std::string path = tempPath("grow");
+      {
+         custom::persistent_priority_queue <double> pq(path);
+         // exercise
+         for (int i = 0; i < 1000; i++)
+            pq.push((double)((i * 263) % 1000));
+         // verify
+         assertUnit(pq.size() == 1000);
+         assertUnit(pq.container.capacity() >= 1000);
+         assertUnit(pq.top() == 999.0);
+         assertUnit(isHeap(pq));
+      }
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   // drained biggest first, across a reopen
+   void test_pop_ordered()
+   {  // setup
+      std::string path = tempPath("ordered");
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         for (int i = 0; i < 500; i++)
+            pq.push((i * 389) % 500);
+         for (int i = 0; i < 100; i++)
+            pq.pop();
+      }
+      // exercise
+      bool inOrder = true;
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         for (int expect = 399; expect >= 0; expect--)
+         {
+            if (pq.empty() || pq.top() != expect)
+               inOrder = false;
+            pq.pop();
+         }
+         assertUnit(pq.empty());
+      }
+      // verify
+      assertUnit(inOrder);
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   /***************************************
+    * CRASH
+    ***************************************/
+
+   // a push stopped half way up is finished on reopen
+   void test_recover_push()
+   {  // setup
+      //   push(20) pulled 4 and then 8 down, but died before
+      //   noting that the hole had moved on from 3
+      //                10
+      //          8            9
+      //       8     3      7     5
+      //     4
+      std::string path = tempPath("recoverPush");
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         setupStandardFixture(pq);
+         pq.container.journalItem() = 20;
+         pq.container.journal().index = 7;
+         pq.container.journal().size = 8;
+         pq.container.journal().op = 1;
+         pq.container.resize(8);
+         pq.container[7] = pq.container[3];
+         pq.container[3] = pq.container[1];
+         pq.container.journal().index = 3;
+      }
+      // exercise
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         // verify
+         //                20
+         //          10           9
+         //       8     3      7     5
+         //     4
+         assertUnit(pq.container.journal().op == 0);
+         assertUnit(pq.size() == 8);
+         assertUnit(isHeap(pq));
+         int sorted[] = {20, 10, 9, 8, 7, 5, 4, 3};
+         assertUnit(drainsAs(pq, sorted, 8));
+      }
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   // a pop stopped half way down is finished on reopen
+   void test_recover_pop()
+   {  // setup
+      //   pop() took 5 off the end and pulled 9 and then 7 up,
+      //   but died before noting that the hole had moved on from 2
+      //                9
+      //          8            7
+      //       4     3      7
+      std::string path = tempPath("recoverPop");
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         setupStandardFixture(pq);
+         pq.container.journalItem() = 5;
+         pq.container.journal().index = 0;
+         pq.container.journal().size = 6;
+         pq.container.journal().op = 2;
+         pq.container.resize(6);
+         pq.container[0] = pq.container[2];
+         pq.container.journal().index = 2;
+         pq.container[2] = pq.container[5];
+      }
+      // exercise
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         // verify
+         assertUnit(pq.container.journal().op == 0);
+         assertUnit(pq.size() == 6);
+         assertUnit(isHeap(pq));
+         int sorted[] = {9, 8, 7, 5, 4, 3};
+         assertUnit(drainsAs(pq, sorted, 6));
+      }
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   // kill a process part way through its pushes: on reopen the heap
+   // holds exactly the items it had pushed, in heap order
+   void test_crash_killWriter()
+   {
+#ifndef _WIN32
+      // setup
+      const int numItems = 1 << 22;
+      std::string path = tempPath("killWriter");
+      std::remove(path.c_str());
+      int fds[2];
+      assertUnit(pipe(fds) == 0);
+      pid_t pid = fork();
+      if (pid == 0)
+      {
+         // the writer: every push goes all the way to the top. It
+         // says when it is well into its pushes, then keeps going
+         close(fds[0]);
+         custom::persistent_priority_queue <int> pq(path);
+         for (int i = 0; i < numItems; i++)
+         {
+            pq.push(i);
+            if (i == 1000)
+            {
+               char ready = 1;
+               if (write(fds[1], &ready, 1) != 1)
+                  _exit(1);
+            }
+         }
+         _exit(0);
+      }
+      // exercise
+      close(fds[1]);
+      char ready = 0;
+      bool isReady = read(fds[0], &ready, 1) == 1;
+      kill(pid, SIGKILL);
+      int status;
+      waitpid(pid, &status, 0);
+      close(fds[0]);
+      // verify
+      assertUnit(isReady);
+      {
+         custom::persistent_priority_queue <int> pq(path);
+         size_t numPushed = pq.size();
+         assertUnit(numPushed > 1000);
+         assertUnit(numPushed < (size_t)numItems);
+         assertUnit(isHeap(pq));
+         bool isEach = true;
+         for (int expect = (int)numPushed - 1; expect >= 0; expect--)
+         {
+            if (pq.empty() || pq.top() != expect)
+               isEach = false;
+            pq.pop();
+         }
+         assertUnit(isEach);
+         assertUnit(pq.empty());
+      }
+      // teardown
+      std::remove(path.c_str());
+#endif // !_WIN32
+   }
+
+   /***************************************************
+    * SETUP STANDARD FIXTURE
+    *    {10, 8, 9, 4, 3, 7, 5}
+    ***************************************************/
+   void setupStandardFixture(custom::persistent_priority_queue <int>& pq)
+   {
+      int values[7] = {10, 8, 9, 4, 3, 7, 5};
+      for (int value : values)
+         pq.push(value);
+   }
+
+   template <class T>
+   bool isHeap(const custom::persistent_priority_queue <T>& pq)
+   {
+      for (size_t i = 1; i < pq.container.size(); i++)
+         if (pq.container[(i - 1) / 2] < pq.container[i])
+            return false;
+      return true;
+   }
+
+   bool drainsAs(custom::persistent_priority_queue <int>& pq, const int sorted[], size_t num)
+   {
+      for (size_t i = 0; i < num; i++)
+      {
+         if (pq.empty() || pq.top() != sorted[i])
+            return false;
+         pq.pop();
+      }
+      return pq.empty();
+   }
+
+   /***************************************************
+    * TEMP PATH
+    * A file name the tests can use
+    ***************************************************/
+   std::string tempPath(const char * name)
+   {
+      std::string directory(".");
+      const char * names[] = {"TMPDIR", "TEMP", "TMP"};
+      for (const char * variable : names)
+         if (getenv(variable))
+         {
+            directory = getenv(variable);
+            break;
+         }
+      std::string path = directory + "/test_pq_" + name + ".heap";
+      std::remove(path.c_str());
+      return path;
+   }
+
+   bool isFile(const std::string & path)
+   {
+      FILE * file = fopen(path.c_str(), "rb");
+      if (!file)
+         return false;
+      fclose(file);
+      return true;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,297 @@
+/***********************************************************************
+ * Header:
+ *    TEST PRIORITY EXECUTOR
+ * Summary:
+ *    Unit tests for the work-stealing priority executor
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "priority_executor.h"
+#include "vector.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+class TestPriorityExecutor : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_workers();
+
+      // Submit
+      test_submit_future();
+      test_submit_exception();
+      test_submit_priorityOrder();
+
+      // Steal
+      test_steal_topHalf();
+      test_steal_nothing();
+
+      // Threads
+      test_threads_forkJoin();
+
+      // Shutdown
+      test_shutdown_drains();
+      test_shutdown_refuses();
+      test_shutdown_fromTask();
+
+      report("PriorityExecutor");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // at least one worker, each with an empty queue
+   void test_construct_workers()
+   {  // setup
+      // exercise
+      custom::priority_executor pool(3);
+      custom::priority_executor poolNone(0);
+      // verify
+      assertUnit(pool.size() == 3);
+      assertUnit(poolNone.size() == 1);
+      assertUnit(pool.numPending == 0);
+   }  // teardown
+
+   /***************************************
+    * SUBMIT
+    ***************************************/
+
+   // the future holds what the task returned
+   void test_submit_future()
+   {  // setup
+      custom::priority_executor pool(2);
+      // exercise
+      std::future<int> future = pool.submit(0, []() { return 6 * 7; });
+      std::future<std::string> futureText = pool.submit(5, []() { return std::string("done"); });
+      // verify
+      assertUnit(future.get() == 42);
+      assertUnit(futureText.get() == std::string("done"));
+   }  // teardown
+
+   // the future holds what the task threw
+   void test_submit_exception()
+   {  // setup
+      custom::priority_executor pool(1);
+      // exercise
+      std::future<void> future = pool.submit(0, []() { throw "std:out_of_range"; });
+      // verify
+      try
+      {
+         future.get();
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:out_of_range"));
+      }
+   }  // teardown
+
+   // one busy worker: what waits runs biggest priority first, and
+   // equal priorities in the order they came
+   void test_submit_priorityOrder()
+   {  // setup
+      custom::priority_executor pool(1);
+      std::atomic<bool> isOpen(false);
+      pool.submit(0, [&isOpen]() { while (!isOpen) std::this_thread::yield(); });
+      waitFor([&pool]() { return pool.numPending == 0; });
+      std::mutex lockOrder;
+      custom::vector <int> order;
+      int priorities[] = {2, 9, 2, 5, 0, 9};
+      // exercise
+      for (int i = 0; i < 6; i++)
+         pool.submit(priorities[i], [i, &lockOrder, &order]()
+         {
+            std::lock_guard<std::mutex> guard(lockOrder);
+            order.push_back(i);
+         });
+      isOpen = true;
+      pool.shutdown();
+      // verify
+      //   9 (#1), 9 (#5), 5 (#3), 2 (#0), 2 (#2), 0 (#4)
+      int expected[] = {1, 5, 3, 0, 2, 4};
+      assertUnit(order.size() == 6);
+      bool inOrder = order.size() == 6;
+      for (size_t i = 0; inOrder && i < 6; i++)
+         if (order[i] != expected[i])
+            inOrder = false;
+      assertUnit(inOrder);
+   }  // teardown
+
+   /***************************************
+    * STEAL
+    ***************************************/
+
+   // a thief takes the top half of its victim in one go
+   void test_steal_topHalf()
+   {  // setup
+      custom::priority_executor pool(2);
+      std::atomic<bool> isOpen(false);
+      std::atomic<int> numHeld(0);
+      for (int i = 0; i < 2; i++)
+         pool.submit(0, [&isOpen, &numHeld]()
+         {
+            numHeld++;
+            while (!isOpen) std::this_thread::yield();
+         });
+      waitFor([&numHeld]() { return numHeld == 2; });
+      {
+         std::lock_guard<std::mutex> guard(pool.workers[0].lock);
+         for (int i = 0; i < 10; i++)
+            pool.workers[0].heap.push(Task(i, 0, []() {}));
+         pool.numUnfinished += 10;
+         pool.numPending += 10;
+      }
+      Task task;
+      // exercise
+      bool isStolen = pool.steal(1, task);
+      // verify
+      //   worker 0 keeps 4..0, the thief runs 9 and keeps 8..5
+      assertUnit(isStolen);
+      assertUnit(task.priority == 9);
+      assertUnit(pool.workers[0].heap.size() == 5);
+      assertUnit(pool.workers[0].heap.top().priority == 4);
+      assertUnit(pool.workers[1].heap.size() == 4);
+      assertUnit(pool.workers[1].heap.top().priority == 8);
+      assertUnit(pool.numPending == 9);
+      // teardown
+      pool.finish();
+      isOpen = true;
+   }
+
+   // nobody has anything to steal
+   void test_steal_nothing()
+   {  // setup
+      custom::priority_executor pool(3);
+      Task task;
+      // exercise
+      bool isStolen = pool.steal(0, task);
+      // verify
+      assertUnit(!isStolen);
+      assertUnit(!task.run);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // tasks that fork tasks: every one of them runs, spread by stealing
+   void test_threads_forkJoin()
+   {  // setup
+      const int depth = 12;
+      custom::priority_executor pool(4);
+      std::atomic<int> numRun(0);
+      // exercise
+      fork(pool, numRun, depth);
+      waitFor([&numRun, depth]() { return numRun == (1 << (depth + 1)) - 1; });
+      pool.shutdown();
+      // verify
+      assertUnit(numRun == (1 << (depth + 1)) - 1);
+      assertUnit(pool.numUnfinished == 0);
+   }  // teardown
+
+   /***************************************
+    * SHUTDOWN
+    ***************************************/
+
+   // everything already submitted still runs, and what it submits too
+   void test_shutdown_drains()
+   {  // setup
+      custom::priority_executor pool(2);
+      std::atomic<int> numRun(0);
+      for (int i = 0; i < 100; i++)
+         pool.submit(i % 7, [&pool, &numRun, i]()
+         {
+            numRun++;
+            if (i % 10 == 0)
+               pool.submit(0, [&numRun]() { numRun++; });
+         });
+      // exercise
+      pool.shutdown();
+      // verify
+      assertUnit(numRun == 110);
+      assertUnit(pool.numPending == 0);
+   }  // teardown
+
+   // after shutdown, nothing new from outside
+   void test_shutdown_refuses()
+   {  // setup
+      custom::priority_executor pool(2);
+      pool.shutdown();
+      // exercise
+      try
+      {
+         pool.submit(0, []() { return 1; });
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:runtime_error"));
+      }
+      assertUnit(pool.numUnfinished == 0);
+   }  // teardown
+
+   // a task cannot wait for its own worker to stop
+   void test_shutdown_fromTask()
+   {  // setup
+      custom::priority_executor pool(2);
+      // exercise
+      std::future<std::string> future = pool.submit(0, [&pool]()
+      {
+         try
+         {
+            pool.shutdown();
+         }
+         catch (const char* s)
+         {
+            return std::string(s);
+         }
+         return std::string();
+      });
+      // verify
+      assertUnit(future.get() == std::string("std:runtime_error"));
+      assertUnit(!pool.isJoined);
+      // teardown
+      pool.shutdown();
+      assertUnit(pool.isJoined);
+   }
+
+   typedef custom::priority_executor::Task Task;
+
+   // a binary tree of tasks, depth levels below this one
+   static void fork(custom::priority_executor & pool, std::atomic<int> & numRun, int depth)
+   {
+      numRun++;
+      if (depth == 0)
+         return;
+      for (int i = 0; i < 2; i++)
+         pool.submit(depth, [&pool, &numRun, depth]() { fork(pool, numRun, depth - 1); });
+   }
+
+   // spin until another thread has got somewhere
+   template <class Condition>
+   void waitFor(Condition condition)
+   {
+      while (!condition())
+         std::this_thread::yield();
+   }
+};
+
+#endif // DEBUG
@@ -18,6 +18,24 @@
 #include "testPriorityQueue.h"  // for the priority queue unit tests
 #include "testSpy.h"            // for the spy unit tests
 #include "testVector.h"         // for the vector unit tests
+#include "testAddressablePriorityQueue.h" // for the addressable priority queue unit tests
+#include "testPairingHeap.h"    // for the pairing heap unit tests
+#include "testRadixHeap.h"      // for the radix heap unit tests
+#include "testBucketQueue.h"    // for the bucket queue unit tests
+#include "testMinMaxHeap.h"     // for the min-max heap unit tests
+#include "testExternalPriorityQueue.h" // for the external priority queue unit tests
+#include "testPersistentPriorityQueue.h" // for the persistent priority queue unit tests
+#include "testConcurrentPriorityQueue.h" // for the concurrent priority queue unit tests
+#include "testMultiQueue.h"       // for the multi queue unit tests
+#include "testSkiplistPriorityQueue.h" // for the skiplist priority queue unit tests
+#include "testFlatCombiningPriorityQueue.h" // for the flat combining priority queue unit tests
+#include "testBlockingPriorityQueue.h" // for the blocking priority queue unit tests
+#include "testPriorityExecutor.h"  // for the priority executor unit tests
+#include "testSmallVector.h"     // for the small vector unit tests
+#include "testStaticPriorityQueue.h" // for the static priority queue unit tests
+#include "testArena.h"            // for the arena allocator unit tests
+#include "testHugePageAllocator.h" // for the huge page allocator unit tests
+#include "testKeyedPriorityQueue.h" // for the keyed priority queue unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -31,6 +49,24 @@ int main()
    TestSpy().run();
    TestVector().run();
    TestPQueue().run();
+   TestAddressablePQueue().run();
+   TestPairingHeap().run();
+   TestRadixHeap().run();
+   TestBucketQueue().run();
+   TestMinMaxHeap().run();
+   TestExternalPQueue().run();
+   TestPersistentPQueue().run();
+   TestConcurrentPQueue().run();
+   TestMultiQueue().run();
+   TestSkiplistPQueue().run();
+   TestFlatCombiningPQueue().run();
+   TestBlockingPQueue().run();
+   TestPriorityExecutor().run();
+   TestSmallVector().run();
+   TestStaticPQueue().run();
+   TestArena().run();
+   TestHugePageAllocator().run();
+   TestKeyedPQueue().run();
 #endif // DEBUG
    
    return 0;
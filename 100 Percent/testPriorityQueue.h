@@ -36,9 +36,12 @@ public:
       test_constructRange_empty();
       test_constructRange_one();
       test_constructRange_staandard();
+      test_constructRange_unordered();
+      test_constructRange_spyCompares();
       test_constructMoveInit_empty();
       test_constructMoveInit_one();
       test_constructMoveInit_standard();
+      test_constructMoveInit_unordered();
       
       // Assign
       test_swap_emptyEmpty();
@@ -61,12 +64,17 @@ public:
       test_pushMove_levelOne();
       test_pushMove_levelTwo();
       test_pushMove_levelThree();
+      test_pushRange_few();
+      test_pushRange_spyCompares();
 
       // Remove
       test_pop_empty();
       test_pop_one();
       test_pop_two();
-      //test_pop_standard(); // Not sure how to fix
+      test_pop_three();
+      test_pop_standard();
+      test_tryPop_empty();
+      test_tryPop_standard();
 
       // Status
       test_size_empty();
@@ -78,6 +86,26 @@ public:
       test_percolateDown_nothing();
       test_percolateDown_oneLevel();
       test_percolateDown_twoLevels();
+      test_percolateUp_twoLevels();
+      test_push_spyMoves();
+      test_pop_spyMoves();
+      test_tryPop_spyMoves();
+      test_tryPopInto_spyMoves();
+
+      // Arity
+      test_percolateDown_arityFour();
+      test_push_arityFour();
+      test_pop_arityEight();
+
+      // Pop policy
+      test_popBottomUp_standard();
+      test_popBottomUp_spyCompares();
+
+      // Layout
+      test_layoutBlocked_navigate();
+      test_push_blocked();
+      test_pop_blockedBottomUp();
+      test_constructRange_blocked();
 
       report("PQueue");
    }
@@ -244,6 +272,52 @@ public:
       teardownStandardFixture(pq);
    }
    
+   // priority_queue({1, 2, 3, 4, 5, 6, 7})
+   void test_constructRange_unordered()
+   {  // setup
+      //  il = {1, 2, 3, 4, 5, 6, 7}
+      std::initializer_list<int> il{int(1), int(2), int(3), int(4), int(5), int(6), int(7)};
+      // exercise
+      custom::priority_queue<int> pq(il.begin(), il.end());
+      // verify
+      //  +---+---+---+---+---+---+---+
+      //  | 7 | 5 | 6 | 4 | 2 | 1 | 3 |
+      //  +---+---+---+---+---+---+---+
+      //                7
+      //          5            6
+      //       4     2      1     3
+      assertUnit(pq.container.size() == 7);
+      if (pq.container.size() == 7)
+      {
+         assertUnit(pq.container[0] == int(7));
+         assertUnit(pq.container[1] == int(5));
+         assertUnit(pq.container[2] == int(6));
+         assertUnit(pq.container[3] == int(4));
+         assertUnit(pq.container[4] == int(2));
+         assertUnit(pq.container[5] == int(1));
+         assertUnit(pq.container[6] == int(3));
+      }
+      // teardown
+      teardownStandardFixture(pq);
+   }
+
+   // building a heap takes a linear number of compares, not n log n
+   void test_constructRange_spyCompares()
+   {  // setup
+      custom::vector <Spy> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      custom::priority_queue <Spy> pq(std::move(v));
+      // verify
+      assertUnit(Spy::numLessthan() <= 2 * 1000);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(pq.container.size() == 1000);
+      if (pq.container.size() == 1000)
+         assertUnit(pq.container[0].get() == 999);
+   }  // teardown
+
    /***************************************
     * MOVE CONTAINER INITIALIZE CONSTRUCTOR
     ***************************************/
@@ -314,6 +388,31 @@ public:
       teardownStandardFixture(pq);
    }
    
+   // priority_queue(move({1, 2, 3}))
+   void test_constructMoveInit_unordered()
+   {  // setup
+      //   v = [1,2,3]
+      custom::vector <int> v{int(1), int(2), int(3)};
+      // exercise
+      custom::priority_queue <int> pq(std::move(v));
+      // verify
+      //  +---+---+---+
+      //  | 3 | 2 | 1 |
+      //  +---+---+---+
+      //                3
+      //          2            1
+      assertUnit(pq.container.size() == 3);
+      if (pq.container.size() == 3)
+      {
+         assertUnit(pq.container[0] == int(3));
+         assertUnit(pq.container[1] == int(2));
+         assertUnit(pq.container[2] == int(1));
+      }
+      assertUnit(v.size() == 0);
+      // teardown
+      teardownStandardFixture(pq);
+   }
+
    /***************************************
     * SIZE EMPTY
     ***************************************/
@@ -593,6 +692,453 @@ public:
 
 
 
+   // test percolate up on a two-level change
+   void test_percolateUp_twoLevels()
+   {  // setup
+      //    1   2   3   4   5   6   7   8   9
+      //  +---+---+---+---+---+---+---+---+---+
+      //  | 10| 8 | 9 | 4 | 3 | 7 | 11|   |   |
+      //  +---+---+---+---+---+---+---+---+---+
+      //               10
+      //         8            9
+      //      4     3      7     11
+      custom::priority_queue <int> pq;
+      setupStandardFixture(pq);
+      pq.container[7-1] = int(11);
+      // Exercise
+      bool changed = pq.percolateUp(7 /*indexHeap*/);
+      // Verify
+      //    1   2   3   4   5   6   7   8   9
+      //  +---+---+---+---+---+---+---+---+---+
+      //  | 11| 8 | 10| 4 | 3 | 7 | 9 |   |   |
+      //  +---+---+---+---+---+---+---+---+---+
+      //               11
+      //         8            10
+      //      4     3      7     9
+      assertUnit(changed == true);
+      assertUnit(pq.container.size() == 7);
+      if (pq.container.size() == 7)
+      {
+         assertUnit(pq.container[0] == int(11));
+         assertUnit(pq.container[1] == int(8));
+         assertUnit(pq.container[2] == int(10));
+         assertUnit(pq.container[3] == int(4));
+         assertUnit(pq.container[4] == int(3));
+         assertUnit(pq.container[5] == int(7));
+         assertUnit(pq.container[6] == int(9));
+      }
+      // Teardown
+      teardownStandardFixture(pq);
+   }
+
+   // push to the top: one move per level plus one to place the item
+   void test_push_spyMoves()
+   {  // setup
+      //  +---+---+---+---+---+---+---+---+---+
+      //  | 10| 8 | 9 | 4 | 3 | 7 | 5 |   |   |
+      //  +---+---+---+---+---+---+---+---+---+
+      custom::priority_queue <Spy> pq;
+      pq.container = {Spy(10), Spy(8), Spy(9), Spy(4), Spy(3), Spy(7), Spy(5)};
+      pq.container.reserve(9);
+      Spy s(11);
+      Spy::reset();
+      // exercise
+      pq.push(std::move(s));
+      // verify
+      //                11
+      //          10            9
+      //       8     3      7     5
+      //      4
+      // one into the container, three levels, one to place it
+      assertUnit(Spy::numAssignMove() <= 5);
+      assertUnit(Spy::numLessthan() <= 3);
+      assertUnit(Spy::numSwap() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(pq.container.size() == 8);
+      if (pq.container.size() == 8)
+      {
+         assertUnit(pq.container[0].get() == 11);
+         assertUnit(pq.container[1].get() == 10);
+         assertUnit(pq.container[3].get() == 8);
+         assertUnit(pq.container[7].get() == 4);
+      }
+   }  // teardown
+
+   // the top is moved out, never copied
+   void test_tryPop_spyMoves()
+   {  // setup
+      custom::priority_queue <Spy> pq;
+      pq.container = {Spy(10), Spy(8), Spy(9), Spy(4), Spy(3), Spy(7), Spy(5)};
+      Spy t;
+      Spy::reset();
+      // exercise
+      pq.try_pop(t);
+      // verify
+      assertUnit(t.get() == 10);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(pq.container.size() == 6);
+      if (pq.container.size() == 6)
+         assertUnit(pq.container[0].get() == 9);
+   }  // teardown
+
+   // the top is moved onto the back of the items, never copied
+   void test_tryPopInto_spyMoves()
+   {  // setup
+      custom::priority_queue <Spy> pq;
+      pq.container = {Spy(10), Spy(8), Spy(9), Spy(4), Spy(3), Spy(7), Spy(5)};
+      custom::vector <Spy> items;
+      items.reserve(2);
+      items.push_back(Spy(99));
+      Spy::reset();
+      // exercise
+      bool isPopped = pq.try_pop_into(items);
+      // verify
+      assertUnit(isPopped);
+      assertUnit(items.size() == 2);
+      if (items.size() == 2)
+         assertUnit(items[1].get() == 10);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(pq.container.size() == 6);
+      if (pq.container.size() == 6)
+         assertUnit(pq.container[0].get() == 9);
+   }  // teardown
+
+   // pop the top: at most one move and two compares per level
+   void test_pop_spyMoves()
+   {  // setup
+      //  +---+---+---+---+---+---+---+---+---+
+      //  | 10| 8 | 9 | 4 | 3 | 7 | 5 |   |   |
+      //  +---+---+---+---+---+---+---+---+---+
+      custom::priority_queue <Spy> pq;
+      pq.container = {Spy(10), Spy(8), Spy(9), Spy(4), Spy(3), Spy(7), Spy(5)};
+      Spy::reset();
+      // exercise
+      pq.pop();
+      // verify
+      //                9
+      //          8            7
+      //       4     3      5
+      // two levels and one to place the item
+      assertUnit(Spy::numAssignMove() <= 3);
+      assertUnit(Spy::numLessthan() <= 4);
+      assertUnit(Spy::numSwap() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(pq.container.size() == 6);
+      if (pq.container.size() == 6)
+      {
+         assertUnit(pq.container[0].get() == 9);
+         assertUnit(pq.container[1].get() == 8);
+         assertUnit(pq.container[2].get() == 7);
+         assertUnit(pq.container[5].get() == 5);
+      }
+   }  // teardown
+
+   /***************************************
+    * ARITY
+    ***************************************/
+
+   // test percolate down on a 4-ary heap
+   void test_percolateDown_arityFour()
+   {  // setup
+      //    1   2   3   4   5   6
+      //  +---+---+---+---+---+---+
+      //  | 1 | 5 | 9 | 7 | 3 | 2 |
+      //  +---+---+---+---+---+---+
+      //               1
+      //      5     9     7     3
+      //   2
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, 4> pq;
+      pq.container = {int(1), int(5), int(9), int(7), int(3), int(2)};
+      // Exercise
+      bool changed = pq.percolateDown(1 /*indexHeap*/);
+      // Verify
+      //    1   2   3   4   5   6
+      //  +---+---+---+---+---+---+
+      //  | 9 | 5 | 1 | 7 | 3 | 2 |
+      //  +---+---+---+---+---+---+
+      //               9
+      //      5     1     7     3
+      //   2
+      assertUnit(changed == true);
+      assertUnit(pq.container.size() == 6);
+      if (pq.container.size() == 6)
+      {
+         assertUnit(pq.container[0] == int(9));
+         assertUnit(pq.container[1] == int(5));
+         assertUnit(pq.container[2] == int(1));
+         assertUnit(pq.container[3] == int(7));
+         assertUnit(pq.container[4] == int(3));
+         assertUnit(pq.container[5] == int(2));
+      }
+   }  // teardown
+
+   // push 1..9 in order onto a 4-ary heap
+   void test_push_arityFour()
+   {  // setup
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, 4> pq;
+      // exercise
+      for (int i = 1; i <= 9; i++)
+         pq.push(i);
+      // verify
+      //    1   2   3   4   5   6   7   8   9
+      //  +---+---+---+---+---+---+---+---+---+
+      //  | 9 | 8 | 2 | 3 | 4 | 1 | 5 | 6 | 7 |
+      //  +---+---+---+---+---+---+---+---+---+
+      //                     9
+      //         8       2       3       4
+      //    1  5  6  7
+      assertUnit(pq.container.size() == 9);
+      if (pq.container.size() == 9)
+      {
+         assertUnit(pq.container[0] == int(9));
+         assertUnit(pq.container[1] == int(8));
+         assertUnit(pq.container[2] == int(2));
+         assertUnit(pq.container[3] == int(3));
+         assertUnit(pq.container[4] == int(4));
+         assertUnit(pq.container[5] == int(1));
+         assertUnit(pq.container[6] == int(5));
+         assertUnit(pq.container[7] == int(6));
+         assertUnit(pq.container[8] == int(7));
+      }
+   }  // teardown
+
+   // pop everything from an 8-ary heap: should come out in order
+   void test_pop_arityEight()
+   {  // setup
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, 8> pq;
+      int values[] = {13, 2, 40, 7, 7, 21, 1, 33, 5, 18, 9, 27, 3, 11};
+      for (int value : values)
+         pq.push(value);
+      int sorted[] = {40, 33, 27, 21, 18, 13, 11, 9, 7, 7, 5, 3, 2, 1};
+      // exercise
+      bool inOrder = true;
+      for (int value : sorted)
+      {
+         if (pq.empty() || pq.top() != value)
+            inOrder = false;
+         pq.pop();
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   /***************************************
+    * POP POLICY
+    ***************************************/
+
+   // bottom-up pop from the standard fixture
+   void test_popBottomUp_standard()
+   {  // setup
+      //               10
+      //         8            9
+      //      4     3      7     5
+      //  +---+---+---+---+---+---+---+---+---+
+      //  | 10| 8 | 9 | 4 | 3 | 7 | 5 |   |   |
+      //  +---+---+---+---+---+---+---+---+---+
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, 2, custom::pop_bottom_up> pq;
+      pq.container = {int(10), int(8), int(9), int(4), int(3), int(7), int(5)};
+      // exercise
+      pq.pop();
+      // verify
+      //    0   1   2   3   4   5
+      //  +---+---+---+---+---+---+---+---+---+
+      //  | 9 | 8 | 7 | 4 | 3 | 5 |   |   |   |
+      //  +---+---+---+---+---+---+---+---+---+
+      //                9
+      //          8            7
+      //       4     3      5
+      assertUnit(pq.container.size() == 6);
+      if (pq.container.size() == 6)
+      {
+         assertUnit(pq.container[0] == int(9));
+         assertUnit(pq.container[1] == int(8));
+         assertUnit(pq.container[2] == int(7));
+         assertUnit(pq.container[3] == int(4));
+         assertUnit(pq.container[4] == int(3));
+         assertUnit(pq.container[5] == int(5));
+      }
+   }  // teardown
+
+   // draining a heap bottom-up takes fewer compares than the classic way
+   void test_popBottomUp_spyCompares()
+   {  // setup
+      custom::vector <Spy> v;
+      for (int i = 0; i < 1023; i++)
+         v.push_back(Spy((i * 389) % 1023));
+      custom::priority_queue <Spy>                            pqClassic(v);
+      custom::priority_queue <Spy, custom::vector<Spy>, std::less<Spy>, 2, custom::pop_bottom_up> pqBottomUp(v);
+      // exercise
+      Spy::reset();
+      while (!pqClassic.empty())
+         pqClassic.pop();
+      int numClassic = Spy::numLessthan();
+      Spy::reset();
+      bool inOrder = true;
+      for (int expect = 1022; !pqBottomUp.empty(); expect--)
+      {
+         if (pqBottomUp.top().get() != expect)
+            inOrder = false;
+         pqBottomUp.pop();
+      }
+      int numBottomUp = Spy::numLessthan();
+      // verify
+      assertUnit(inOrder);
+      assertUnit(numBottomUp < numClassic);
+   }  // teardown
+
+   /***************************************
+    * LAYOUT
+    ***************************************/
+
+   // every node is found again from its parent, and comes after it
+   void test_layoutBlocked_navigate()
+   {  // setup
+      typedef custom::layout_blocked <3> Binary;   // 7 nodes a block
+      typedef custom::layout_blocked <2> Quad;     // 5 nodes a block
+      bool isParentFirst = true;
+      bool isChildOfParent = true;
+      // exercise
+      for (size_t index = 1; index < 5000; index++)
+      {
+         size_t parentBinary = Binary::parent<2>(index);
+         size_t parentQuad   = Quad::parent<4>(index);
+         if (!(parentBinary < index) || !(parentQuad < index))
+            isParentFirst = false;
+         size_t k = 0;
+         while (k < 2 && Binary::child<2>(parentBinary, k) != index)
+            k++;
+         if (k == 2)
+            isChildOfParent = false;
+         k = 0;
+         while (k < 4 && Quad::child<4>(parentQuad, k) != index)
+            k++;
+         if (k == 4)
+            isChildOfParent = false;
+      }
+      // verify
+      //   block 0 is 0..6, its leaves are 3..6 and the
+      //   children of leaf 6 are the roots of blocks 7 and 8
+      assertUnit(isParentFirst);
+      assertUnit(isChildOfParent);
+      assertUnit(Binary::child<2>(2, 1) == 6);
+      assertUnit(Binary::child<2>(6, 0) == 49);
+      assertUnit(Binary::child<2>(6, 1) == 56);
+      assertUnit(Binary::parent<2>(7) == 3);
+   }  // teardown
+
+   // push into a blocked heap of three node blocks
+   void test_push_blocked()
+   {  // setup
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, 2, custom::pop_classic,
+                              custom::layout_blocked<2> > pq;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 263) % 1000);
+      // verify
+      //   block 0 is 0..2, the children of 1 are 3 and 6
+      //   and of 2 are 9 and 12
+      assertUnit(pq.size() == 1000);
+      assertUnit(pq.top() == 999);
+      assertUnit(pq.indexChild(1, 1) == 6);
+      assertUnit(pq.indexChild(2, 0) == 9);
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   // drain a blocked heap with the bottom-up pop
+   void test_pop_blockedBottomUp()
+   {  // setup
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, 4, custom::pop_bottom_up,
+                              custom::layout_blocked<3> > pq;
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 389) % 1000);
+      // exercise
+      bool inOrder = true;
+      for (int expect = 999; !pq.empty(); expect--)
+      {
+         if (pq.top() != expect)
+            inOrder = false;
+         pq.pop();
+      }
+      // verify
+      assertUnit(inOrder);
+   }  // teardown
+
+   // build a blocked heap in one go
+   void test_constructRange_blocked()
+   {  // setup
+      custom::vector <int> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back((i * 751) % 1000);
+      // exercise
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, 2, custom::pop_classic,
+                              custom::layout_blocked<4> > pq(std::move(v));
+      // verify
+      assertUnit(pq.size() == 1000);
+      assertUnit(isHeap(pq));
+      bool inOrder = true;
+      for (int expect = 999; !pq.empty(); expect--)
+      {
+         if (pq.top() != expect)
+            inOrder = false;
+         pq.pop();
+      }
+      assertUnit(inOrder);
+   }  // teardown
+
+   /***************************************
+    * PUSH RANGE
+    ***************************************/
+
+   // a few into a big heap: each is pushed on its own
+   void test_pushRange_few()
+   {  // setup
+      custom::priority_queue <int> pq;
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 263) % 1000);
+      int values[] = {1500, -3, 500, 1200};
+      // exercise
+      pq.push(values, values + 4);
+      // verify
+      assertUnit(pq.size() == 1004);
+      assertUnit(pq.top() == 1500);
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   // a big batch is heapified, in a linear number of compares
+   void test_pushRange_spyCompares()
+   {  // setup
+      custom::priority_queue <Spy> pq;
+      pq.push(Spy(5000));
+      custom::vector <Spy> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back(Spy((i * 263) % 1000));
+      Spy::reset();
+      // exercise
+      pq.push(v.begin(), v.end());
+      // verify
+      assertUnit(Spy::numLessthan() <= 2 * 1001);
+      assertUnit(pq.size() == 1001);
+      assertUnit(pq.top().get() == 5000);
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   // no node is bigger than its parent
+   template <class PQ>
+   bool isHeap(const PQ & pq)
+   {
+      for (size_t index = 1; index < pq.container.size(); index++)
+         if (pq.container[PQ::indexParent(index)] < pq.container[index])
+            return false;
+      return true;
+   }
+
    /***************************************
     * TOP
     ***************************************/
@@ -756,7 +1302,43 @@ public:
       teardownStandardFixture(pq);
    }
 
-   
+   // nothing to move out, and t is left alone
+   void test_tryPop_empty()
+   {  // setup
+      custom::priority_queue <int> pq;
+      int t = 99;
+      // exercise
+      bool isPopped = pq.try_pop(t);
+      // verify
+      assertUnit(!isPopped);
+      assertUnit(t == 99);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // the top comes out and the rest is a heap again
+   void test_tryPop_standard()
+   {  // setup
+      custom::priority_queue <int> pq;
+      setupStandardFixture(pq);
+      int t = 0;
+      // exercise
+      bool isPopped = pq.try_pop(t);
+      // verify
+      //                9
+      //          8            7
+      //       4     3      5
+      assertUnit(isPopped);
+      assertUnit(t == 10);
+      assertUnit(pq.container.size() == 6);
+      if (pq.container.size() == 6)
+      {
+         assertUnit(pq.container[0] == int(9));
+         assertUnit(pq.container[1] == int(8));
+         assertUnit(pq.container[2] == int(7));
+      }
+      // teardown
+      teardownStandardFixture(pq);
+   }
 
    /***************************************
     * PUSH
@@ -0,0 +1,285 @@
+/***********************************************************************
+ * Header:
+ *    TEST RADIX HEAP
+ * Summary:
+ *    Unit tests for the radix heap
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "radix_heap.h"
+#include "priority_queue.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <string>
+
+
+class TestRadixHeap : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Access
+      test_top_empty();
+
+      // Insert
+      test_push_one();
+      test_push_buckets();
+
+      // Remove
+      test_pop_ordered();
+      test_pop_signed();
+      test_pop_interleaved();
+      test_pop_ties();
+
+      // Use
+      test_dijkstra_grid();
+
+      report("RadixHeap");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::radix_heap <unsigned int, int> rh;
+      // verify
+      assertUnit(rh.empty());
+      assertUnit(rh.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty heap
+   void test_top_empty()
+   {  // setup
+      custom::radix_heap <int, int> rh;
+      // exercise
+      try
+      {
+         rh.top();
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:out_of_range"));
+      }
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // a single item is ready at the top straight away
+   void test_push_one()
+   {  // setup
+      custom::radix_heap <unsigned int, std::string> rh;
+      // exercise
+      rh.push(40, std::string("forty"));
+      // verify
+      assertUnit(rh.size() == 1);
+      assertUnit(rh.topKey() == 40);
+      assertUnit(rh.top() == std::string("forty"));
+      assertUnit(rh.buckets[6].size() == 1);   // 101000 ^ 0
+   }  // teardown
+
+   // items go into the bucket for the highest bit that differs
+   void test_push_buckets()
+   {  // setup
+      //   last = 4 (binary 100)
+      custom::radix_heap <unsigned int, int> rh;
+      rh.push(4, 0);
+      rh.push(4, 0);
+      rh.pop();
+      // exercise
+      rh.push(4, 1);   // same        -> bucket 0
+      rh.push(5, 2);   // 100 ^ 101   -> bucket 1
+      rh.push(6, 3);   // 100 ^ 110   -> bucket 2
+      rh.push(9, 4);   // 0100 ^ 1001 -> bucket 4
+      // verify
+      assertUnit(rh.size() == 5);
+      assertUnit(rh.buckets[0].size() == 2);
+      assertUnit(rh.buckets[1].size() == 1);
+      assertUnit(rh.buckets[2].size() == 1);
+      assertUnit(rh.buckets[3].size() == 0);
+      assertUnit(rh.buckets[4].size() == 1);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // keys come out smallest first
+   void test_pop_ordered()
+   {  // setup
+      custom::radix_heap <unsigned long long, int> rh;
+      for (int i = 0; i < 500; i++)
+         rh.push((unsigned long long)((i * 263) % 500) * 1000, i);
+      // exercise
+      bool inOrder = true;
+      for (unsigned long long expect = 0; expect < 500; expect++)
+      {
+         if (rh.empty() || rh.topKey() != expect * 1000)
+            inOrder = false;
+         rh.pop();
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(rh.empty());
+   }  // teardown
+
+   // negative keys sort before positive ones
+   void test_pop_signed()
+   {  // setup
+      custom::radix_heap <int, int> rh;
+      int keys[] = {7, -3, 0, -100, 42, -1};
+      for (int key : keys)
+         rh.push(key, key * 2);
+      int sorted[] = {-100, -3, -1, 0, 7, 42};
+      // exercise
+      bool inOrder = true;
+      for (int key : sorted)
+      {
+         if (rh.empty() || rh.topKey() != key || rh.top() != key * 2)
+            inOrder = false;
+         rh.pop();
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(rh.empty());
+   }  // teardown
+
+   // pushes between pops, never below the last key popped
+   void test_pop_interleaved()
+   {  // setup
+      custom::radix_heap <unsigned int, int> rh;
+      rh.push(10, 0);
+      rh.push(20, 0);
+      // exercise
+      rh.pop();          // 10
+      rh.push(10, 1);    // equal to the last key is allowed
+      rh.push(15, 2);
+      // verify
+      assertUnit(rh.topKey() == 10);
+      assertUnit(rh.top() == 1);
+      rh.pop();
+      assertUnit(rh.topKey() == 15);
+      rh.pop();
+      assertUnit(rh.topKey() == 20);
+      rh.pop();
+      assertUnit(rh.empty());
+   }  // teardown
+
+   // equal keys: pop removes the very item top showed
+   void test_pop_ties()
+   {  // setup
+      custom::radix_heap <unsigned int, int> rh;
+      rh.push(3, 1);
+      rh.push(5, 2);
+      rh.pop();          // 3
+      rh.push(5, 3);
+      rh.push(5, 4);
+      // exercise
+      int seen = 0;
+      while (!rh.empty())
+      {
+         seen += rh.top() * rh.top();
+         rh.pop();
+      }
+      // verify
+      assertUnit(seen == 2 * 2 + 3 * 3 + 4 * 4);
+   }  // teardown
+
+   /***************************************
+    * DIJKSTRA
+    ***************************************/
+
+   // shortest paths on a weighted grid agree with priority_queue
+   void test_dijkstra_grid()
+   {  // setup
+      const int width = 20;
+      const int numNodes = width * width;
+      int weight[numNodes];
+      for (int i = 0; i < numNodes; i++)
+         weight[i] = 1 + (i * 7919) % 13;
+      int distRadix[numNodes];
+      int distHeap[numNodes];
+      // exercise
+      dijkstraRadix(weight, width, distRadix);
+      dijkstraHeap(weight, width, distHeap);
+      // verify
+      bool same = true;
+      for (int i = 0; i < numNodes; i++)
+         if (distRadix[i] != distHeap[i])
+            same = false;
+      assertUnit(same);
+      assertUnit(distRadix[0] == 0);
+   }  // teardown
+
+   void dijkstraRadix(const int weight[], int width, int dist[])
+   {
+      for (int i = 0; i < width * width; i++)
+         dist[i] = -1;
+      custom::radix_heap <unsigned int, int> rh;
+      rh.push(0, 0);
+      while (!rh.empty())
+      {
+         int d = (int)rh.topKey();
+         int node = rh.top();
+         rh.pop();
+         if (dist[node] != -1)
+            continue;
+         dist[node] = d;
+         int neighbors[4] = {node - width, node + width,
+                             node % width ? node - 1 : -1,
+                             (node + 1) % width ? node + 1 : -1};
+         for (int next : neighbors)
+            if (next >= 0 && next < width * width && dist[next] == -1)
+               rh.push((unsigned int)(d + weight[next]), next);
+      }
+   }
+
+   void dijkstraHeap(const int weight[], int width, int dist[])
+   {
+      for (int i = 0; i < width * width; i++)
+         dist[i] = -1;
+      // priority_queue is a max-heap, so store minus the distance
+      custom::priority_queue <long long> pq;
+      pq.push(0);
+      while (!pq.empty())
+      {
+         int d = (int)(-pq.top() / 1000000);
+         int node = (int)(-pq.top() % 1000000);
+         pq.pop();
+         if (dist[node] != -1)
+            continue;
+         dist[node] = d;
+         int neighbors[4] = {node - width, node + width,
+                             node % width ? node - 1 : -1,
+                             (node + 1) % width ? node + 1 : -1};
+         for (int next : neighbors)
+            if (next >= 0 && next < width * width && dist[next] == -1)
+               pq.push(-((long long)(d + weight[next]) * 1000000 + next));
+      }
+   }
+};
+
+#endif // DEBUG
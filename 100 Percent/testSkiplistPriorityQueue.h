@@ -0,0 +1,318 @@
+/***********************************************************************
+ * Header:
+ *    TEST SKIPLIST PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the lock-free skiplist priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "skiplist_priority_queue.h"
+#include "vector.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <functional>
+#include <thread>
+
+
+class TestSkiplistPQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_empty();
+
+      // Insert
+      test_push_ordered();
+      test_push_compare();
+
+      // Remove
+      test_pop_empty();
+      test_pop_ordered();
+      test_pop_batchedCleanup();
+      test_pop_reclaimed();
+
+      // Threads
+      test_threads_noneLostOrTwice();
+      test_threads_drainInOrder();
+
+      report("SkiplistPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // every level of the head goes straight to the tail
+   void test_construct_empty()
+   {  // setup
+      // exercise
+      custom::skiplist_priority_queue <int> pq;
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.boundOffset == 32);
+      bool isTail = true;
+      for (int i = 0; i < PQ::levelMax; i++)
+         if (pq.head.next[i].load() != (uintptr_t)&pq.tail)
+            isTail = false;
+      assertUnit(isTail);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // the bottom level is biggest first, and each level above skips some
+   void test_push_ordered()
+   {  // setup
+      custom::skiplist_priority_queue <int> pq;
+      // exercise
+      for (int i = 0; i < 500; i++)
+         pq.push((i * 263) % 500);
+      // verify
+      assertUnit(pq.size() == 500);
+      bool isSorted = true;
+      for (int i = 0; i < PQ::levelMax; i++)
+      {
+         int previous = 500;
+         PQ::Link * p = PQ::unmarked(pq.head.next[i].load());
+         while (p != &pq.tail)
+         {
+            if (!(PQ::dataOf(p) < previous))
+               isSorted = false;
+            previous = PQ::dataOf(p);
+            p = PQ::unmarked(p->next[i].load());
+         }
+      }
+      assertUnit(isSorted);
+      assertUnit(countLevel(pq, 0) == 500);
+      assertUnit(countLevel(pq, 1) < 500);
+      assertUnit(countLevel(pq, 1) > 0);
+   }  // teardown
+
+   // std::greater puts the smallest first
+   void test_push_compare()
+   {  // setup
+      custom::skiplist_priority_queue <int, std::greater<int>> pq;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         pq.push((i * 37) % 100);
+      // verify
+      bool inOrder = true;
+      for (int expect = 0; expect < 100; expect++)
+      {
+         int value = -1;
+         if (!pq.try_pop(value) || value != expect)
+            inOrder = false;
+      }
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // nothing to pop
+   void test_pop_empty()
+   {  // setup
+      custom::skiplist_priority_queue <int> pq;
+      int value = 99;
+      // exercise
+      bool isPopped = pq.try_pop(value);
+      // verify
+      assertUnit(!isPopped);
+      assertUnit(value == 99);
+   }  // teardown
+
+   // one thread: biggest first
+   void test_pop_ordered()
+   {  // setup
+      custom::skiplist_priority_queue <int> pq;
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 263) % 1000);
+      // exercise
+      bool inOrder = true;
+      for (int expect = 999; expect >= 0; expect--)
+      {
+         int value = -1;
+         if (!pq.try_pop(value) || value != expect)
+            inOrder = false;
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+      int value;
+      assertUnit(!pq.try_pop(value));
+   }  // teardown
+
+   // the deleted prefix is only cut once it is boundOffset long
+   void test_pop_batchedCleanup()
+   {  // setup
+      custom::skiplist_priority_queue <int> pq(4);
+      for (int i = 0; i < 100; i++)
+         pq.push(i);
+      int value;
+      // exercise
+      pq.try_pop(value);
+      pq.try_pop(value);
+      pq.try_pop(value);
+      size_t lengthBefore = lengthPrefix(pq);
+      for (int i = 0; i < 47; i++)
+         pq.try_pop(value);
+      size_t lengthAfter = lengthPrefix(pq);
+      // verify
+      //   three pops, no cut; fifty, and the prefix has been cut often
+      assertUnit(lengthBefore == 3);
+      assertUnit(lengthAfter > 0);
+      assertUnit(lengthAfter < 4);
+      assertUnit(value == 50);
+      assertUnit(countLevel(pq, 0) == 50 + lengthAfter);
+      assertUnit(pq.size() == 50);
+   }  // teardown
+
+   // popped nodes are freed as the epochs go by, not at the end
+   void test_pop_reclaimed()
+   {  // setup
+      Spy::reset();
+      {
+         custom::skiplist_priority_queue <Spy> pq(4);
+         for (int i = 0; i < 200; i++)
+            pq.push(Spy(i));
+         // exercise
+         Spy value;
+         while (pq.try_pop(value))
+            ;
+         // verify
+         assertUnit(value.get() == 0);
+         assertUnit(numLive() < 20);
+      }
+      assertUnit(numLive() == 0);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // pushes and pops at once: every item comes out exactly once
+   void test_threads_noneLostOrTwice()
+   {  // setup
+      const int numThreads = 8;
+      const int numEach = 5000;
+      custom::skiplist_priority_queue <int> pq(8);
+      custom::vector <int> seen(numThreads * numEach, 0);
+      custom::vector <int> popped[numThreads];
+      // exercise
+      std::thread threads[numThreads];
+      for (int t = 0; t < numThreads; t++)
+         threads[t] = std::thread([&pq, &popped, t, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+            {
+               pq.push(t * numEach + i);
+               int value;
+               if (i % 2 && pq.try_pop(value))
+                  popped[t].push_back(value);
+            }
+         });
+      for (int t = 0; t < numThreads; t++)
+         threads[t].join();
+      int value;
+      while (pq.try_pop(value))
+         popped[0].push_back(value);
+      // verify
+      for (int t = 0; t < numThreads; t++)
+         for (size_t i = 0; i < popped[t].size(); i++)
+            seen[popped[t][i]]++;
+      bool isOnce = true;
+      for (int i = 0; i < numThreads * numEach; i++)
+         if (seen[i] != 1)
+            isOnce = false;
+      assertUnit(isOnce);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // with nothing being pushed, each thread's pops must come out
+   // biggest first, and between them they must take everything
+   void test_threads_drainInOrder()
+   {  // setup
+      const int numThreads = 8;
+      const int numItems = 40000;
+      custom::skiplist_priority_queue <int> pq(8);
+      for (int i = 0; i < numItems; i++)
+         pq.push((int)(((long long)i * 7919) % numItems));
+      custom::vector <int> popped[numThreads];
+      // exercise
+      std::thread threads[numThreads];
+      for (int t = 0; t < numThreads; t++)
+         threads[t] = std::thread([&pq, &popped, t]()
+         {
+            int value;
+            while (pq.try_pop(value))
+               popped[t].push_back(value);
+         });
+      for (int t = 0; t < numThreads; t++)
+         threads[t].join();
+      // verify
+      bool inOrder = true;
+      size_t numPopped = 0;
+      for (int t = 0; t < numThreads; t++)
+      {
+         numPopped += popped[t].size();
+         for (size_t i = 1; i < popped[t].size(); i++)
+            if (!(popped[t][i] < popped[t][i - 1]))
+               inOrder = false;
+      }
+      assertUnit(inOrder);
+      assertUnit(numPopped == (size_t)numItems);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   typedef custom::skiplist_priority_queue <int> PQ;
+
+   // how many nodes are on a level
+   template <class T, class Compare>
+   size_t countLevel(custom::skiplist_priority_queue <T, Compare>& pq, int level)
+   {
+      size_t count = 0;
+      auto p = pq.unmarked(pq.head.next[level].load());
+      while (p != &pq.tail)
+      {
+         count++;
+         p = pq.unmarked(p->next[level].load());
+      }
+      return count;
+   }
+
+   // how many deleted nodes are still on the bottom level
+   size_t lengthPrefix(PQ& pq)
+   {
+      size_t length = 0;
+      PQ::Link * p = &pq.head;
+      while (PQ::isMarked(p->next[0].load()))
+      {
+         length++;
+         p = PQ::unmarked(p->next[0].load());
+      }
+      return length;
+   }
+
+   // how many spies are alive
+   int numLive()
+   {
+      return Spy::numDefault() + Spy::numNondefault() + Spy::numCopy() +
+             Spy::numCopyMove() - Spy::numDestructor();
+   }
+};
+
+#endif // DEBUG
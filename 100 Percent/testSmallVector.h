@@ -0,0 +1,253 @@
+/***********************************************************************
+ * Header:
+ *    TEST SMALL VECTOR
+ * Summary:
+ *    Unit tests for the small-buffer vector, alone and under a
+ *    priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "small_vector.h"
+#include "priority_queue.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <cassert>
+
+
+class TestSmallVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_inline();
+      test_constructCopy_spilled();
+      test_constructMove_inline();
+      test_constructMove_spilled();
+
+      // Insert
+      test_pushback_staysInline();
+      test_pushback_spills();
+      test_pushback_selfAtSpill();
+
+      // Assign
+      test_swap_inlineSpilled();
+
+      // Spy
+      test_spy_balanced();
+
+      // Priority queue
+      test_pqueue_inline();
+
+      report("SmallVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // empty, and the buffer is the one in the object
+   void test_construct_inline()
+   {  // setup
+      // exercise
+      custom::small_vector <int, 8> v;
+      // verify
+      assertUnit(v.empty());
+      assertUnit(v.capacity() == 8);
+      assertUnit(v.isInline());
+   }  // teardown
+
+   // a copy of a spilled vector has its own buffer
+   void test_constructCopy_spilled()
+   {  // setup
+      custom::small_vector <int, 2> v;
+      for (int i = 0; i < 5; i++)
+         v.push_back(i * 10);
+      // exercise
+      custom::small_vector <int, 2> vCopy(v);
+      // verify
+      assertUnit(vCopy.size() == 5);
+      assertUnit(!vCopy.isInline());
+      assertUnit(vCopy.data != v.data);
+      assertUnit(vCopy[0] == 0);
+      assertUnit(vCopy[4] == 40);
+      assertUnit(v.size() == 5);
+   }  // teardown
+
+   // an inline vector is moved element by element
+   void test_constructMove_inline()
+   {  // setup
+      custom::small_vector <Spy, 4> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      custom::small_vector <Spy, 4> vMove(std::move(v));
+      // verify
+      assertUnit(vMove.isInline());
+      assertUnit(vMove.size() == 2);
+      assertUnit(vMove[0].get() == 26);
+      assertUnit(vMove[1].get() == 49);
+      assertUnit(v.empty());
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   // a spilled vector gives up its pointer
+   void test_constructMove_spilled()
+   {  // setup
+      custom::small_vector <Spy, 2> v;
+      for (int i = 0; i < 5; i++)
+         v.push_back(Spy(i));
+      Spy * pData = v.data;
+      Spy::reset();
+      // exercise
+      custom::small_vector <Spy, 2> vMove(std::move(v));
+      // verify
+      assertUnit(vMove.data == pData);
+      assertUnit(vMove.size() == 5);
+      assertUnit(v.empty());
+      assertUnit(v.isInline());
+      assertUnit(v.capacity() == 2);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   /***************************************
+    * PUSH BACK
+    ***************************************/
+
+   // up to N never leaves the object
+   void test_pushback_staysInline()
+   {  // setup
+      custom::small_vector <int, 16> v;
+      // exercise
+      for (int i = 0; i < 16; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.size() == 16);
+      assertUnit(v.capacity() == 16);
+      assertUnit(v.isInline());
+      assertUnit(v[15] == 15);
+   }  // teardown
+
+   // one past N goes to the heap, at double the size
+   void test_pushback_spills()
+   {  // setup
+      custom::small_vector <int, 4> v;
+      for (int i = 0; i < 4; i++)
+         v.push_back(i);
+      // exercise
+      v.push_back(4);
+      // verify
+      assertUnit(!v.isInline());
+      assertUnit(v.capacity() == 8);
+      assertUnit(v.size() == 5);
+      bool isSame = true;
+      for (int i = 0; i < 5; i++)
+         if (v[i] != i)
+            isSame = false;
+      assertUnit(isSame);
+   }  // teardown
+
+   // pushing one of our own elements as the buffer moves
+   void test_pushback_selfAtSpill()
+   {  // setup
+      custom::small_vector <Spy, 2> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v[0].get() == 26);
+      assertUnit(v[1].get() == 49);
+      assertUnit(v[2].get() == 26);
+   }  // teardown
+
+   /***************************************
+    * SWAP
+    ***************************************/
+
+   // one inline, one on the heap
+   void test_swap_inlineSpilled()
+   {  // setup
+      custom::small_vector <int, 2> vSmall;
+      vSmall.push_back(7);
+      custom::small_vector <int, 2> vBig;
+      for (int i = 0; i < 6; i++)
+         vBig.push_back(i);
+      int * pBig = vBig.data;
+      // exercise
+      vSmall.swap(vBig);
+      // verify
+      assertUnit(vSmall.size() == 6);
+      assertUnit(vSmall.data == pBig);
+      assertUnit(vSmall[5] == 5);
+      assertUnit(vBig.size() == 1);
+      assertUnit(vBig.isInline());
+      assertUnit(vBig[0] == 7);
+   }  // teardown
+
+   /***************************************
+    * SPY
+    ***************************************/
+
+   // every element built is destroyed, and none by default
+   void test_spy_balanced()
+   {  // setup
+      Spy::reset();
+      // exercise
+      {
+         custom::small_vector <Spy, 3> v;
+         for (int i = 0; i < 20; i++)
+            v.push_back(Spy(i));
+         custom::small_vector <Spy, 3> vCopy(v);
+         v.pop_back();
+         vCopy = v;
+      }
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() + Spy::numCopy() + Spy::numCopyMove() ==
+                 Spy::numDestructor());
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // a tiny priority queue on a small_vector stays in the object
+   void test_pqueue_inline()
+   {  // setup
+      custom::priority_queue <int, custom::small_vector <int, 16> > pq;
+      int values[] = {4, 9, 1, 7, 3, 12, 0, 5, 8, 15, 2, 6, 11, 10, 14, 13};
+      // exercise
+      for (int value : values)
+         pq.push(value);
+      const char * pTop = (const char *)&pq.top();
+      bool isInline = pTop >= (const char *)&pq && pTop < (const char *)&pq + sizeof(pq);
+      bool inOrder = true;
+      for (int expect = 15; expect >= 0; expect--)
+      {
+         if (pq.top() != expect)
+            inOrder = false;
+         pq.pop();
+      }
+      // verify
+      assertUnit(isInline);
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
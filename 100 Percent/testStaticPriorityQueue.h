@@ -0,0 +1,216 @@
+/***********************************************************************
+ * Header:
+ *    TEST STATIC PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the fixed-capacity priority queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "static_priority_queue.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <functional>
+#include <string>
+
+
+class TestStaticPQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_empty();
+
+      // Insert
+      test_tryPush_full();
+      test_reserve_tooBig();
+
+      // Remove
+      test_tryPop_empty();
+      test_tryPop_ordered();
+      test_tryPop_compare();
+
+      // Spy
+      test_spy_millionNoAlloc();
+      test_spy_balanced();
+
+      report("StaticPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // nothing in it, and all the room in the object
+   void test_construct_empty()
+   {  // setup
+      // exercise
+      custom::static_priority_queue <int, 8> pq;
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(!pq.full());
+      assertUnit(pq.capacity() == 8);
+      assertUnit(sizeof(pq) >= 8 * sizeof(int));
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // full: refuse, and keep what is there
+   void test_tryPush_full()
+   {  // setup
+      custom::static_priority_queue <int, 3> pq;
+      // exercise
+      bool isFirst  = pq.try_push(5);
+      bool isSecond = pq.try_push(9);
+      bool isThird  = pq.try_push(1);
+      bool isFourth = pq.try_push(99);
+      // verify
+      assertUnit(isFirst && isSecond && isThird);
+      assertUnit(!isFourth);
+      assertUnit(pq.full());
+      assertUnit(pq.size() == 3);
+      assertUnit(pq.top() == 9);
+   }  // teardown
+
+   // the container cannot make more room than it has
+   void test_reserve_tooBig()
+   {  // setup
+      custom::static_vector <int, 4> v;
+      // exercise
+      v.reserve(4);
+      try
+      {
+         v.reserve(5);
+         // verify
+         assertUnit(false);
+      }
+      catch (const char* s)
+      {
+         assertUnit(std::string(s) == std::string("std:length_error"));
+      }
+      assertUnit(v.capacity() == 4);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // nothing to pop
+   void test_tryPop_empty()
+   {  // setup
+      custom::static_priority_queue <int, 4> pq;
+      int value = 99;
+      // exercise
+      bool isPopped = pq.try_pop(value);
+      // verify
+      assertUnit(!isPopped);
+      assertUnit(value == 99);
+   }  // teardown
+
+   // biggest first
+   void test_tryPop_ordered()
+   {  // setup
+      custom::static_priority_queue <int, 16> pq;
+      for (int i = 0; i < 16; i++)
+         pq.try_push((i * 7) % 16);
+      // exercise
+      bool inOrder = true;
+      int value;
+      for (int expect = 15; expect >= 0; expect--)
+         if (!pq.try_pop(value) || value != expect)
+            inOrder = false;
+      // verify
+      assertUnit(inOrder);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // with std::greater the smallest comes out first
+   void test_tryPop_compare()
+   {  // setup
+      custom::static_priority_queue <int, 8, std::greater<int> > pq;
+      int values[] = {4, 9, 1, 7, 3};
+      for (int value : values)
+         pq.try_push(value);
+      // exercise
+      int first = 0;
+      int second = 0;
+      pq.try_pop(first);
+      pq.try_pop(second);
+      // verify
+      assertUnit(first == 1);
+      assertUnit(second == 3);
+      assertUnit(pq.top() == 4);
+   }  // teardown
+
+   /***************************************
+    * SPY
+    ***************************************/
+
+   // a million pops and pushes: items are moved through, never copied,
+   // and nothing is allocated
+   void test_spy_millionNoAlloc()
+   {  // setup
+      const int numItems = 64;
+      custom::static_priority_queue <Spy, numItems> pq;
+      for (int i = 0; i < numItems; i++)
+         pq.try_push(Spy(i * 1000));
+      Spy item;
+      Spy::reset();
+      // exercise
+      //    the top is taken down a little and goes back in
+      unsigned int state = 1;
+      for (int i = 0; i < 500000; i++)
+      {
+         pq.try_pop(item);
+         state = state * 1103515245 + 12345;
+         item.set(item.get() - (int)(state >> 20) % 1000);
+         pq.try_push(std::move(item));
+      }
+      // verify
+      bool inOrder = true;
+      int previous = pq.top().get();
+      while (pq.try_pop(item))
+      {
+         if (previous < item.get())
+            inOrder = false;
+         previous = item.get();
+      }
+      assertUnit(inOrder);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+   }  // teardown
+
+   // every Spy built is destroyed
+   void test_spy_balanced()
+   {  // setup
+      Spy::reset();
+      // exercise
+      {
+         custom::static_priority_queue <Spy, 10> pq;
+         for (int i = 0; i < 12; i++)
+            pq.try_push(Spy(i));
+         pq.pop();
+         custom::static_priority_queue <Spy, 10> pqCopy(pq);
+      }
+      // verify
+      assertUnit(Spy::numNondefault() + Spy::numCopy() + Spy::numCopyMove() ==
+                 Spy::numDestructor());
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -13,6 +13,7 @@
 
 #include <vector>
 #include "vector.h"
+#include "spy.h"
 #include "unitTest.h"
 
 
@@ -99,6 +100,11 @@ public:
       test_reserve_fourTen();
       test_reserve_standardZero();
       test_reserve_standardTen();
+      test_pushback_spyGrowNoDefault();
+      test_pushback_spySelf();
+      test_reserve_spyNoDefault();
+      test_resize_spyDestroyTail();
+      test_reserve_plainRecords();
 
       // Remove
       test_popback_empty();
@@ -260,7 +266,7 @@ public:
          //    | 26 | 49 |    |    |
          //    +----+----+----+----+
          custom::vector<int> v;
-         v.data = new int[4];
+         v.data = v.alloc.allocate(4);
          v.data[0] = 99;
          v.data[1] = 99;
          v.numElements = 2;
@@ -319,7 +325,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];
+      vSrc.data = vSrc.alloc.allocate(4);
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -403,7 +409,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];\
+      vSrc.data = vSrc.alloc.allocate(4);\
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -626,7 +632,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -650,7 +656,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -674,7 +680,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -753,7 +759,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -787,7 +793,7 @@ public:
       //    | 26 | 49 | 67 | 89 |    |    |
       //    +----+----+----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[6];
+      v.data = v.alloc.allocate(6);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -966,7 +972,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = vDest.alloc.allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -998,7 +1004,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = vSrc.alloc.allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1105,7 +1111,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = vDest.alloc.allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1134,7 +1140,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = vSrc.alloc.allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1245,7 +1251,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = vDest.alloc.allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1284,7 +1290,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = vSrc.alloc.allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1525,7 +1531,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1592,7 +1598,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1650,7 +1656,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1680,7 +1686,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = v.alloc.allocate(3);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1749,7 +1755,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -1782,7 +1788,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = v.alloc.allocate(3);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -1815,6 +1821,110 @@ public:
       // teardown
       teardownStandardFixture(v);
    }
+
+   // growing a vector of Spies: nothing is default constructed, and
+   // each reallocation moves the old elements rather than copying
+   void test_pushback_spyGrowNoDefault()
+   {  // setup
+      custom::vector<Spy> v;
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 1024; i++)
+         v.push_back(Spy(i));
+      // verify
+      //    1024 pushed, and 1 + 2 + 4 + ... + 512 moved on growth
+      assertUnit(v.size() == 1024);
+      assertUnit(v.capacity() == 1024);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 1024);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 1024 + 1023);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numDestructor() == 1024 + 1023);
+      assertUnit(v[0].get() == 0);
+      assertUnit(v[1023].get() == 1023);
+   }  // teardown
+
+   // pushing an element of the vector itself while it grows
+   void test_pushback_spySelf()
+   {  // setup
+      custom::vector<Spy> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v.capacity() == 4);
+      assertUnit(v[0].get() == 26);
+      assertUnit(v[1].get() == 49);
+      assertUnit(v[2].get() == 26);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numCopyMove() == 2);
+   }  // teardown
+
+   // reserving room constructs nothing
+   void test_reserve_spyNoDefault()
+   {  // setup
+      custom::vector<Spy> v;
+      v.push_back(Spy(26));
+      Spy::reset();
+      // exercise
+      v.reserve(100);
+      // verify
+      assertUnit(v.capacity() == 100);
+      assertUnit(v.size() == 1);
+      assertUnit(v[0].get() == 26);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(Spy::numDestructor() == 1);
+   }  // teardown
+
+   // resize constructs only the new elements, and destroys the cut ones
+   void test_resize_spyDestroyTail()
+   {  // setup
+      custom::vector<Spy> v;
+      v.reserve(10);
+      Spy::reset();
+      // exercise
+      v.resize(6);
+      v.resize(2);
+      // verify
+      assertUnit(v.size() == 2);
+      assertUnit(v.capacity() == 10);
+      assertUnit(Spy::numDefault() == 6);
+      assertUnit(Spy::numDestructor() == 4);
+      assertUnit(Spy::numCopyMove() == 0);
+   }  // teardown
+
+   // plain records are copied as bytes when the buffer grows and shrinks
+   void test_reserve_plainRecords()
+   {  // setup
+      struct Job
+      {
+         unsigned long long id;
+         double             weight;
+         Job *              pNext;
+      };
+      custom::vector<Job> v;
+      for (unsigned long long i = 0; i < 1000; i++)
+         v.push_back(Job{ i, i * 0.5, nullptr });
+      // exercise
+      v.reserve(5000);
+      v.resize(10);
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.size() == 10);
+      assertUnit(v.capacity() == 10);
+      bool isSame = true;
+      for (unsigned long long i = 0; i < 10; i++)
+         if (v[i].id != i || v[i].weight != i * 0.5 || v[i].pNext != nullptr)
+            isSame = false;
+      assertUnit(isSame);
+   }  // teardown
    
    
    /***************************************
@@ -2022,7 +2132,7 @@ public:
       
       try
       {
-         v.data = new int[4];
+         v.data = v.alloc.allocate(4);
          v.data[0] = 26;
          v.data[1] = 49;
          v.data[2] = 67;
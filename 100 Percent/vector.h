@@ -22,8 +22,11 @@
 #pragma once
 
 #include <cassert>  // because I am paranoid
+#include <cstring>  // for std::memcpy
 #include <new>      // std::bad_alloc
-#include <memory>   // for std::allocator
+#include <memory>   // for std::allocator, std::allocator_traits
+#include <type_traits>  // for std::is_trivially_copyable
+#include <utility>  // for std::move
 
 class TestVector; // forward declaration for unit tests
 class TestStack;
@@ -35,9 +38,22 @@ namespace custom
 
 /*****************************************
  * VECTOR
- * Just like the std :: vector <T> class
+ * Just like the std :: vector <T, A> class.
+ * The buffer is raw storage from alloc: only the
+ * first numElements slots hold constructed objects,
+ * the spare capacity past them holds nothing until
+ * an element is built there in place. When T is
+ * trivially copyable its bytes are the object, so
+ * growing copies the buffer in one go.
+ *
+ * Every allocation, construction and destruction
+ * goes through A by way of std::allocator_traits,
+ * so an arena_allocator puts the whole buffer in an
+ * arena. A copy asks A what allocator it should get;
+ * a move or swap takes the allocator along with the
+ * buffer. Assignment keeps the allocator it has.
  ****************************************/
-template <typename T>
+template <typename T, typename A = std::allocator<T> >
 class vector
 {
    friend class ::TestVector; // give unit tests access to the privates
@@ -45,12 +61,15 @@ class vector
    friend class ::TestPQueue;
    friend class ::TestHash;
 public:
+
+   typedef A allocator_type;
    
    // 
    // Construct
    //
 
-   vector(): data(nullptr), numElements(0), numCapacity(0){};
+   vector(): data(nullptr), numCapacity(0), numElements(0){};
+   explicit vector(const A & a): data(nullptr), numCapacity(0), numElements(0), alloc(a) {}
    vector(size_t numElements                );
    vector(size_t numElements, const T & t   );
    vector(const std::initializer_list<T>& l );
@@ -67,7 +86,7 @@ public:
       std::swap(data, rhs.data);
       std::swap(numElements, rhs.numElements);
       std::swap(numCapacity, rhs.numCapacity);
-      
+      std::swap(alloc, rhs.alloc);
    }
    vector & operator = (const vector & rhs);
    vector& operator = (vector&& rhs);
@@ -107,12 +126,13 @@ public:
 
    void clear()
    {
+      destroy(0, numElements);
       numElements= 0;
    }
    void pop_back()
    {
       if(numElements)
-         --numElements;
+         traits::destroy(alloc, data + --numElements);
    }
    void shrink_to_fit();
 
@@ -123,16 +143,37 @@ public:
    size_t  size()          const { return numElements;}
    size_t  capacity()      const { return numCapacity;}
    bool empty()            const { return numElements ==0;}
+   A    get_allocator()    const { return alloc;}
    
    // adjust the size of the buffer
    
    // vector-specific interfaces
    
 private:
+
+   // build or tear down elements in the raw buffer
+   void destroy(size_t begin, size_t end);
+   void adopt(T * pNew, size_t newCapacity);   // move into pNew, free the old buffer
+   void relocate(T * pNew, std::true_type);    // trivially copyable: copy the bytes
+   void relocate(T * pNew, std::false_type);   // otherwise move each element
+
+   // hand the unused tail back through the allocator, if it knows how.
+   // Its trim says whether it did; if not, shrink_to_fit reallocates
+   template <class AA>
+   static auto trimTail(AA & a, T * p, size_t n, size_t numUsed, int) ->
+      decltype(a.trim(p, n, numUsed), bool())
+   {
+      return a.trim(p, n, numUsed);
+   }
+   template <class AA>
+   static bool trimTail(AA &, T *, size_t, size_t, long) { return false; }
    
-   T *  data;                 // user data, a dynamically-allocated array
+   typedef std::allocator_traits<A> traits;
+
+   T *  data;                 // user data, raw storage from alloc
    size_t  numCapacity;       // the capacity of the array
    size_t  numElements;       // the number of items currently used
+   A    alloc;                // where data comes from
 };
 
 /**************************************************
@@ -146,8 +187,8 @@ private:
  * This particular iterator is a bi-directional meaning
  * that ++ and -- both work.  Not all iterators are that way.
  *************************************************/
-template <typename T>
-class vector <T> ::iterator
+template <typename T, typename A>
+class vector <T, A> ::iterator
 {
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
@@ -158,7 +199,7 @@ public:
    iterator(): p (nullptr)                           {  }
    iterator(T* p):p(p)                       {  }
    iterator(const iterator& rhs)        { *this = rhs; }
-   iterator(size_t index, vector<T>& v) { p= v.data + index; }
+   iterator(size_t index, vector<T, A>& v) { p= v.data + index; }
    iterator& operator = (const iterator& rhs)
    {
       this->p = rhs.p;
@@ -217,8 +258,8 @@ private:
  * Default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-//template <typename T>
-//vector <T> :: vector()
+//template <typename T, typename A>
+//vector <T, A> :: vector()
 //{
 //   data = new T[10];
 //   numCapacity = 99;
@@ -230,21 +271,19 @@ private:
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num, const T & t):
-   data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector(size_t num, const T & t):
+   data(nullptr), numCapacity(0), numElements(0)
 {
    if(num > 0)
    {
        // allocate memory
-      data = new T[num];
+      data = traits::allocate(alloc, num);
       numCapacity = num;
-      numElements = num;
       
-       
-       // copy the value
-      for(size_t i = size_t(0); i < num; i++)
-         data[i] = t;
+       // copy the value into each slot
+      for(; numElements < num; numElements++)
+         traits::construct(alloc, data + numElements, t);
    }
 }
 
@@ -252,19 +291,17 @@ vector <T> :: vector(size_t num, const T & t):
  * VECTOR :: INITIALIZATION LIST constructors
  * Create a vector with an initialization list.
  ****************************************/
-template <typename T>
-vector <T> :: vector(const std::initializer_list<T> & l):
-   data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector(const std::initializer_list<T> & l):
+   data(nullptr), numCapacity(0), numElements(0)
 {
   if(l.size())
   {
-     data = new T[l.size()];
+     data = traits::allocate(alloc, l.size());
+     numCapacity = l.size();
      
-     size_t i = size_t(0);
      for (auto &item: l)
-        data[i++] = item;
-     numElements = l.size();
-     numCapacity = l.size();
+        traits::construct(alloc, data + numElements++, item);
   }
 }
 
@@ -273,19 +310,17 @@ vector <T> :: vector(const std::initializer_list<T> & l):
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num):
-      data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector(size_t num):
+      data(nullptr), numCapacity(0), numElements(0)
 {
    if(num > size_t(0))
    {
-      numElements = num;
+      data = traits::allocate(alloc, num);
       numCapacity = num;
       
-      data = new T[num];
-      
-      for(size_t i = size_t(0); i < num; i++ )
-         data[i] = T();
+      for(; numElements < num; numElements++)
+         traits::construct(alloc, data + numElements);
    }
 }
 
@@ -294,19 +329,18 @@ vector <T> :: vector(size_t num):
  * Allocate the space for numElements and
  * call the copy constructor on each element
  ****************************************/
-template <typename T>
-vector <T> :: vector (const vector & rhs):
-   data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector (const vector & rhs):
+   data(nullptr), numCapacity(0), numElements(0),
+   alloc(traits::select_on_container_copy_construction(rhs.alloc))
 {
    if(!rhs.empty())
    {
-      numElements = rhs.numElements;
+      data = traits::allocate(alloc, rhs.numElements);
       numCapacity = rhs.numElements;
       
-      data = new T[numCapacity];
-      
-      for(size_t i = size_t(0); i < numElements; i++)
-         data[i] = rhs.data[i];
+      for(; numElements < rhs.numElements; numElements++)
+         traits::construct(alloc, data + numElements, rhs.data[numElements]);
    }
 }
 
@@ -314,8 +348,9 @@ vector <T> :: vector (const vector & rhs):
  * VECTOR :: MOVE CONSTRUCTOR
  * Steal the values from the RHS and set it to zero.
  ****************************************/
-template <typename T>
-vector <T> :: vector (vector && rhs)
+template <typename T, typename A>
+vector <T, A> :: vector (vector && rhs) :
+   alloc(rhs.alloc)
 {
    data = rhs.data;
    rhs.data = nullptr;
@@ -332,13 +367,14 @@ vector <T> :: vector (vector && rhs)
  * Call the destructor for each element from 0..numElements
  * and then free the memory
  ****************************************/
-template <typename T>
-vector <T> :: ~vector()
+template <typename T, typename A>
+vector <T, A> :: ~vector()
 {
    if(numCapacity > 0)
    {
       assert(nullptr != data);
-      delete[] data;
+      destroy(0, numElements);
+      traits::deallocate(alloc, data, numCapacity);
    }
 }
 
@@ -349,96 +385,138 @@ vector <T> :: ~vector()
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: resize(size_t newElements)
+template <typename T, typename A>
+void vector <T, A> :: resize(size_t newElements)
 {
    if(newElements > numElements)
    {
       if(newElements > numCapacity)
          reserve(newElements);
       
-      for(size_t i = numElements; i  < newElements; i++)
-         data[i] = T();
+      for(; numElements < newElements; numElements++)
+         traits::construct(alloc, data + numElements);
+   }
+   else
+   {
+      destroy(newElements, numElements);
+      numElements = newElements;
    }
-   
-   numElements = newElements;
 }
 
-template <typename T>
-void vector <T> :: resize(size_t newElements, const T & t)
+template <typename T, typename A>
+void vector <T, A> :: resize(size_t newElements, const T & t)
 {
    if(newElements > numElements)
    {
       if(newElements > numCapacity)
          reserve(newElements);
       
-      for(size_t i = numElements; i  < newElements; i++)
-         data[i] = t;
+      for(; numElements < newElements; numElements++)
+         traits::construct(alloc, data + numElements, t);
+   }
+   else
+   {
+      destroy(newElements, numElements);
+      numElements = newElements;
    }
-   
-   numElements = newElements;
-   
 }
 
 /***************************************
  * VECTOR :: RESERVE
  * This method will grow the current buffer
- * to newCapacity.  It will also copy all
+ * to newCapacity.  It will also move all
  * the data from the old buffer into the new
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: reserve(size_t newCapacity)
+template <typename T, typename A>
+void vector <T, A> :: reserve(size_t newCapacity)
 {
    if(newCapacity <= numCapacity)
       return;
    
-   T* pNew = new T[newCapacity];
-   
-   for(size_t i =0; i < numElements; i++)
-      pNew[i] = std::move(data[i]) ;
-   
-   delete[] data;
-   
-   data = pNew;
-   
-   numCapacity = newCapacity;
+   adopt(traits::allocate(alloc, newCapacity), newCapacity);
 }
 
 /***************************************
  * VECTOR :: SHRINK TO FIT
- * Get rid of any extra capacity
+ * Get rid of any extra capacity. An allocator
+ * with trim() can give back the pages past the
+ * last element in place, which saves copying a
+ * giant buffer; the capacity then stays as it was
  *     INPUT  :
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: shrink_to_fit()
+template <typename T, typename A>
+void vector <T, A> :: shrink_to_fit()
 {
    if(numCapacity == numElements)
       return;
    
-   T * pNew;
+   if(numElements != 0 && trimTail(alloc, data, numCapacity, numElements, 0))
+      return;
    
-   if(numElements != 0)
-   {
-      pNew = new T[numElements];
-      
-      for(size_t i=0; i < numElements; i++)
-         pNew[i] = data[i];
-         
-   }
-   else
-      pNew = nullptr;
+   adopt(numElements != 0 ? traits::allocate(alloc, numElements) : nullptr, numElements);
+}
+
+/***************************************
+ * VECTOR :: DESTROY
+ * Call the destructor on the elements in
+ * [begin, end), leaving their slots raw
+ **************************************/
+template <typename T, typename A>
+void vector <T, A> :: destroy(size_t begin, size_t end)
+{
+   for(size_t i = begin; i < end; i++)
+      traits::destroy(alloc, data + i);
+}
+
+/***************************************
+ * VECTOR :: ADOPT
+ * Relocate the elements into a new buffer,
+ * destroy what is left of them in the old one, and
+ * free it. The new buffer may already hold an
+ * element past the end, as push_back leaves it
+ *     INPUT  : pNew the new buffer, newCapacity its size
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+void vector <T, A> :: adopt(T * pNew, size_t newCapacity)
+{
+   relocate(pNew, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
    
    if(nullptr != data)
    {
-      delete [] data;
+      destroy(0, numElements);
+      traits::deallocate(alloc, data, numCapacity);
    }
    
    data = pNew;
    
-   numCapacity = numElements;
+   numCapacity = newCapacity;
+}
+
+/***************************************
+ * VECTOR :: RELOCATE
+ * Put the elements into the new buffer. A
+ * trivially copyable element is just its bytes,
+ * so the whole run is one memcpy; anything else
+ * is move-constructed one at a time
+ *     INPUT  : pNew the new buffer
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+void vector <T, A> :: relocate(T * pNew, std::true_type)
+{
+   if(numElements != 0)
+      std::memcpy((void *)pNew, (const void *)data, numElements * sizeof(T));
+}
+
+template <typename T, typename A>
+void vector <T, A> :: relocate(T * pNew, std::false_type)
+{
+   for(size_t i = 0; i < numElements; i++)
+      traits::construct(alloc, pNew + i, std::move(data[i]));
 }
 
 
@@ -447,8 +525,8 @@ void vector <T> :: shrink_to_fit()
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: operator [] (size_t index)
+template <typename T, typename A>
+T & vector <T, A> :: operator [] (size_t index)
 {
    return data[index];
    
@@ -458,8 +536,8 @@ T & vector <T> :: operator [] (size_t index)
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: operator [] (size_t index) const
+template <typename T, typename A>
+const T & vector <T, A> :: operator [] (size_t index) const
 {
    return data[index];
 }
@@ -468,8 +546,8 @@ const T & vector <T> :: operator [] (size_t index) const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: front ()
+template <typename T, typename A>
+T & vector <T, A> :: front ()
 {
    
    return data[0];
@@ -479,8 +557,8 @@ T & vector <T> :: front ()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: front () const
+template <typename T, typename A>
+const T & vector <T, A> :: front () const
 {
    return data[0];
 }
@@ -489,8 +567,8 @@ const T & vector <T> :: front () const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: back()
+template <typename T, typename A>
+T & vector <T, A> :: back()
 {
    return data[numElements-1];
 }
@@ -499,8 +577,8 @@ T & vector <T> :: back()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: back() const
+template <typename T, typename A>
+const T & vector <T, A> :: back() const
 {
    return data[numElements-1];
 }
@@ -513,29 +591,35 @@ const T & vector <T> :: back() const
  *     INPUT  : 't' the new element to be added
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-void vector <T> :: push_back (const T & t)
+template <typename T, typename A>
+void vector <T, A> :: push_back (const T & t)
 {
-   if(numCapacity ==0)
-      reserve(1);
-   
-   else if(numElements == numCapacity)
-      reserve(numCapacity *2);
-      
-   data[numElements++] = t;
+   if(numElements == numCapacity)
+   {
+      // build the new element first: t may live in the old buffer
+      size_t newCapacity = numCapacity ? numCapacity * 2 : 1;
+      T * pNew = traits::allocate(alloc, newCapacity);
+      traits::construct(alloc, pNew + numElements, t);
+      adopt(pNew, newCapacity);
+   }
+   else
+      traits::construct(alloc, data + numElements, t);
+   numElements++;
 }
 
-template <typename T>
-void vector <T> ::push_back(T && t)
+template <typename T, typename A>
+void vector <T, A> ::push_back(T && t)
 {
-   if(numCapacity ==0)
-      reserve(1);
-   
-   else if(numElements == numCapacity)
-      reserve(numCapacity *2);
-      
-   data[numElements++] = std::move(t);
-   
+   if(numElements == numCapacity)
+   {
+      size_t newCapacity = numCapacity ? numCapacity * 2 : 1;
+      T * pNew = traits::allocate(alloc, newCapacity);
+      traits::construct(alloc, pNew + numElements, std::move(t));
+      adopt(pNew, newCapacity);
+   }
+   else
+      traits::construct(alloc, data + numElements, std::move(t));
+   numElements++;
 }
 
 /***************************************
@@ -545,34 +629,50 @@ void vector <T> ::push_back(T && t)
  *     INPUT  : rhs the vector to copy from
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-vector <T> & vector <T> :: operator = (const vector & rhs)
+template <typename T, typename A>
+vector <T, A> & vector <T, A> :: operator = (const vector & rhs)
 {
-   clear();
+   if(this == &rhs)
+      return *this;
    
-   if(rhs.size() > numElements)
+   if(rhs.size() > numCapacity)
+   {
+      clear();
       reserve(rhs.size());
+   }
    
-   for(size_t i = size_t(0); i < rhs.size(); i++)
+   // assign over the elements we have, build the rest, drop the extra
+   size_t i = size_t(0);
+   for(; i < rhs.size() && i < numElements; i++)
       data[i] = rhs.data[i];
+   for(; i < rhs.size(); i++)
+      traits::construct(alloc, data + i, rhs.data[i]);
+   destroy(rhs.size(), numElements);
    
    numElements  = rhs.numElements;
    return *this;
 }
-template <typename T>
-vector <T>& vector <T> :: operator = (vector&& rhs)
+template <typename T, typename A>
+vector <T, A>& vector <T, A> :: operator = (vector&& rhs)
 {
-   clear();
+   if(this == &rhs)
+      return *this;
    
-   if(rhs.size() > numElements)
+   if(rhs.size() > numCapacity)
+   {
+      clear();
       reserve(rhs.size());
+   }
    
-   for(size_t i = size_t(0); i < rhs.size(); i++)
+   size_t i = size_t(0);
+   for(; i < rhs.size() && i < numElements; i++)
       data[i] = std::move(rhs.data[i]);
+   for(; i < rhs.size(); i++)
+      traits::construct(alloc, data + i, std::move(rhs.data[i]));
+   destroy(rhs.size(), numElements);
    
-   numElements  = std::move(rhs.numElements);
-   rhs.numElements =0;
-   
+   numElements  = rhs.numElements;
+   rhs.clear();
 
    return *this;
 }